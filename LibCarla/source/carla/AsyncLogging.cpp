@@ -0,0 +1,456 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/AsyncLogging.h"
+
+#include "carla/Exception.h"
+#include "carla/Logging.h"
+#include "carla/NonCopyable.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace carla {
+namespace logging {
+namespace detail {
+
+  // Both are constant-initialized, so they can be used during static
+  // initialization and destruction.
+  static std::atomic<bool> ASYNC_LOGGING_ENABLED{false};
+
+  static std::atomic<int> LOG_LEVEL{LIBCARLA_LOG_LEVEL_DEBUG};
+
+  static constexpr char BinaryLogMagic[] = "CARLALOG";
+
+  static constexpr std::uint32_t BinaryLogVersion = 1u;
+
+  // ===========================================================================
+  // -- Formatting -------------------------------------------------------------
+  // ===========================================================================
+
+  static const char *GetPrefix(int level) {
+    switch (level) {
+      case LIBCARLA_LOG_LEVEL_DEBUG:    return "DEBUG:";
+      case LIBCARLA_LOG_LEVEL_INFO:     return "INFO: ";
+      case LIBCARLA_LOG_LEVEL_WARNING:  return "WARNING:";
+      case LIBCARLA_LOG_LEVEL_ERROR:    return "ERROR:";
+      case LIBCARLA_LOG_LEVEL_CRITICAL: return "CRITICAL:";
+      default:                          return nullptr;
+    }
+  }
+
+  template <typename T>
+  static bool ReadValue(const char *&data, const char *end, T &value) {
+    if (static_cast<size_t>(end - data) < sizeof(T)) {
+      return false;
+    }
+    std::memcpy(&value, data, sizeof(T));
+    data += sizeof(T);
+    return true;
+  }
+
+  template <typename T>
+  static bool FormatValue(std::ostream &out, const char *&data, const char *end) {
+    T value;
+    if (!ReadValue(data, end, value)) {
+      return false;
+    }
+    out << value;
+    return true;
+  }
+
+  static bool FormatString(std::ostream &out, const char *&data, const char *end) {
+    std::uint16_t size;
+    if (!ReadValue(data, end, size) || (static_cast<size_t>(end - data) < size)) {
+      return false;
+    }
+    out.write(data, size);
+    data += size;
+    return true;
+  }
+
+  /// Same output as the synchronous logging.
+  static void FormatRecord(std::ostream &out, const LogRecord &record) {
+    out << std::boolalpha;
+    const char *prefix = GetPrefix(record.level);
+    bool first = (prefix == nullptr);
+    if (!first) {
+      out << prefix;
+    }
+    const char *data = record.payload;
+    const char *end = record.payload + std::min<size_t>(record.size, sizeof(record.payload));
+    bool ok = true;
+    while (ok && (data < end)) {
+      if (!first) {
+        out << ' ';
+      }
+      first = false;
+      switch (static_cast<LogArgType>(*data++)) {
+        case LogArgType::Bool:   ok = FormatValue<bool>(out, data, end);          break;
+        case LogArgType::Char:   ok = FormatValue<char>(out, data, end);          break;
+        case LogArgType::Int:    ok = FormatValue<std::int64_t>(out, data, end);  break;
+        case LogArgType::UInt:   ok = FormatValue<std::uint64_t>(out, data, end); break;
+        case LogArgType::Double: ok = FormatValue<double>(out, data, end);        break;
+        case LogArgType::String: ok = FormatString(out, data, end);               break;
+        default:                 ok = false;                                      break;
+      }
+    }
+    if (record.truncated) {
+      out << " [...]";
+    }
+    out << '\n';
+  }
+
+  // ===========================================================================
+  // -- LogQueue ---------------------------------------------------------------
+  // ===========================================================================
+
+  /// Single producer, single consumer ring of log records. The producer is
+  /// the thread that owns the queue, the consumer is whoever holds the drain
+  /// lock of the logger.
+  class LogQueue : private NonCopyable {
+  public:
+
+    LogQueue(size_t size, std::uint32_t thread_id)
+      : _records(RoundUpToPowerOfTwo(size)),
+        _mask(_records.size() - 1u),
+        _thread_id(thread_id) {}
+
+    LogRecord *TryAcquire() {
+      const size_t head = _head.load(std::memory_order_relaxed);
+      if ((head - _tail.load(std::memory_order_acquire)) == _records.size()) {
+        _dropped.fetch_add(1u, std::memory_order_relaxed);
+        return nullptr;
+      }
+      LogRecord &record = _records[head & _mask];
+      record.thread_id = _thread_id;
+      return &record;
+    }
+
+    void Commit() {
+      _head.store(_head.load(std::memory_order_relaxed) + 1u, std::memory_order_release);
+    }
+
+    template <typename FunctorT>
+    void ConsumeAll(FunctorT &&functor) {
+      size_t tail = _tail.load(std::memory_order_relaxed);
+      const size_t head = _head.load(std::memory_order_acquire);
+      for (; tail != head; ++tail) {
+        functor(_records[tail & _mask]);
+      }
+      _tail.store(tail, std::memory_order_release);
+    }
+
+    size_t TakeDroppedCount() {
+      return _dropped.exchange(0u, std::memory_order_relaxed);
+    }
+
+    /// Called by the owner thread on exit, the queue is removed once empty.
+    void Close() {
+      _closed.store(true, std::memory_order_release);
+    }
+
+    bool IsClosed() const {
+      return _closed.load(std::memory_order_acquire);
+    }
+
+  private:
+
+    static size_t RoundUpToPowerOfTwo(size_t size) {
+      size_t result = 1u;
+      while (result < size) {
+        result <<= 1u;
+      }
+      return result;
+    }
+
+    std::vector<LogRecord> _records;
+
+    const size_t _mask;
+
+    const std::uint32_t _thread_id;
+
+    std::atomic<size_t> _head{0u};
+
+    std::atomic<size_t> _tail{0u};
+
+    std::atomic<size_t> _dropped{0u};
+
+    std::atomic<bool> _closed{false};
+  };
+
+  /// Queue of the calling thread, closed when the thread exits.
+  struct ThreadLogQueue {
+    ~ThreadLogQueue() {
+      if (queue != nullptr) {
+        queue->Close();
+      }
+    }
+
+    std::shared_ptr<LogQueue> queue;
+  };
+
+  static thread_local ThreadLogQueue THREAD_LOG_QUEUE;
+
+  // ===========================================================================
+  // -- AsyncLogger ------------------------------------------------------------
+  // ===========================================================================
+
+  class AsyncLogger : private NonCopyable {
+  public:
+
+    static AsyncLogger &Get() {
+      static AsyncLogger logger;
+      return logger;
+    }
+
+    ~AsyncLogger() {
+      Stop();
+    }
+
+    void Start(const AsyncLoggingOptions &options) {
+      Stop();
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (!options.binary_file.empty()) {
+        _binary_file.open(options.binary_file, std::ios::binary | std::ios::trunc);
+        if (!_binary_file) {
+          throw_exception(std::runtime_error(options.binary_file + ": cannot open file for writing"));
+        }
+        _binary_file.write(BinaryLogMagic, sizeof(BinaryLogMagic) - 1u);
+        _binary_file.write(reinterpret_cast<const char *>(&BinaryLogVersion), sizeof(BinaryLogVersion));
+      }
+      _options = options;
+      _stop = false;
+      ASYNC_LOGGING_ENABLED = true;
+      _thread = std::thread([this]() { Run(); });
+    }
+
+    void Stop() {
+      ASYNC_LOGGING_ENABLED = false;
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+      }
+      _condition.notify_one();
+      if (_thread.joinable()) {
+        _thread.join();
+      }
+      Drain();
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_binary_file.is_open()) {
+        _binary_file.close();
+      }
+    }
+
+    LogQueue *GetThreadQueue() {
+      if (THREAD_LOG_QUEUE.queue == nullptr) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        THREAD_LOG_QUEUE.queue = std::make_shared<LogQueue>(_options.queue_size, ++_thread_count);
+        _queues.push_back(THREAD_LOG_QUEUE.queue);
+      }
+      return THREAD_LOG_QUEUE.queue.get();
+    }
+
+    /// Write every pending message, sorted by time.
+    void Drain() {
+      std::lock_guard<std::mutex> drain_lock(_drain_mutex);
+      std::vector<std::shared_ptr<LogQueue>> queues;
+      bool write_to_console;
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        queues = _queues;
+        write_to_console = _options.write_to_console;
+      }
+      _records.clear();
+      size_t dropped = 0u;
+      for (auto &queue : queues) {
+        const bool closed = queue->IsClosed();
+        queue->ConsumeAll([this](const LogRecord &record) { _records.push_back(record); });
+        dropped += queue->TakeDroppedCount();
+        if (closed) {
+          std::lock_guard<std::mutex> lock(_mutex);
+          _queues.erase(std::remove(_queues.begin(), _queues.end(), queue), _queues.end());
+        }
+      }
+      _dropped += dropped;
+      if (_records.empty() && (dropped == 0u)) {
+        return;
+      }
+      std::stable_sort(_records.begin(), _records.end(), [](const LogRecord &lhs, const LogRecord &rhs) {
+        return lhs.timestamp_ns < rhs.timestamp_ns;
+      });
+      if (write_to_console) {
+        WriteToConsole(dropped);
+      }
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_binary_file.is_open()) {
+        for (const auto &record : _records) {
+          WriteBinary(_binary_file, record);
+        }
+        _binary_file.flush();
+      }
+    }
+
+    size_t GetNumberOfDroppedMessages() const {
+      return _dropped;
+    }
+
+  private:
+
+    AsyncLogger() = default;
+
+    void Run() {
+      std::unique_lock<std::mutex> lock(_mutex);
+      while (!_stop) {
+        _condition.wait_for(lock, _options.flush_interval, [this]() { return _stop; });
+        lock.unlock();
+        Drain();
+        lock.lock();
+      }
+    }
+
+    void WriteToConsole(size_t dropped) {
+      _out.str({});
+      _err.str({});
+      for (const auto &record : _records) {
+        const bool is_error = (record.level >= LIBCARLA_LOG_LEVEL_WARNING);
+        FormatRecord(is_error ? _err : _out, record);
+      }
+      if (dropped > 0u) {
+        _err << "WARNING: " << dropped << " log messages dropped, the log queue is full\n";
+      }
+      const auto out = _out.str();
+      if (!out.empty()) {
+        std::cout << out << std::flush;
+      }
+      const auto err = _err.str();
+      if (!err.empty()) {
+        std::cerr << err;
+      }
+    }
+
+    static void WriteBinary(std::ostream &out, const LogRecord &record) {
+      out.write(reinterpret_cast<const char *>(&record.timestamp_ns), sizeof(record.timestamp_ns));
+      out.write(reinterpret_cast<const char *>(&record.thread_id), sizeof(record.thread_id));
+      out.write(reinterpret_cast<const char *>(&record.size), sizeof(record.size));
+      out.write(reinterpret_cast<const char *>(&record.level), sizeof(record.level));
+      out.write(reinterpret_cast<const char *>(&record.truncated), sizeof(record.truncated));
+      out.write(record.payload, record.size);
+    }
+
+    std::mutex _mutex;
+
+    std::condition_variable _condition;
+
+    bool _stop = false;
+
+    AsyncLoggingOptions _options;
+
+    std::vector<std::shared_ptr<LogQueue>> _queues;
+
+    std::uint32_t _thread_count = 0u;
+
+    std::ofstream _binary_file;
+
+    std::thread _thread;
+
+    std::atomic<size_t> _dropped{0u};
+
+    /// Only one thread consumes the queues at a time, the following are
+    /// protected by this mutex.
+    std::mutex _drain_mutex;
+
+    std::vector<LogRecord> _records;
+
+    std::ostringstream _out;
+
+    std::ostringstream _err;
+  };
+
+  LogRecord *AcquireLogRecord() {
+    LogRecord *record = AsyncLogger::Get().GetThreadQueue()->TryAcquire();
+    if (record != nullptr) {
+      record->timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+    return record;
+  }
+
+  void CommitLogRecord() {
+    THREAD_LOG_QUEUE.queue->Commit();
+  }
+
+} // namespace detail
+
+  void StartAsyncLogging(const AsyncLoggingOptions &options) {
+    detail::AsyncLogger::Get().Start(options);
+  }
+
+  void StopAsyncLogging() {
+    detail::AsyncLogger::Get().Stop();
+  }
+
+  bool IsAsyncLoggingEnabled() {
+    return detail::ASYNC_LOGGING_ENABLED.load(std::memory_order_relaxed);
+  }
+
+  void FlushLog() {
+    if (IsAsyncLoggingEnabled()) {
+      detail::AsyncLogger::Get().Drain();
+    }
+  }
+
+  size_t GetNumberOfDroppedLogMessages() {
+    return detail::AsyncLogger::Get().GetNumberOfDroppedMessages();
+  }
+
+  void SetLogLevel(int level) {
+    detail::LOG_LEVEL = level;
+  }
+
+  int GetLogLevel() {
+    return detail::LOG_LEVEL.load(std::memory_order_relaxed);
+  }
+
+  void DecodeBinaryLog(std::istream &in, std::ostream &out) {
+    using namespace detail;
+    char magic[sizeof(BinaryLogMagic) - 1u];
+    std::uint32_t version = 0u;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char *>(&version), sizeof(version));
+    if (!in ||
+        !std::equal(magic, magic + sizeof(magic), BinaryLogMagic) ||
+        (version != BinaryLogVersion)) {
+      throw_exception(std::invalid_argument("not a LibCarla binary log"));
+    }
+    LogRecord record;
+    while (in.read(reinterpret_cast<char *>(&record.timestamp_ns), sizeof(record.timestamp_ns))) {
+      in.read(reinterpret_cast<char *>(&record.thread_id), sizeof(record.thread_id));
+      in.read(reinterpret_cast<char *>(&record.size), sizeof(record.size));
+      in.read(reinterpret_cast<char *>(&record.level), sizeof(record.level));
+      in.read(reinterpret_cast<char *>(&record.truncated), sizeof(record.truncated));
+      if (!in || (record.size > sizeof(record.payload)) || !in.read(record.payload, record.size)) {
+        throw_exception(std::invalid_argument("truncated LibCarla binary log"));
+      }
+      const auto seconds = record.timestamp_ns / 1000000000;
+      const auto nanoseconds = record.timestamp_ns % 1000000000;
+      out << '[' << seconds << '.' << std::setfill('0') << std::setw(9) << nanoseconds
+          << std::setfill(' ') << "] [thread " << record.thread_id << "] ";
+      FormatRecord(out, record);
+    }
+  }
+
+} // namespace logging
+} // namespace carla
@@ -0,0 +1,239 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+namespace carla {
+namespace logging {
+
+  // ===========================================================================
+  // -- Asynchronous logging ---------------------------------------------------
+  // ===========================================================================
+
+  struct AsyncLoggingOptions {
+    /// Number of messages each thread can have pending, rounded up to a power
+    /// of two. Only applies to the threads that log for the first time after
+    /// starting the asynchronous logging.
+    size_t queue_size = 256u;
+
+    /// How often the background thread writes the pending messages.
+    std::chrono::milliseconds flush_interval{10};
+
+    /// Write the messages to stdout and stderr, as the synchronous logging.
+    bool write_to_console = true;
+
+    /// If not empty, write the messages to this file too, in binary form. See
+    /// DecodeBinaryLog.
+    std::string binary_file;
+  };
+
+  /// Write the log messages from a background thread. From now on the log
+  /// functions only copy their arguments into a lock-free queue of the
+  /// calling thread, and a background thread formats and writes them. If the
+  /// queue of a thread is full its messages are dropped instead of blocking.
+  ///
+  /// Calling it again restarts the background thread with the new options.
+  void StartAsyncLogging(const AsyncLoggingOptions &options = AsyncLoggingOptions{});
+
+  /// Write the pending messages and go back to synchronous logging.
+  void StopAsyncLogging();
+
+  bool IsAsyncLoggingEnabled();
+
+  /// Write the pending messages now, in the calling thread.
+  void FlushLog();
+
+  /// Number of messages dropped because the queue of their thread was full.
+  size_t GetNumberOfDroppedLogMessages();
+
+  /// Messages with a level lower than @a level are discarded. This is on top
+  /// of LIBCARLA_LOG_LEVEL, messages disabled at compile time cannot be
+  /// enabled back. By default every compiled message is written.
+  void SetLogLevel(int level);
+
+  int GetLogLevel();
+
+  /// Convert a binary log file written by the asynchronous logging into
+  /// text, one message per line preceded by its timestamp and thread.
+  void DecodeBinaryLog(std::istream &in, std::ostream &out);
+
+namespace detail {
+
+  /// Level of the messages of logging::log, that have no prefix and are
+  /// never discarded.
+  constexpr int NoLogLevel = 0;
+
+  /// A log message as stored in the queues, the arguments are kept as
+  /// tagged binary values and formatted later by the background thread.
+  struct LogRecord {
+    std::int64_t timestamp_ns;
+    std::uint32_t thread_id;
+    std::uint16_t size;
+    std::uint8_t level;
+    std::uint8_t truncated;
+    char payload[240u];
+  };
+
+  static_assert(sizeof(LogRecord) == 256u, "Unexpected log record size");
+
+  enum class LogArgType : std::uint8_t {
+    Bool,
+    Char,
+    Int,
+    UInt,
+    Double,
+    String
+  };
+
+  /// Encodes the arguments of a log message into a LogRecord. Arithmetic
+  /// types and strings are copied as they are, any other type is formatted
+  /// right away with its operator<<. Arguments that do not fit are dropped
+  /// and the record is marked as truncated.
+  class LogRecordWriter {
+  public:
+
+    explicit LogRecordWriter(LogRecord &record) : _record(record) {
+      _record.size = 0u;
+      _record.truncated = 0u;
+    }
+
+    void Write(bool value) {
+      Put(LogArgType::Bool, &value, sizeof(value));
+    }
+
+    void Write(char value) {
+      Put(LogArgType::Char, &value, sizeof(value));
+    }
+
+    void Write(signed char value) {
+      Write(static_cast<char>(value));
+    }
+
+    void Write(unsigned char value) {
+      Write(static_cast<char>(value));
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_integral<T>::value && std::is_signed<T>::value>
+    Write(T value) {
+      const std::int64_t data = value;
+      Put(LogArgType::Int, &data, sizeof(data));
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_integral<T>::value && !std::is_signed<T>::value>
+    Write(T value) {
+      const std::uint64_t data = value;
+      Put(LogArgType::UInt, &data, sizeof(data));
+    }
+
+    template <typename T>
+    std::enable_if_t<std::is_floating_point<T>::value>
+    Write(T value) {
+      const double data = static_cast<double>(value);
+      Put(LogArgType::Double, &data, sizeof(data));
+    }
+
+    void Write(const char *value) {
+      value = (value != nullptr) ? value : "(null)";
+      PutString(value, std::strlen(value));
+    }
+
+    void Write(const std::string &value) {
+      PutString(value.data(), value.size());
+    }
+
+    template <typename T>
+    std::enable_if_t<
+        !std::is_arithmetic<T>::value &&
+        !std::is_convertible<const T &, const char *>::value &&
+        !std::is_same<T, std::string>::value>
+    Write(const T &value) {
+      std::ostringstream out;
+      out << std::boolalpha << value;
+      Write(out.str());
+    }
+
+    template <typename ... Args>
+    void WriteAll(const Args & ... args) {
+      using expander = int[];
+      (void) expander{0, (Write(args), 0) ...};
+    }
+
+  private:
+
+    size_t Available() const {
+      return _record.truncated ? 0u : sizeof(_record.payload) - _record.size;
+    }
+
+    void Put(LogArgType type, const void *data, size_t size) {
+      if (Available() < 1u + size) {
+        _record.truncated = 1u;
+        return;
+      }
+      char *out = _record.payload + _record.size;
+      *out = static_cast<char>(type);
+      std::memcpy(out + 1u, data, size);
+      _record.size = static_cast<std::uint16_t>(_record.size + 1u + size);
+    }
+
+    void PutString(const char *data, size_t length) {
+      constexpr size_t header = 1u + sizeof(std::uint16_t);
+      const size_t available = Available();
+      if (available <= header) {
+        _record.truncated = 1u;
+        return;
+      }
+      const bool fits = length <= available - header;
+      const auto size = static_cast<std::uint16_t>(fits ? length : available - header);
+      char *out = _record.payload + _record.size;
+      *out = static_cast<char>(LogArgType::String);
+      std::memcpy(out + 1u, &size, sizeof(size));
+      std::memcpy(out + header, data, size);
+      _record.size = static_cast<std::uint16_t>(_record.size + header + size);
+      if (!fits) {
+        _record.truncated = 1u;
+      }
+    }
+
+    LogRecord &_record;
+  };
+
+  /// Slot of the queue of the calling thread for a new message, with its
+  /// timestamp and thread already set, or nullptr if the queue is full.
+  LogRecord *AcquireLogRecord();
+
+  /// Publish the record returned by the last AcquireLogRecord.
+  void CommitLogRecord();
+
+  /// Queue a message for the background thread. Returns false if the
+  /// asynchronous logging is not enabled and the message must be written
+  /// synchronously.
+  template <typename ... Args>
+  static inline bool PushLogRecord(int level, const Args & ... args) {
+    if (!IsAsyncLoggingEnabled()) {
+      return false;
+    }
+    LogRecord *record = AcquireLogRecord();
+    if (record != nullptr) {
+      record->level = static_cast<std::uint8_t>(level);
+      LogRecordWriter(*record).WriteAll(args ...);
+      CommitLogRecord();
+    }
+    return true;
+  }
+
+} // namespace detail
+} // namespace logging
+} // namespace carla
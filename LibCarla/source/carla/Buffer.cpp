@@ -4,6 +4,10 @@
 
 namespace carla {
 
+  constexpr size_t BufferPool::MinClassCapacity;
+
+  constexpr size_t BufferPool::NumberOfSizeClasses;
+
   void Buffer::ReuseThisBuffer() {
     auto pool = _parent_pool.lock();
     if (pool != nullptr) {
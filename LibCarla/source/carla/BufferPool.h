@@ -17,44 +17,218 @@
 #  pragma clang diagnostic pop
 #endif
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <vector>
 
 namespace carla {
 
   /// A pool of Buffer. Buffers popped from this pool automatically return to
   /// the pool on destruction so the allocated memory can be reused.
   ///
+  /// Returned buffers are kept in size classes by capacity, powers of two
+  /// from MinClassCapacity up. Popping with a size hint only reuses buffers
+  /// of the class of the hint or the next one, so small messages do not keep
+  /// big buffers busy and big messages do not reallocate small buffers.
+  /// Popping without hint takes a buffer from the smallest class that has
+  /// one. A buffer returned while the pool retains more than the maximum
+  /// retained bytes is deleted instead, and Trim releases retained memory on
+  /// demand.
+  ///
   /// @warning Buffers adjust their size only by growing, they never shrink
-  /// unless explicitly cleared. The allocated memory is only deleted when this
-  /// pool is destroyed.
+  /// unless explicitly cleared.
   class BufferPool : public std::enable_shared_from_this<BufferPool> {
   public:
 
+    /// Buffers of less capacity are kept in the first size class.
+    static constexpr size_t MinClassCapacity = 1024u;
+
+    /// From 1 KB to 4 GB, the maximum size of a Buffer.
+    static constexpr size_t NumberOfSizeClasses = 23u;
+
+    /// Counters of a size class. Pops with a size hint are counted in the
+    /// class of the hint; pops without hint in the class of the buffer
+    /// returned, or in the first class if there was none.
+    struct SizeClassStats {
+      /// Minimum capacity of the buffers of the class, zero for the first.
+      size_t min_capacity = 0u;
+      /// Pops that reused a retained buffer.
+      uint64_t hits = 0u;
+      /// Pops that returned a new buffer.
+      uint64_t misses = 0u;
+      /// Buffers deleted by the retained bytes limit or by Trim.
+      uint64_t trimmed = 0u;
+      size_t retained_buffers = 0u;
+      size_t retained_bytes = 0u;
+    };
+
     BufferPool() = default;
 
-    explicit BufferPool(size_t estimated_size) : _queue(estimated_size) {}
+    /// Preallocate room for @a estimated_size buffers in the size class of
+    /// @a buffer_size, the other classes grow on demand.
+    explicit BufferPool(size_t estimated_size, size_t buffer_size = 0u) {
+      _classes[GetSizeClass(buffer_size)].queue =
+          moodycamel::ConcurrentQueue<Buffer>(estimated_size);
+    }
 
     /// Pop a Buffer from the queue, creates a new one if the queue is empty.
+    /// Without size hint the buffer returned comes from the smallest size
+    /// class that has one, so callers that do not know the size do not keep
+    /// the big buffers busy.
     Buffer Pop() {
       Buffer item;
-      _queue.try_dequeue(item); // we don't care if it fails.
+      for (auto &size_class : _classes) {
+        if (TryPop(size_class, item)) {
+          ++size_class.hits;
+          return Adopt(std::move(item));
+        }
+      }
+      ++_classes[0u].misses;
+      return Adopt(std::move(item));
+    }
+
+    /// Pop a Buffer that can hold @a size bytes without allocating, from the
+    /// size class of @a size or the next one. If there is none, returns an
+    /// empty Buffer with the capacity of @a size rounded up to a size class,
+    /// so once returned it fits any request of its class.
+    Buffer Pop(size_t size) {
+      Buffer item;
+      const size_t first = GetSizeClass(size);
+      const size_t last = (first + 2u < NumberOfSizeClasses) ? first + 2u : NumberOfSizeClasses;
+      for (auto index = first; index < last; ++index) {
+        if (TryPop(_classes[index], item)) {
+          if (item.capacity() >= size) {
+            ++_classes[first].hits;
+            return Adopt(std::move(item));
+          }
+          // Too small, give it back and try the next class.
+          Push(std::move(item));
+        }
+      }
+      ++_classes[first].misses;
+      item.reset(static_cast<Buffer::size_type>(GetClassCapacity(size)));
+      item.reset(Buffer::size_type(0u));
+      return Adopt(std::move(item));
+    }
+
+    size_t GetMaxRetainedBytes() const {
+      return _max_retained_bytes;
+    }
+
+    /// Limit the memory retained by the pool. Only applies to the buffers
+    /// returned from now on, use Trim to release the memory already retained.
+    void SetMaxRetainedBytes(size_t bytes) {
+      _max_retained_bytes = bytes;
+    }
+
+    size_t GetRetainedBytes() const {
+      return _retained_bytes;
+    }
+
+    /// Delete retained buffers, the biggest first, until the pool retains at
+    /// most @a max_bytes.
+    void Trim(size_t max_bytes = 0u) {
+      Buffer item;
+      for (auto index = NumberOfSizeClasses; index > 0u; --index) {
+        auto &size_class = _classes[index - 1u];
+        while ((_retained_bytes > max_bytes) && TryPop(size_class, item)) {
+          ++size_class.trimmed;
+          item.clear();
+        }
+      }
+    }
+
+    std::vector<SizeClassStats> GetStats() const {
+      std::vector<SizeClassStats> result(NumberOfSizeClasses);
+      for (auto i = 0u; i < NumberOfSizeClasses; ++i) {
+        const auto &size_class = _classes[i];
+        auto &stats = result[i];
+        stats.min_capacity = i == 0u ? 0u : (MinClassCapacity << i);
+        stats.hits = size_class.hits;
+        stats.misses = size_class.misses;
+        stats.trimmed = size_class.trimmed;
+        stats.retained_buffers = size_class.retained_buffers;
+        stats.retained_bytes = size_class.retained_bytes;
+      }
+      return result;
+    }
+
+    /// Size class of a buffer of @a capacity bytes, or of a request of
+    /// @a capacity bytes.
+    static size_t GetSizeClass(size_t capacity) {
+      size_t index = 0u;
+      while ((index + 1u < NumberOfSizeClasses) && ((MinClassCapacity << (index + 1u)) <= capacity)) {
+        ++index;
+      }
+      return index;
+    }
+
+    /// Capacity allocated for a request of @a size bytes, the next power of
+    /// two, at least MinClassCapacity and at most Buffer::max_size().
+    static size_t GetClassCapacity(size_t size) {
+      size_t capacity = MinClassCapacity;
+      while ((capacity < size) && (capacity <= Buffer::max_size() / 2u)) {
+        capacity <<= 1u;
+      }
+      return capacity < size ? Buffer::max_size() : capacity;
+    }
+
+  private:
+
+    friend class Buffer;
+
+    struct SizeClass {
+      moodycamel::ConcurrentQueue<Buffer> queue{0u};
+      std::atomic<uint64_t> hits{0u};
+      std::atomic<uint64_t> misses{0u};
+      std::atomic<uint64_t> trimmed{0u};
+      std::atomic_size_t retained_buffers{0u};
+      std::atomic_size_t retained_bytes{0u};
+    };
+
+    Buffer Adopt(Buffer &&item) {
 #if __cplusplus >= 201703L // C++17
       item._parent_pool = weak_from_this();
 #else
       item._parent_pool = shared_from_this();
 #endif
-      return item;
+      return std::move(item);
     }
 
-  private:
-
-    friend class Buffer;
+    bool TryPop(SizeClass &size_class, Buffer &item) {
+      if (!size_class.queue.try_dequeue(item)) {
+        return false;
+      }
+      const size_t capacity = item.capacity();
+      --size_class.retained_buffers;
+      size_class.retained_bytes -= capacity;
+      _retained_bytes -= capacity;
+      return true;
+    }
 
     void Push(Buffer &&buffer) {
-      _queue.enqueue(std::move(buffer));
+      const size_t capacity = buffer.capacity();
+      auto &size_class = _classes[GetSizeClass(capacity)];
+      // Reserve the bytes first so concurrent pushes cannot exceed the limit.
+      if (_retained_bytes.fetch_add(capacity) + capacity > _max_retained_bytes) {
+        _retained_bytes -= capacity;
+        ++size_class.trimmed;
+        buffer.clear();
+        return;
+      }
+      size_class.retained_bytes += capacity;
+      ++size_class.retained_buffers;
+      size_class.queue.enqueue(std::move(buffer));
     }
 
-    moodycamel::ConcurrentQueue<Buffer> _queue;
+    std::array<SizeClass, NumberOfSizeClasses> _classes;
+
+    std::atomic_size_t _retained_bytes{0u};
+
+    std::atomic_size_t _max_retained_bytes{std::numeric_limits<size_t>::max()};
   };
 
 } // namespace carla
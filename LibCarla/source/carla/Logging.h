@@ -35,11 +35,17 @@
 //
 //  * LOG_DEBUG_ONLY(/* code here */)
 //  * LOG_INFO_ONLY(/* code here */)
+//
+// The level can be raised at runtime with logging::SetLogLevel, and the
+// messages can be written from a background thread with
+// logging::StartAsyncLogging, see AsyncLogging.h.
 
 // =============================================================================
 // -- Implementation of log functions ------------------------------------------
 // =============================================================================
 
+#include "carla/AsyncLogging.h"
+
 #include <iostream>
 
 namespace carla {
@@ -57,16 +63,28 @@ namespace logging {
 
   template <typename ... Args>
   static inline void log(Args && ... args) {
-    logging::write_to_stream(std::cout, std::forward<Args>(args) ..., '\n');
+    if (!detail::PushLogRecord(detail::NoLogLevel, args ...)) {
+      logging::write_to_stream(std::cout, std::forward<Args>(args) ..., '\n');
+    }
+  }
+
+namespace detail {
+
+  template <typename ... Args>
+  static inline void write(int level, std::ostream &out, const char *prefix, Args && ... args) {
+    if ((level >= GetLogLevel()) && !PushLogRecord(level, args ...)) {
+      logging::write_to_stream(out, prefix, std::forward<Args>(args) ..., '\n');
+    }
   }
 
+} // namespace detail
 } // namespace logging
 
 #if LIBCARLA_LOG_LEVEL <= LIBCARLA_LOG_LEVEL_DEBUG
 
   template <typename ... Args>
   static inline void log_debug(Args && ... args) {
-    logging::write_to_stream(std::cout, "DEBUG:", std::forward<Args>(args) ..., '\n');
+    logging::detail::write(LIBCARLA_LOG_LEVEL_DEBUG, std::cout, "DEBUG:", std::forward<Args>(args) ...);
   }
 
 #else
@@ -80,7 +98,7 @@ namespace logging {
 
   template <typename ... Args>
   static inline void log_info(Args && ... args) {
-    logging::write_to_stream(std::cout, "INFO: ", std::forward<Args>(args) ..., '\n');
+    logging::detail::write(LIBCARLA_LOG_LEVEL_INFO, std::cout, "INFO: ", std::forward<Args>(args) ...);
   }
 
 #else
@@ -94,7 +112,7 @@ namespace logging {
 
   template <typename ... Args>
   static inline void log_warning(Args && ... args) {
-    logging::write_to_stream(std::cerr, "WARNING:", std::forward<Args>(args) ..., '\n');
+    logging::detail::write(LIBCARLA_LOG_LEVEL_WARNING, std::cerr, "WARNING:", std::forward<Args>(args) ...);
   }
 
 #else
@@ -108,7 +126,7 @@ namespace logging {
 
   template <typename ... Args>
   static inline void log_error(Args && ... args) {
-    logging::write_to_stream(std::cerr, "ERROR:", std::forward<Args>(args) ..., '\n');
+    logging::detail::write(LIBCARLA_LOG_LEVEL_ERROR, std::cerr, "ERROR:", std::forward<Args>(args) ...);
   }
 
 #else
@@ -122,7 +140,7 @@ namespace logging {
 
   template <typename ... Args>
   static inline void log_critical(Args && ... args) {
-    logging::write_to_stream(std::cerr, "CRITICAL:", std::forward<Args>(args) ..., '\n');
+    logging::detail::write(LIBCARLA_LOG_LEVEL_CRITICAL, std::cerr, "CRITICAL:", std::forward<Args>(args) ...);
   }
 
 #else
@@ -10,6 +10,9 @@
 
 #include <rpc/msgpack.hpp>
 
+#include <algorithm>
+#include <cstring>
+
 namespace carla {
 
   class MsgPack {
@@ -23,6 +26,17 @@ namespace carla {
       return Buffer(reinterpret_cast<const unsigned char *>(sbuf.data()), sbuf.size());
     }
 
+    /// Pack @a obj into @a buffer, reusing its memory. Use it with buffers
+    /// popped from a BufferPool to avoid allocating memory for each message.
+    template <typename T>
+    static Buffer Pack(const T &obj, Buffer &&buffer) {
+      namespace mp = ::clmdep_msgpack;
+      BufferWriter writer(buffer);
+      mp::pack(writer, obj);
+      writer.Finish();
+      return std::move(buffer);
+    }
+
     template <typename T>
     static T UnPack(const Buffer &buffer) {
       namespace mp = ::clmdep_msgpack;
@@ -34,6 +48,37 @@ namespace carla {
       namespace mp = ::clmdep_msgpack;
       return mp::unpack(reinterpret_cast<const char *>(data), size).template as<T>();
     }
+
+  private:
+
+    /// Output stream of the msgpack packer writing into a Buffer. The whole
+    /// capacity of the buffer is used, growing it only if it is not enough.
+    class BufferWriter {
+    public:
+
+      explicit BufferWriter(Buffer &buffer) : _buffer(buffer) {
+        _buffer.reset(_buffer.capacity());
+      }
+
+      void write(const char *data, size_t size) {
+        const uint64_t required = _size + size;
+        if (required > _buffer.size()) {
+          _buffer.resize(std::max<uint64_t>(required, 2u * _buffer.size()));
+        }
+        std::memcpy(_buffer.data() + _size, data, size);
+        _size = required;
+      }
+
+      void Finish() {
+        _buffer.resize(_size);
+      }
+
+    private:
+
+      Buffer &_buffer;
+
+      uint64_t _size = 0u;
+    };
   };
 
 } // namespace carla
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "carla/client/RpcBatch.h"
 #include "carla/client/detail/Simulator.h"
 #include "carla/client/World.h"
 #include "carla/PythonUtil.h"
@@ -137,6 +138,18 @@ namespace client {
       _simulator->SetReplayerIgnoreHero(ignore_hero);
     }
 
+    /// Metrics of the sensor streams received by this process.
+    std::vector<streaming::StreamMetrics> GetStreamingMetrics() const {
+      return _simulator->GetStreamingMetrics();
+    }
+
+    /// Serve the streaming metrics in the Prometheus text format on @a port
+    /// of the loopback interface, or on a free port if @a port is 0. Returns
+    /// the port.
+    uint16_t ServeStreamingMetrics(uint16_t port = 0u) const {
+      return _simulator->ServeStreamingMetrics(port);
+    }
+
     void ApplyBatch(
         std::vector<rpc::Command> commands,
         bool do_tick_cue = false) const {
@@ -153,6 +166,11 @@ namespace client {
       return responses;
     }
 
+    /// Create an empty batch of calls to be sent in a single round-trip.
+    SharedPtr<RpcBatch> MakeRpcBatch() const {
+      return MakeShared<RpcBatch>(_simulator);
+    }
+
   private:
 
     std::shared_ptr<detail::Simulator> _simulator;
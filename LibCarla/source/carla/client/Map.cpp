@@ -13,6 +13,7 @@
 #include "carla/road/RoadTypes.h"
 #include "carla/trafficmanager/InMemoryMap.h"
 
+#include <fstream>
 #include <sstream>
 
 namespace carla {
@@ -188,5 +189,58 @@ namespace client {
     traffic_manager::InMemoryMap::Cook(shared_from_this(), path);
   }
 
+  std::shared_ptr<const road::RoutingGraph> Map::GetRoutingGraph(
+      road::RoutingGraph::Metric metric) const {
+    // critical section, the graph is built only once per metric.
+    std::lock_guard<std::mutex> lock(_routing_mutex);
+    auto &graph = _routing_graphs[static_cast<size_t>(metric)];
+    if (graph == nullptr) {
+      graph = std::make_shared<const road::RoutingGraph>(_map, metric);
+    }
+    return graph;
+  }
+
+  std::vector<SharedPtr<Waypoint>> Map::ComputeRoute(
+      const Waypoint &origin,
+      const Waypoint &destination,
+      road::RoutingGraph::Metric metric) const {
+    const road::element::Waypoint from{
+        origin.GetRoadId(), origin.GetSectionId(), origin.GetLaneId(), origin.GetDistance()};
+    const road::element::Waypoint to{
+        destination.GetRoadId(), destination.GetSectionId(), destination.GetLaneId(), destination.GetDistance()};
+    const auto route = GetRoutingGraph(metric)->ComputeRoute(from, to);
+    std::vector<SharedPtr<Waypoint>> result;
+    if (route.has_value()) {
+      result.reserve(route->waypoints.size());
+      for (auto &&waypoint : route->waypoints) {
+        result.emplace_back(SharedPtr<Waypoint>(new Waypoint{shared_from_this(), waypoint}));
+      }
+    }
+    return result;
+  }
+
+  void Map::SaveRoutingGraph(const std::string &path, road::RoutingGraph::Metric metric) const {
+    const auto graph = GetRoutingGraph(metric);
+    std::ofstream out(path, std::ios::binary);
+    if (!out.good()) {
+      throw_exception(std::runtime_error("failed to open " + path));
+    }
+    graph->Save(out);
+  }
+
+  bool Map::LoadRoutingGraph(const std::string &path) const {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.good()) {
+      throw_exception(std::runtime_error("failed to open " + path));
+    }
+    auto graph = std::make_shared<const road::RoutingGraph>(road::RoutingGraph::Load(in));
+    if (!graph->IsCompatible(_map)) {
+      return false;
+    }
+    std::lock_guard<std::mutex> lock(_routing_mutex);
+    _routing_graphs[static_cast<size_t>(graph->GetMetric())] = std::move(graph);
+    return true;
+  }
+
 } // namespace client
 } // namespace carla
@@ -12,9 +12,12 @@
 #include "carla/road/Lane.h"
 #include "carla/road/Map.h"
 #include "carla/road/RoadTypes.h"
+#include "carla/road/RoutingGraph.h"
 #include "carla/rpc/MapInfo.h"
 #include "Landmark.h"
 
+#include <array>
+#include <mutex>
 #include <string>
 
 namespace carla {
@@ -97,13 +100,34 @@ namespace client {
     /// Cooks InMemoryMap used by the traffic manager
     void CookInMemoryMap(const std::string& path) const;
 
+    /// Returns the waypoints of the route with the lowest cost between
+    /// @a origin and @a destination, empty if there is no route. The routing
+    /// graph of each metric is built on first use.
+    std::vector<SharedPtr<Waypoint>> ComputeRoute(
+        const Waypoint &origin,
+        const Waypoint &destination,
+        road::RoutingGraph::Metric metric = road::RoutingGraph::Metric::Distance) const;
+
+    /// Saves the routing graph of @a metric to disk, building it if needed.
+    void SaveRoutingGraph(const std::string &path, road::RoutingGraph::Metric metric) const;
+
+    /// Loads a routing graph saved with SaveRoutingGraph, returns false if it
+    /// was built for a different map.
+    bool LoadRoutingGraph(const std::string &path) const;
+
   private:
 
+    std::shared_ptr<const road::RoutingGraph> GetRoutingGraph(road::RoutingGraph::Metric metric) const;
+
     std::string open_drive_file;
 
     const rpc::MapInfo _description;
 
     const road::Map _map;
+
+    mutable std::mutex _routing_mutex;
+
+    mutable std::array<std::shared_ptr<const road::RoutingGraph>, 2u> _routing_graphs;
   };
 
 } // namespace client
@@ -0,0 +1,86 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/client/RpcBatch.h"
+
+#include "carla/client/detail/Simulator.h"
+
+#include <exception>
+#include <stdexcept>
+
+namespace carla {
+namespace client {
+
+  RpcBatch::RpcBatch(std::shared_ptr<detail::Simulator> simulator)
+    : _simulator(std::move(simulator)) {
+    DEBUG_ASSERT(_simulator != nullptr);
+  }
+
+  void RpcBatch::Send() {
+    _simulator->SendMultiCall(_batch);
+  }
+
+  void RpcBatch::Discard() {
+    _batch.SetException(std::make_exception_ptr(
+        std::runtime_error("rpc batch discarded")));
+  }
+
+  std::future<rpc::VehiclePhysicsControl> RpcBatch::GetVehiclePhysicsControl(
+      rpc::ActorId vehicle) {
+    return _batch.Add<rpc::VehiclePhysicsControl>("get_physics_control", vehicle);
+  }
+
+  std::future<rpc::VehicleLightState> RpcBatch::GetVehicleLightState(
+      rpc::ActorId vehicle) {
+    return _batch.Add<rpc::VehicleLightState>("get_vehicle_light_state", vehicle);
+  }
+
+  std::future<void> RpcBatch::ApplyPhysicsControl(
+      rpc::ActorId vehicle,
+      const rpc::VehiclePhysicsControl &physics_control) {
+    return _batch.Add<void>("apply_physics_control", vehicle, physics_control);
+  }
+
+  std::future<void> RpcBatch::SetVehicleLightState(
+      rpc::ActorId vehicle,
+      const rpc::VehicleLightState &light_state) {
+    return _batch.Add<void>("set_vehicle_light_state", vehicle, light_state);
+  }
+
+  std::future<void> RpcBatch::SetActorLocation(
+      rpc::ActorId actor,
+      const geom::Location &location) {
+    return _batch.Add<void>("set_actor_location", actor, location);
+  }
+
+  std::future<void> RpcBatch::SetActorTransform(
+      rpc::ActorId actor,
+      const geom::Transform &transform) {
+    return _batch.Add<void>("set_actor_transform", actor, transform);
+  }
+
+  std::future<void> RpcBatch::SetActorTargetVelocity(
+      rpc::ActorId actor,
+      const geom::Vector3D &vector) {
+    return _batch.Add<void>("set_actor_target_velocity", actor, vector);
+  }
+
+  std::future<void> RpcBatch::SetActorTargetAngularVelocity(
+      rpc::ActorId actor,
+      const geom::Vector3D &vector) {
+    return _batch.Add<void>("set_actor_target_angular_velocity", actor, vector);
+  }
+
+  std::future<void> RpcBatch::SetActorSimulatePhysics(rpc::ActorId actor, bool enabled) {
+    return _batch.Add<void>("set_actor_simulate_physics", actor, enabled);
+  }
+
+  std::future<void> RpcBatch::SetActorEnableGravity(rpc::ActorId actor, bool enabled) {
+    return _batch.Add<void>("set_actor_enable_gravity", actor, enabled);
+  }
+
+} // namespace client
+} // namespace carla
@@ -0,0 +1,86 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/geom/Transform.h"
+#include "carla/rpc/ActorId.h"
+#include "carla/rpc/MultiCall.h"
+#include "carla/rpc/VehicleLightState.h"
+#include "carla/rpc/VehiclePhysicsControl.h"
+
+#include <future>
+#include <memory>
+
+namespace carla {
+namespace client {
+
+namespace detail {
+  class Simulator;
+}
+
+  /// Queues calls to the simulator to be sent in a single round-trip. Each
+  /// call returns a future that becomes ready once the batch is sent; the
+  /// calls are executed in the game thread in the order they were queued.
+  ///
+  /// Calls still pending when the batch is discarded or destroyed fail with
+  /// an exception. Not thread-safe.
+  class RpcBatch : private NonCopyable {
+  public:
+
+    explicit RpcBatch(std::shared_ptr<detail::Simulator> simulator);
+
+    size_t GetSize() const {
+      return _batch.size();
+    }
+
+    /// Send the queued calls and wait for their results.
+    void Send();
+
+    /// Fail every call queued without sending them.
+    void Discard();
+
+    // =========================================================================
+    /// @name Queued calls
+    // =========================================================================
+    /// @{
+
+    std::future<rpc::VehiclePhysicsControl> GetVehiclePhysicsControl(rpc::ActorId vehicle);
+
+    std::future<rpc::VehicleLightState> GetVehicleLightState(rpc::ActorId vehicle);
+
+    std::future<void> ApplyPhysicsControl(
+        rpc::ActorId vehicle,
+        const rpc::VehiclePhysicsControl &physics_control);
+
+    std::future<void> SetVehicleLightState(
+        rpc::ActorId vehicle,
+        const rpc::VehicleLightState &light_state);
+
+    std::future<void> SetActorLocation(rpc::ActorId actor, const geom::Location &location);
+
+    std::future<void> SetActorTransform(rpc::ActorId actor, const geom::Transform &transform);
+
+    std::future<void> SetActorTargetVelocity(rpc::ActorId actor, const geom::Vector3D &vector);
+
+    std::future<void> SetActorTargetAngularVelocity(rpc::ActorId actor, const geom::Vector3D &vector);
+
+    std::future<void> SetActorSimulatePhysics(rpc::ActorId actor, bool enabled);
+
+    std::future<void> SetActorEnableGravity(rpc::ActorId actor, bool enabled);
+
+    /// @}
+
+  private:
+
+    const std::shared_ptr<detail::Simulator> _simulator;
+
+    rpc::MultiCallBatch _batch;
+  };
+
+} // namespace client
+} // namespace carla
@@ -0,0 +1,77 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/client/SensorBundle.h"
+
+#include "carla/Exception.h"
+#include "carla/Logging.h"
+
+#include <exception>
+#include <stdexcept>
+
+namespace carla {
+namespace client {
+
+  SensorBundle::SensorBundle(std::vector<SharedPtr<Sensor>> sensors, Parameters parameters)
+    : _sensors(std::move(sensors)),
+      _parameters(std::move(parameters)) {
+    if (_sensors.empty()) {
+      throw_exception(std::invalid_argument("sensor bundle needs at least one sensor"));
+    }
+    for (auto &&sensor : _sensors) {
+      if (sensor == nullptr) {
+        throw_exception(std::invalid_argument("sensor bundle got a null sensor"));
+      }
+    }
+  }
+
+  SensorBundle::~SensorBundle() {
+    if (IsListening()) {
+      try {
+        Stop();
+      } catch (const std::exception &e) {
+        log_error("exception trying to stop sensor bundle:", e.what());
+      }
+    }
+  }
+
+  void SensorBundle::Listen(Sensor::CallbackFunctionType callback) {
+    auto aligner = std::make_shared<detail::FrameAligner>(
+        _sensors.size(),
+        _parameters,
+        std::move(callback));
+    _aligner = aligner;
+    _is_listening = true;
+    for (auto i = 0u; i < _sensors.size(); ++i) {
+      _sensors[i]->Listen([aligner, i](SharedPtr<sensor::SensorData> data) {
+        aligner->Push(i, std::move(data));
+      });
+    }
+  }
+
+  void SensorBundle::Stop() {
+    for (auto &&sensor : _sensors) {
+      if (sensor->IsListening()) {
+        sensor->Stop();
+      }
+    }
+    _is_listening = false;
+  }
+
+  void SensorBundle::Flush() {
+    auto aligner = _aligner.load();
+    if (aligner != nullptr) {
+      aligner->Flush();
+    }
+  }
+
+  SensorBundle::Stats SensorBundle::GetStats() const {
+    auto aligner = _aligner.load();
+    return aligner != nullptr ? aligner->GetStats() : Stats{};
+  }
+
+} // namespace client
+} // namespace carla
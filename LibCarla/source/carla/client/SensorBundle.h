@@ -0,0 +1,78 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/AtomicSharedPtr.h"
+#include "carla/Memory.h"
+#include "carla/NonCopyable.h"
+#include "carla/client/Sensor.h"
+#include "carla/client/detail/FrameAligner.h"
+
+#include <atomic>
+#include <vector>
+
+namespace carla {
+namespace client {
+
+  /// Listens to several sensors at once and delivers their measurements
+  /// grouped by frame, as a sensor::data::SensorBundleData holding one
+  /// measurement per sensor in the order given.
+  class SensorBundle : private NonCopyable {
+  public:
+
+    using PartialFramePolicy = detail::FrameAligner::PartialFramePolicy;
+
+    using Parameters = detail::FrameAligner::Parameters;
+
+    using Stats = detail::FrameAligner::Stats;
+
+    SensorBundle(std::vector<SharedPtr<Sensor>> sensors, Parameters parameters);
+
+    explicit SensorBundle(std::vector<SharedPtr<Sensor>> sensors)
+      : SensorBundle(std::move(sensors), Parameters{}) {}
+
+    ~SensorBundle();
+
+    const std::vector<SharedPtr<Sensor>> &GetSensors() const {
+      return _sensors;
+    }
+
+    const Parameters &GetParameters() const {
+      return _parameters;
+    }
+
+    /// Register a @a callback to be executed each time a frame is resolved.
+    /// Takes over the data stream of every sensor of the bundle.
+    void Listen(Sensor::CallbackFunctionType callback);
+
+    /// Stop listening to every sensor of the bundle.
+    void Stop();
+
+    bool IsListening() const {
+      return _is_listening;
+    }
+
+    /// Resolve the pending frames whose timeout has expired. Timeouts are
+    /// otherwise only checked when a measurement arrives.
+    void Flush();
+
+    /// Counters of the last call to Listen.
+    Stats GetStats() const;
+
+  private:
+
+    const std::vector<SharedPtr<Sensor>> _sensors;
+
+    const Parameters _parameters;
+
+    AtomicSharedPtr<detail::FrameAligner> _aligner;
+
+    std::atomic_bool _is_listening{false};
+  };
+
+} // namespace client
+} // namespace carla
@@ -0,0 +1,120 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/client/SensorDataQueue.h"
+
+#include "carla/Exception.h"
+#include "carla/sensor/SensorData.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace carla {
+namespace client {
+
+  SensorDataQueue::SensorDataQueue(size_t max_size, OverflowPolicy policy)
+    : _max_size(max_size),
+      _policy(policy) {
+    if (_max_size == 0u) {
+      throw_exception(std::invalid_argument("sensor data queue size must be greater than zero"));
+    }
+  }
+
+  Sensor::CallbackFunctionType SensorDataQueue::MakeCallback() {
+    return [self=shared_from_this()](SharedPtr<sensor::SensorData> data) {
+      self->Push(std::move(data));
+    };
+  }
+
+  void SensorDataQueue::Push(SharedPtr<sensor::SensorData> data) {
+    DEBUG_ASSERT(data != nullptr);
+    {
+      // critical section.
+      std::lock_guard<std::mutex> lock(_mutex);
+      ++_stats.received;
+      if (_queue.size() >= _max_size) {
+        ++_stats.dropped;
+        if (_policy == OverflowPolicy::DropNewest) {
+          return;
+        }
+        _queue.pop_front();
+      }
+      _queue.emplace_back(std::move(data));
+      _stats.max_size_reached = std::max(_stats.max_size_reached, _queue.size());
+    }
+    _cv.notify_all();
+  }
+
+  SharedPtr<sensor::SensorData> SensorDataQueue::Pop(time_duration timeout) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (!_cv.wait_for(lock, timeout.to_chrono(), [this]() { return !_queue.empty(); })) {
+      return nullptr;
+    }
+    auto data = std::move(_queue.front());
+    _queue.pop_front();
+    ++_stats.delivered;
+    return data;
+  }
+
+  SharedPtr<sensor::SensorData> SensorDataQueue::PopFrame(
+      const uint64_t frame,
+      const time_duration timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout.to_chrono();
+    std::unique_lock<std::mutex> lock(_mutex);
+    do {
+      while (!_queue.empty() && (_queue.front()->GetFrame() < frame)) {
+        _queue.pop_front();
+        ++_stats.skipped;
+      }
+      if (!_queue.empty()) {
+        if (_queue.front()->GetFrame() > frame) {
+          return nullptr;
+        }
+        auto data = std::move(_queue.front());
+        _queue.pop_front();
+        ++_stats.delivered;
+        return data;
+      }
+    } while (_cv.wait_until(lock, deadline) != std::cv_status::timeout || !_queue.empty());
+    return nullptr;
+  }
+
+  std::vector<SharedPtr<sensor::SensorData>> SensorDataQueue::PopBatch(
+      const size_t max_items,
+      const time_duration timeout) {
+    std::vector<SharedPtr<sensor::SensorData>> result;
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (!_cv.wait_for(lock, timeout.to_chrono(), [this]() { return !_queue.empty(); })) {
+      return result;
+    }
+    const auto count = (max_items == 0u) ? _queue.size() : std::min(max_items, _queue.size());
+    result.reserve(count);
+    for (auto i = 0u; i < count; ++i) {
+      result.emplace_back(std::move(_queue.front()));
+      _queue.pop_front();
+    }
+    _stats.delivered += count;
+    return result;
+  }
+
+  size_t SensorDataQueue::GetSize() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _queue.size();
+  }
+
+  void SensorDataQueue::Clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _queue.clear();
+  }
+
+  SensorDataQueue::Stats SensorDataQueue::GetStats() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+  }
+
+} // namespace client
+} // namespace carla
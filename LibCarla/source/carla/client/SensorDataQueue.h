@@ -0,0 +1,108 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Memory.h"
+#include "carla/NonCopyable.h"
+#include "carla/Time.h"
+#include "carla/client/Sensor.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace carla {
+namespace sensor { class SensorData; }
+namespace client {
+
+  /// Bounded queue of sensor measurements. It can be used as the callback of
+  /// a Sensor, so the measurements are deserialized and stored on the
+  /// streaming threads, and consumed later by polling the queue.
+  class SensorDataQueue
+    : public EnableSharedFromThis<SensorDataQueue>,
+      private NonCopyable {
+  public:
+
+    /// What to do with a new measurement when the queue is full. The
+    /// streaming threads never block on a full queue.
+    enum class OverflowPolicy : uint8_t {
+      DropOldest,
+      DropNewest
+    };
+
+    struct Stats {
+      /// Measurements pushed to the queue.
+      uint64_t received = 0u;
+      /// Measurements returned to the consumer.
+      uint64_t delivered = 0u;
+      /// Measurements discarded because the queue was full.
+      uint64_t dropped = 0u;
+      /// Measurements discarded while looking for a given frame.
+      uint64_t skipped = 0u;
+      /// Largest number of measurements queued at once.
+      size_t max_size_reached = 0u;
+    };
+
+    explicit SensorDataQueue(
+        size_t max_size,
+        OverflowPolicy policy = OverflowPolicy::DropOldest);
+
+    size_t GetMaxSize() const {
+      return _max_size;
+    }
+
+    OverflowPolicy GetOverflowPolicy() const {
+      return _policy;
+    }
+
+    /// Callback that pushes every measurement received into this queue. The
+    /// callback keeps the queue alive.
+    Sensor::CallbackFunctionType MakeCallback();
+
+    void Push(SharedPtr<sensor::SensorData> data);
+
+    /// Wait until a measurement is available and pop it. Returns nullptr if
+    /// the timeout is met.
+    SharedPtr<sensor::SensorData> Pop(time_duration timeout);
+
+    /// Wait for the measurement of @a frame and pop it, discarding any older
+    /// measurement. Returns nullptr if the timeout is met or if the frame was
+    /// missed, i.e. a newer measurement is at the front of the queue.
+    SharedPtr<sensor::SensorData> PopFrame(uint64_t frame, time_duration timeout);
+
+    /// Wait until a measurement is available and pop up to @a max_items of
+    /// them, all if @a max_items is zero. Returns an empty list if the
+    /// timeout is met.
+    std::vector<SharedPtr<sensor::SensorData>> PopBatch(
+        size_t max_items,
+        time_duration timeout);
+
+    size_t GetSize() const;
+
+    void Clear();
+
+    Stats GetStats() const;
+
+  private:
+
+    const size_t _max_size;
+
+    const OverflowPolicy _policy;
+
+    mutable std::mutex _mutex;
+
+    std::condition_variable _cv;
+
+    std::deque<SharedPtr<sensor::SensorData>> _queue;
+
+    Stats _stats;
+  };
+
+} // namespace client
+} // namespace carla
@@ -6,14 +6,18 @@
 
 #pragma once
 
+#include "carla/AtomicSharedPtr.h"
 #include "carla/NonCopyable.h"
 #include "carla/rpc/Actor.h"
 
-#include <boost/iterator/transform_iterator.hpp>
+#include <boost/optional.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <iterator>
-#include <mutex>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace carla {
 namespace client {
@@ -26,10 +30,15 @@ namespace detail {
   /// Keeps a list of actor descriptions to avoid requesting each time the
   /// descriptions to the server.
   ///
-  /// @todo Dead actors are never removed from the list.
-  class CachedActorList : private MovableNonCopyable {
+  /// Readers never lock: the list is an immutable map replaced atomically on
+  /// each modification. Each actor is tagged with the generation (the frame
+  /// of the episode) in which it was inserted, dead actors are removed by
+  /// Evict once a later generation no longer contains them.
+  class CachedActorList : private NonCopyable {
   public:
 
+    CachedActorList();
+
     /// Inserts an actor into the list.
     void Insert(rpc::Actor actor);
 
@@ -50,54 +59,107 @@ namespace detail {
     template <typename RangeT>
     std::vector<rpc::Actor> GetActorsById(const RangeT &range) const;
 
+    /// Retrieve the actors matching the ids in @a range, calling @a fetch
+    /// once with the ids missing from the list to retrieve the rest.
+    template <typename RangeT, typename FetchT>
+    std::vector<rpc::Actor> GetActorsById(const RangeT &range, FetchT &&fetch);
+
+    /// Remove the actors inserted before @a generation for which
+    /// @a is_alive returns false.
+    template <typename IsAliveT>
+    void Evict(uint64_t generation, IsAliveT &&is_alive);
+
+    size_t size() const {
+      return _actors.load()->size();
+    }
+
+    /// Remove every actor and restart the generations, call it when the
+    /// episode changes.
     void Clear();
 
   private:
 
-    mutable std::mutex _mutex;
+    struct Entry {
+      std::shared_ptr<const rpc::Actor> actor;
+      uint64_t generation;
+    };
+
+    using ActorMap = std::unordered_map<ActorId, Entry>;
+
+    /// Apply @a modify to a copy of the list and publish it, retries if
+    /// another thread modified the list meanwhile.
+    template <typename ModifierT>
+    void Modify(ModifierT &&modify);
+
+    /// Actors inserted now are not evicted by the generation in flight.
+    uint64_t GetInsertGeneration() const {
+      return _generation + 1u;
+    }
+
+    AtomicSharedPtr<const ActorMap> _actors;
 
-    std::unordered_map<ActorId, rpc::Actor> _actors;
+    std::atomic<uint64_t> _generation{0u};
   };
 
   // ===========================================================================
   // -- CachedActorList implementation -----------------------------------------
   // ===========================================================================
 
+  inline CachedActorList::CachedActorList()
+    : _actors(std::make_shared<const ActorMap>()) {}
+
+  template <typename ModifierT>
+  inline void CachedActorList::Modify(ModifierT &&modify) {
+    auto current = _actors.load();
+    std::shared_ptr<const ActorMap> next;
+    do {
+      auto copy = std::make_shared<ActorMap>(*current);
+      if (!modify(*copy)) {
+        return;
+      }
+      next = std::move(copy);
+    } while (!_actors.compare_exchange(&current, next));
+  }
+
   inline void CachedActorList::Insert(rpc::Actor actor) {
-    std::lock_guard<std::mutex> lock(_mutex);
-    auto id = actor.id;
-    _actors.emplace(id, std::move(actor));
+    const Entry entry{std::make_shared<const rpc::Actor>(std::move(actor)), GetInsertGeneration()};
+    Modify([&](ActorMap &actors) {
+      actors[entry.actor->id] = entry;
+      return true;
+    });
   }
 
   template <typename RangeT>
   inline void CachedActorList::InsertRange(RangeT range) {
-    auto make_a_pair = [](rpc::Actor actor) {
-      auto id = actor.id;
-      return std::make_pair(id, std::move(actor));
-    };
-    auto make_iterator = [&make_a_pair](auto it) {
-      return boost::make_transform_iterator(std::make_move_iterator(it), make_a_pair);
-    };
-    std::lock_guard<std::mutex> lock(_mutex);
-    _actors.insert(make_iterator(std::begin(range)), make_iterator(std::end(range)));
+    const auto generation = GetInsertGeneration();
+    std::vector<Entry> entries;
+    for (auto &&actor : range) {
+      entries.emplace_back(Entry{std::make_shared<const rpc::Actor>(std::move(actor)), generation});
+    }
+    Modify([&](ActorMap &actors) {
+      for (auto &&entry : entries) {
+        actors[entry.actor->id] = entry;
+      }
+      return !entries.empty();
+    });
   }
 
   template <typename RangeT>
   inline std::vector<ActorId> CachedActorList::GetMissingIds(const RangeT &range) const {
     std::vector<ActorId> result;
     result.reserve(range.size());
-    std::lock_guard<std::mutex> lock(_mutex);
-    std::copy_if(std::begin(range), std::end(range), std::back_inserter(result), [this](auto id) {
-      return _actors.find(id) == _actors.end();
+    auto actors = _actors.load();
+    std::copy_if(std::begin(range), std::end(range), std::back_inserter(result), [&](auto id) {
+      return actors->find(id) == actors->end();
     });
     return result;
   }
 
   inline boost::optional<rpc::Actor> CachedActorList::GetActorById(ActorId id) const {
-    std::lock_guard<std::mutex> lock(_mutex);
-    auto it = _actors.find(id);
-    if (it != _actors.end()) {
-      return it->second;
+    auto actors = _actors.load();
+    auto it = actors->find(id);
+    if (it != actors->end()) {
+      return *it->second.actor;
     }
     return boost::none;
   }
@@ -106,19 +168,77 @@ namespace detail {
   inline std::vector<rpc::Actor> CachedActorList::GetActorsById(const RangeT &range) const {
     std::vector<rpc::Actor> result;
     result.reserve(range.size());
-    std::lock_guard<std::mutex> lock(_mutex);
+    auto actors = _actors.load();
     for (auto &&id : range) {
-      auto it = _actors.find(id);
-      if (it != _actors.end()) {
-        result.emplace_back(it->second);
+      auto it = actors->find(id);
+      if (it != actors->end()) {
+        result.emplace_back(*it->second.actor);
       }
     }
     return result;
   }
 
+  template <typename RangeT, typename FetchT>
+  inline std::vector<rpc::Actor> CachedActorList::GetActorsById(const RangeT &range, FetchT &&fetch) {
+    auto actors = _actors.load();
+    std::vector<ActorId> missing_ids;
+    for (auto &&id : range) {
+      if (actors->find(id) == actors->end()) {
+        missing_ids.emplace_back(id);
+      }
+    }
+    if (missing_ids.empty()) {
+      return GetActorsById(range);
+    }
+    std::vector<rpc::Actor> fetched = fetch(missing_ids);
+    std::unordered_map<ActorId, const rpc::Actor *> fetched_by_id;
+    for (auto &&actor : fetched) {
+      fetched_by_id.emplace(actor.id, &actor);
+    }
+    // keep the order of the ids requested, using the list we looked up the
+    // missing ids from in case an eviction happened meanwhile.
+    std::vector<rpc::Actor> result;
+    result.reserve(range.size());
+    for (auto &&id : range) {
+      auto it = actors->find(id);
+      if (it != actors->end()) {
+        result.emplace_back(*it->second.actor);
+      } else {
+        auto fetched_it = fetched_by_id.find(id);
+        if (fetched_it != fetched_by_id.end()) {
+          result.emplace_back(*fetched_it->second);
+        }
+      }
+    }
+    InsertRange(std::move(fetched));
+    return result;
+  }
+
+  template <typename IsAliveT>
+  inline void CachedActorList::Evict(const uint64_t generation, IsAliveT &&is_alive) {
+    auto previous = _generation.load();
+    while ((previous < generation) && !_generation.compare_exchange_weak(previous, generation));
+    // check first on the current list to avoid copying it if nothing changes.
+    auto actors = _actors.load();
+    auto is_dead = [&](const ActorMap::value_type &item) {
+      return (item.second.generation < generation) && !is_alive(item.first);
+    };
+    if (std::none_of(actors->begin(), actors->end(), is_dead)) {
+      return;
+    }
+    Modify([&](ActorMap &copy) {
+      auto size = copy.size();
+      for (auto it = copy.begin(); it != copy.end();) {
+        it = is_dead(*it) ? copy.erase(it) : std::next(it);
+      }
+      return copy.size() != size;
+    });
+  }
+
   inline void CachedActorList::Clear() {
-    std::lock_guard<std::mutex> lock(_mutex);
-    _actors.clear();
+    _actors.store(std::make_shared<const ActorMap>());
+    // a new episode counts frames from the start again.
+    _generation = 0u;
   }
 
 } // namespace detail
@@ -10,21 +10,21 @@
 #include "carla/Version.h"
 #include "carla/client/FileTransfer.h"
 #include "carla/client/TimeoutException.h"
+#include "carla/client/detail/StreamingContext.h"
 #include "carla/rpc/ActorDescription.h"
 #include "carla/rpc/BoneTransformDataIn.h"
 #include "carla/rpc/Client.h"
 #include "carla/rpc/DebugShape.h"
+#include "carla/rpc/MultiCall.h"
 #include "carla/rpc/Response.h"
 #include "carla/rpc/VehicleControl.h"
 #include "carla/rpc/VehicleLightState.h"
 #include "carla/rpc/WalkerBoneControlIn.h"
 #include "carla/rpc/WalkerBoneControlOut.h"
 #include "carla/rpc/WalkerControl.h"
-#include "carla/streaming/Client.h"
 
 #include <rpc/rpc_error.h>
 
-#include <thread>
 
 namespace carla {
 namespace client {
@@ -49,10 +49,12 @@ namespace detail {
     Pimpl(const std::string &host, uint16_t port, size_t worker_threads)
       : endpoint(host + ":" + std::to_string(port)),
         rpc_client(host, port),
-        streaming_client(host) {
+        streaming_context(StreamingContext::Get(host, port, worker_threads)) {
       rpc_client.set_timeout(5000u);
-      streaming_client.AsyncRun(
-          worker_threads > 0u ? worker_threads : std::thread::hardware_concurrency());
+    }
+
+    ~Pimpl() {
+      streaming_context->UnSubscribeAll(this);
     }
 
     template <typename ... Args>
@@ -91,7 +93,7 @@ namespace detail {
 
     rpc::Client rpc_client;
 
-    streaming::Client streaming_client;
+    const std::shared_ptr<StreamingContext> streaming_context;
   };
 
   // ===========================================================================
@@ -560,11 +562,19 @@ namespace detail {
   void Client::SubscribeToStream(
       const streaming::Token &token,
       std::function<void(Buffer)> callback) {
-    _pimpl->streaming_client.Subscribe(token, std::move(callback));
+    _pimpl->streaming_context->Subscribe(_pimpl.get(), token, std::move(callback));
   }
 
   void Client::UnSubscribeFromStream(const streaming::Token &token) {
-    _pimpl->streaming_client.UnSubscribe(token);
+    _pimpl->streaming_context->UnSubscribe(_pimpl.get(), token);
+  }
+
+  std::vector<streaming::StreamMetrics> Client::GetStreamingMetrics() {
+    return _pimpl->streaming_context->GetMetrics();
+  }
+
+  uint16_t Client::ServeStreamingMetrics(uint16_t port) {
+    return _pimpl->streaming_context->ServeMetrics(port);
   }
 
   void Client::DrawDebugShape(const rpc::DebugShape &shape) {
@@ -572,7 +582,7 @@ namespace detail {
   }
 
   void Client::ApplyBatch(std::vector<rpc::Command> commands, bool do_tick_cue) {
-    _pimpl->AsyncCall("apply_batch", std::move(commands), do_tick_cue);
+    _pimpl->AsyncCall("apply_batch_no_response", std::move(commands), do_tick_cue);
   }
 
   std::vector<rpc::CommandResponse> Client::ApplyBatchSync(
@@ -582,6 +592,27 @@ namespace detail {
     return result.as<std::vector<rpc::CommandResponse>>();
   }
 
+  void Client::ApplyVehicleControlBatch(
+      const rpc::VehicleControlBatch &controls,
+      const std::vector<rpc::Command> &commands) {
+    _pimpl->CallAndWait<void>("apply_vehicle_control_batch", controls, commands);
+  }
+
+  void Client::SendMultiCall(rpc::MultiCallBatch &batch) {
+    if (batch.empty()) {
+      return;
+    }
+    std::vector<rpc::MultiCallResult> results;
+    try {
+      auto object = _pimpl->RawCall("multi_call", batch.GetRequests());
+      results = object.as<std::vector<rpc::MultiCallResult>>();
+    } catch (...) {
+      batch.SetException(std::current_exception());
+      throw;
+    }
+    batch.SetResults(results);
+  }
+
   uint64_t Client::SendTickCue() {
     return _pimpl->CallAndWait<uint64_t>("tick_cue");
   }
@@ -25,6 +25,7 @@
 #include "carla/rpc/MapLayer.h"
 #include "carla/rpc/OpendriveGenerationParameters.h"
 #include "carla/rpc/TrafficLightState.h"
+#include "carla/rpc/VehicleControlBatch.h"
 #include "carla/rpc/VehicleDoor.h"
 #include "carla/rpc/VehicleLightStateList.h"
 #include "carla/rpc/VehicleLightState.h"
@@ -33,6 +34,7 @@
 #include "carla/rpc/WeatherParameters.h"
 #include "carla/rpc/Texture.h"
 #include "carla/rpc/MaterialParameter.h"
+#include "carla/streaming/Metrics.h"
 
 #include <functional>
 #include <memory>
@@ -45,6 +47,7 @@ namespace carla {
 namespace rpc {
   class ActorDescription;
   class DebugShape;
+  class MultiCallBatch;
   class VehicleControl;
   class WalkerControl;
   class WalkerBoneControlIn;
@@ -358,6 +361,14 @@ namespace detail {
 
     void UnSubscribeFromStream(const streaming::Token &token);
 
+    /// Metrics of the streams subscribed by any client of the process
+    /// connected to the same simulator.
+    std::vector<streaming::StreamMetrics> GetStreamingMetrics();
+
+    /// Serve the streaming metrics in the Prometheus text format on the
+    /// loopback interface, returns the port.
+    uint16_t ServeStreamingMetrics(uint16_t port);
+
     void DrawDebugShape(const rpc::DebugShape &shape);
 
     void ApplyBatch(
@@ -368,6 +379,16 @@ namespace detail {
         std::vector<rpc::Command> commands,
         bool do_tick_cue);
 
+    /// Apply @a controls and then @a commands, waiting for the simulator to
+    /// execute them. The controls are sent as packed arrays.
+    void ApplyVehicleControlBatch(
+        const rpc::VehicleControlBatch &controls,
+        const std::vector<rpc::Command> &commands);
+
+    /// Send every call queued in @a batch in a single "multi_call" request,
+    /// and fulfil their futures with the results.
+    void SendMultiCall(rpc::MultiCallBatch &batch);
+
     uint64_t SendTickCue();
 
     std::vector<rpc::LightState> QueryLightsStateToServer() const;
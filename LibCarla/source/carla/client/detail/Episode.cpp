@@ -9,6 +9,7 @@
 #include "carla/Logging.h"
 #include "carla/client/detail/Client.h"
 #include "carla/client/detail/WalkerNavigation.h"
+#include "carla/profiler/Tracer.h"
 #include "carla/sensor/Deserializer.h"
 #include "carla/trafficmanager/TrafficManager.h"
 
@@ -27,11 +28,9 @@ using namespace std::chrono_literals;
 
   template <typename RangeT>
   static auto GetActorsById_Impl(Client &client, CachedActorList &actors, const RangeT &actor_ids) {
-    auto missing_ids = actors.GetMissingIds(actor_ids);
-    if (!missing_ids.empty()) {
-      actors.InsertRange(client.GetActorsById(missing_ids));
-    }
-    return actors.GetActorsById(actor_ids);
+    return actors.GetActorsById(actor_ids, [&client](const std::vector<ActorId> &missing_ids) {
+      return client.GetActorsById(missing_ids);
+    });
   }
 
   Episode::Episode(Client &client)
@@ -55,9 +54,15 @@ using namespace std::chrono_literals;
     _client.SubscribeToStream(_token, [weak](auto buffer) {
       auto self = weak.lock();
       if (self != nullptr) {
+        CARLA_TRACE_SCOPE(episode, on_tick);
 
-        auto data = sensor::Deserializer::Deserialize(std::move(buffer));
-        auto next = std::make_shared<const EpisodeState>(CastData(*data));
+        std::shared_ptr<const EpisodeState> next;
+        {
+          CARLA_TRACE_SCOPE(episode, parse_state);
+          auto data = sensor::Deserializer::Deserialize(std::move(buffer));
+          next = std::make_shared<const EpisodeState>(CastData(*data));
+        }
+        CARLA_TRACE_FRAME(next->GetFrame());
         auto prev = self->GetState();
 
         // TODO: Update how the map change is detected
@@ -86,6 +91,18 @@ using namespace std::chrono_literals;
             }
           } while (!self->_state.compare_exchange(&prev, next));
 
+          // The frame counter restarts on a new episode, and the actor ids
+          // of the previous one are no longer valid.
+          if (episode_changed) {
+            self->_actors.Clear();
+            self->_frame_barrier.Reset(next->GetFrame());
+          }
+
+          // Forget the actors destroyed.
+          self->_actors.Evict(next->GetFrame(), [&next](ActorId id) {
+            return next->ContainsActorSnapshot(id);
+          });
+
           if(UpdateLights) {
             self->_on_light_update_callbacks.Call(next);
           }
@@ -100,6 +117,7 @@ using namespace std::chrono_literals;
           }
 
           // Notify waiting threads and do the callbacks.
+          self->_frame_barrier.Publish(next->GetFrame());
           self->_snapshot.SetValue(next);
 
           // Tick navigation.
@@ -14,6 +14,7 @@
 #include "carla/client/detail/CachedActorList.h"
 #include "carla/client/detail/CallbackList.h"
 #include "carla/client/detail/EpisodeState.h"
+#include "carla/client/detail/FrameBarrier.h"
 #include "carla/client/detail/WalkerNavigation.h"
 #include "carla/rpc/EpisodeInfo.h"
 
@@ -71,6 +72,13 @@ namespace detail {
       return _snapshot.WaitFor(timeout);
     }
 
+    /// Block until the state of @a frame, or a later one, has been received.
+    ///
+    /// @return false if the timeout is met.
+    bool WaitForFrame(uint64_t frame, time_duration timeout) {
+      return _frame_barrier.WaitFor(frame, timeout);
+    }
+
     size_t RegisterOnTickEvent(std::function<void(WorldSnapshot)> callback) {
       return _on_tick_callbacks.Push(std::move(callback));
     }
@@ -140,6 +148,8 @@ namespace detail {
 
     RecurrentSharedFuture<WorldSnapshot> _snapshot;
 
+    FrameBarrier _frame_barrier;
+
     const streaming::Token _token;
 
     bool _pending_exceptions = false;
@@ -0,0 +1,161 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/client/detail/FrameAligner.h"
+
+#include "carla/Exception.h"
+#include "carla/Logging.h"
+#include "carla/sensor/data/SensorBundleData.h"
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+
+namespace carla {
+namespace client {
+namespace detail {
+
+  FrameAligner::FrameAligner(
+      const size_t number_of_streams,
+      Parameters parameters,
+      CallbackFunctionType callback)
+    : _number_of_streams(number_of_streams),
+      _parameters(std::move(parameters)),
+      _callback(std::move(callback)),
+      _slots(std::make_unique<Slot[]>(_parameters.max_pending_frames)),
+      _last_frames(std::make_unique<std::atomic<uint64_t>[]>(number_of_streams)) {
+    if ((_number_of_streams == 0u) || (_parameters.max_pending_frames == 0u)) {
+      throw_exception(std::invalid_argument("frame aligner needs at least one stream and one pending frame"));
+    }
+    for (auto i = 0u; i < _number_of_streams; ++i) {
+      _last_frames[i] = 0u;
+    }
+  }
+
+  void FrameAligner::Push(const size_t stream, SharedPtr<sensor::SensorData> data) {
+    DEBUG_ASSERT(stream < _number_of_streams);
+    DEBUG_ASSERT(data != nullptr);
+    const uint64_t frame = data->GetFrame();
+    auto last = _last_frames[stream].load();
+    while ((last < frame) && !_last_frames[stream].compare_exchange_weak(last, frame));
+
+    const auto now = clock::now();
+    std::vector<SharedPtr<sensor::SensorData>> ready;
+    {
+      auto &slot = _slots[frame % _parameters.max_pending_frames];
+      std::lock_guard<std::mutex> lock(slot.mutex);
+      if (slot.is_pending && (slot.frame > frame)) {
+        ++_late;
+        return;
+      }
+      if (slot.is_pending && (slot.frame < frame)) {
+        // the slot is needed for a newer frame.
+        ready.emplace_back(Resolve(slot));
+      }
+      if (!slot.is_pending) {
+        if (frame < slot.first_valid_frame) {
+          ++_late;
+          return;
+        }
+        slot.is_pending = true;
+        slot.frame = frame;
+        slot.count = 0u;
+        slot.deadline = now + _parameters.timeout.to_chrono();
+        slot.measurements.assign(_number_of_streams, nullptr);
+      }
+      if (slot.measurements[stream] == nullptr) {
+        ++slot.count;
+      }
+      slot.measurements[stream] = std::move(data);
+      if (slot.count == _number_of_streams) {
+        ready.emplace_back(Resolve(slot));
+      }
+    }
+    Sweep(now, ready);
+    Deliver(ready);
+  }
+
+  void FrameAligner::Flush() {
+    std::vector<SharedPtr<sensor::SensorData>> ready;
+    Sweep(clock::now(), ready);
+    Deliver(ready);
+  }
+
+  FrameAligner::Stats FrameAligner::GetStats() const {
+    Stats stats;
+    stats.complete = _complete;
+    stats.partial = _partial;
+    stats.dropped = _dropped;
+    stats.late = _late;
+    return stats;
+  }
+
+  bool FrameAligner::IsStale(const Slot &slot, const clock::time_point now) const {
+    if (now >= slot.deadline) {
+      return true;
+    }
+    for (auto i = 0u; i < _number_of_streams; ++i) {
+      if ((slot.measurements[i] == nullptr) && (_last_frames[i].load() <= slot.frame)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  SharedPtr<sensor::SensorData> FrameAligner::Resolve(Slot &slot) {
+    DEBUG_ASSERT(slot.is_pending);
+    slot.is_pending = false;
+    slot.first_valid_frame = slot.frame + 1u;
+    const bool is_complete = (slot.count == _number_of_streams);
+    if (!is_complete && (_parameters.partial_policy == PartialFramePolicy::Drop)) {
+      ++_dropped;
+      slot.measurements.clear();
+      return nullptr;
+    }
+    ++(is_complete ? _complete : _partial);
+    auto first = std::find_if(
+        slot.measurements.begin(),
+        slot.measurements.end(),
+        [](const SharedPtr<sensor::SensorData> &item) { return item != nullptr; });
+    DEBUG_ASSERT(first != slot.measurements.end());
+    const auto timestamp = (*first)->GetTimestamp();
+    const auto transform = (*first)->GetSensorTransform();
+    return MakeShared<sensor::data::SensorBundleData>(
+        slot.frame,
+        timestamp,
+        transform,
+        std::move(slot.measurements));
+  }
+
+  void FrameAligner::Sweep(
+      const clock::time_point now,
+      std::vector<SharedPtr<sensor::SensorData>> &ready) {
+    for (auto i = 0u; i < _parameters.max_pending_frames; ++i) {
+      auto &slot = _slots[i];
+      std::lock_guard<std::mutex> lock(slot.mutex);
+      if (slot.is_pending && IsStale(slot, now)) {
+        ready.emplace_back(Resolve(slot));
+      }
+    }
+  }
+
+  void FrameAligner::Deliver(std::vector<SharedPtr<sensor::SensorData>> &ready) {
+    ready.erase(std::remove(ready.begin(), ready.end(), nullptr), ready.end());
+    std::sort(ready.begin(), ready.end(), [](const auto &lhs, const auto &rhs) {
+      return lhs->GetFrame() < rhs->GetFrame();
+    });
+    for (auto &&bundle : ready) {
+      try {
+        _callback(std::move(bundle));
+      } catch (const std::exception &e) {
+        log_error("exception in sensor bundle callback:", e.what());
+      }
+    }
+  }
+
+} // namespace detail
+} // namespace client
+} // namespace carla
@@ -0,0 +1,132 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Memory.h"
+#include "carla/NonCopyable.h"
+#include "carla/Time.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace carla {
+namespace sensor { class SensorData; }
+namespace client {
+namespace detail {
+
+  /// Joins the measurements of several sensor streams by frame number, and
+  /// delivers a sensor::data::SensorBundleData per frame.
+  ///
+  /// Frames being assembled are kept in a ring of slots indexed by frame
+  /// number, each slot with its own lock, so streams only contend when they
+  /// deliver measurements of the same frame. A pending frame is resolved
+  /// when every stream has delivered its measurement, when every missing
+  /// stream has already delivered a later frame (each stream is ordered, so
+  /// the measurement will never arrive), when the timeout expires or when
+  /// its slot is needed by a newer frame. Timeouts are only checked when a
+  /// measurement arrives or Flush is called.
+  class FrameAligner : private NonCopyable {
+  public:
+
+    using CallbackFunctionType = std::function<void(SharedPtr<sensor::SensorData>)>;
+
+    /// What to do with frames that are not complete when resolved.
+    enum class PartialFramePolicy : uint8_t {
+      Drop,
+      Deliver
+    };
+
+    struct Parameters {
+      /// Time to wait for the rest of a frame after its first measurement.
+      time_duration timeout = time_duration::seconds(1u);
+      PartialFramePolicy partial_policy = PartialFramePolicy::Drop;
+      /// Number of frames that can be assembled at the same time.
+      size_t max_pending_frames = 16u;
+    };
+
+    struct Stats {
+      /// Frames delivered with every measurement.
+      uint64_t complete = 0u;
+      /// Incomplete frames delivered.
+      uint64_t partial = 0u;
+      /// Incomplete frames dropped.
+      uint64_t dropped = 0u;
+      /// Measurements received after their frame was resolved.
+      uint64_t late = 0u;
+    };
+
+    FrameAligner(
+        size_t number_of_streams,
+        Parameters parameters,
+        CallbackFunctionType callback);
+
+    size_t GetNumberOfStreams() const {
+      return _number_of_streams;
+    }
+
+    /// Add a measurement received on @a stream, invoking the callback for
+    /// every frame resolved. Thread-safe.
+    void Push(size_t stream, SharedPtr<sensor::SensorData> data);
+
+    /// Resolve the pending frames whose timeout has expired.
+    void Flush();
+
+    Stats GetStats() const;
+
+  private:
+
+    using clock = std::chrono::steady_clock;
+
+    struct Slot {
+      std::mutex mutex;
+      bool is_pending = false;
+      uint64_t frame = 0u;
+      /// Measurements of older frames arrive after their frame was resolved.
+      uint64_t first_valid_frame = 0u;
+      size_t count = 0u;
+      clock::time_point deadline;
+      std::vector<SharedPtr<sensor::SensorData>> measurements;
+    };
+
+    bool IsStale(const Slot &slot, clock::time_point now) const;
+
+    /// Resolve the frame pending in @a slot, returns nullptr if dropped.
+    /// Requires the slot to be locked.
+    SharedPtr<sensor::SensorData> Resolve(Slot &slot);
+
+    void Sweep(clock::time_point now, std::vector<SharedPtr<sensor::SensorData>> &ready);
+
+    void Deliver(std::vector<SharedPtr<sensor::SensorData>> &ready);
+
+    const size_t _number_of_streams;
+
+    const Parameters _parameters;
+
+    const CallbackFunctionType _callback;
+
+    const std::unique_ptr<Slot[]> _slots;
+
+    /// Last frame received on each stream.
+    const std::unique_ptr<std::atomic<uint64_t>[]> _last_frames;
+
+    std::atomic<uint64_t> _complete{0u};
+
+    std::atomic<uint64_t> _partial{0u};
+
+    std::atomic<uint64_t> _dropped{0u};
+
+    std::atomic<uint64_t> _late{0u};
+  };
+
+} // namespace detail
+} // namespace client
+} // namespace carla
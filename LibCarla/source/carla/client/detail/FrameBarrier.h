@@ -0,0 +1,94 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/Time.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace carla {
+namespace client {
+namespace detail {
+
+  /// Lets any number of threads sleep until a given frame has been received.
+  ///
+  /// The publisher only takes the lock if someone is waiting, so publishing a
+  /// frame nobody waits for costs two atomic operations.
+  class FrameBarrier : private NonCopyable {
+  public:
+
+    uint64_t GetLastFrame() const {
+      return _frame.load();
+    }
+
+    /// Publish that @a frame has been received, waking up every thread
+    /// waiting for this frame or an earlier one. Frames older than the last
+    /// published are ignored.
+    void Publish(uint64_t frame) {
+      auto last = _frame.load();
+      while (last < frame && !_frame.compare_exchange_weak(last, frame));
+      if (_waiters.load() > 0u) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _cv.notify_all();
+      }
+    }
+
+    /// Move the barrier to @a frame even if it is older than the last
+    /// published, used when the server starts counting frames again on a new
+    /// episode.
+    void Reset(uint64_t frame) {
+      _frame = frame;
+      if (_waiters.load() > 0u) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _cv.notify_all();
+      }
+    }
+
+    /// Wait until a frame equal or greater than @a frame is published.
+    ///
+    /// @return false if the timeout is met.
+    bool WaitFor(uint64_t frame, time_duration timeout) {
+      // waiters re-check the last frame at least this often, this bounds the
+      // latency of a wake up even if a notification is lost.
+      constexpr auto max_sleep = std::chrono::milliseconds(50);
+      if (_frame.load() >= frame) {
+        return true;
+      }
+      const auto deadline = std::chrono::steady_clock::now() + timeout.to_chrono();
+      std::unique_lock<std::mutex> lock(_mutex);
+      ++_waiters;
+      while (_frame.load() < frame) {
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+          break;
+        }
+        _cv.wait_until(lock, std::min(deadline, now + max_sleep));
+      }
+      --_waiters;
+      return _frame.load() >= frame;
+    }
+
+  private:
+
+    std::atomic<uint64_t> _frame{0u};
+
+    std::atomic<size_t> _waiters{0u};
+
+    std::mutex _mutex;
+
+    std::condition_variable _cv;
+  };
+
+} // namespace detail
+} // namespace client
+} // namespace carla
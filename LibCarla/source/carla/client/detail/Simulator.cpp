@@ -21,7 +21,9 @@
 #include "carla/sensor/Deserializer.h"
 
 #include <exception>
-#include <thread>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
 
 using namespace std::string_literals;
 
@@ -45,18 +47,32 @@ namespace detail {
     }
   }
 
-  static bool SynchronizeFrame(uint64_t frame, const Episode &episode, time_duration timeout) {
-    bool result = true;
-    auto start = std::chrono::system_clock::now();
-    while (frame > episode.GetState()->GetTimestamp().frame) {
-      std::this_thread::yield();
-      auto end = std::chrono::system_clock::now();
-      auto diff = std::chrono::duration_cast<std::chrono::milliseconds>(end-start);
-      if(timeout.to_chrono() < diff) {
-        result = false;
-        break;
+  /// Parsed maps are shared by every client of the process, keyed by the
+  /// hash of their OpenDRIVE content.
+  static SharedPtr<Map> GetSharedMap(const rpc::MapInfo &map_info, const std::string &open_drive) {
+    static std::mutex mutex;
+    static std::unordered_multimap<size_t, boost::weak_ptr<Map>> cache;
+    const auto hash = std::hash<std::string>{}(open_drive);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto range = cache.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      auto map = it->second.lock();
+      if ((map != nullptr) &&
+          (map->GetName() == map_info.name) &&
+          (map->GetOpenDrive() == open_drive)) {
+        return map;
       }
     }
+    for (auto it = cache.begin(); it != cache.end();) {
+      it = it->second.expired() ? cache.erase(it) : std::next(it);
+    }
+    auto map = MakeShared<Map>(map_info, open_drive);
+    cache.emplace(hash, map);
+    return map;
+  }
+
+  static bool SynchronizeFrame(uint64_t frame, Episode &episode, time_duration timeout) {
+    bool result = episode.WaitForFrame(frame, timeout);
     if(result) {
       carla::traffic_manager::TrafficManager::Tick();
     }
@@ -170,7 +186,7 @@ namespace detail {
       std::string XODRFolder = map_base_path + "/OpenDrive/" + map_name + ".xodr";
       if (FileTransfer::FileExists(XODRFolder) == false) _client.GetRequiredFiles();
       _open_drive_file = _client.GetMapData();
-      _cached_map = MakeShared<Map>(map_info, _open_drive_file);
+      _cached_map = GetSharedMap(map_info, _open_drive_file);
     }
 
     return _cached_map;
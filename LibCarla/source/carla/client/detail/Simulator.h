@@ -580,6 +580,14 @@ namespace detail {
 
     void UnSubscribeFromSensor(const Sensor &sensor);
 
+    std::vector<streaming::StreamMetrics> GetStreamingMetrics() {
+      return _client.GetStreamingMetrics();
+    }
+
+    uint16_t ServeStreamingMetrics(uint16_t port) {
+      return _client.ServeStreamingMetrics(port);
+    }
+
     /// @}
     // =========================================================================
     /// @name Operations with traffic lights
@@ -646,6 +654,16 @@ namespace detail {
       return _client.ApplyBatchSync(std::move(commands), do_tick_cue);
     }
 
+    void ApplyVehicleControlBatch(
+        const rpc::VehicleControlBatch &controls,
+        const std::vector<rpc::Command> &commands) {
+      _client.ApplyVehicleControlBatch(controls, commands);
+    }
+
+    void SendMultiCall(rpc::MultiCallBatch &batch) {
+      _client.SendMultiCall(batch);
+    }
+
     /// @}
     // =========================================================================
     /// @name Operations lights
@@ -0,0 +1,143 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/client/detail/StreamingContext.h"
+
+#include "carla/Debug.h"
+#include "carla/Logging.h"
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+namespace carla {
+namespace client {
+namespace detail {
+
+  static auto GetStreamId(const streaming::Token &token) {
+    return streaming::detail::token_type(token).get_stream_id();
+  }
+
+  std::shared_ptr<StreamingContext> StreamingContext::Get(
+      const std::string &host,
+      const uint16_t port,
+      const size_t worker_threads) {
+    static std::mutex mutex;
+    static std::unordered_map<std::string, std::weak_ptr<StreamingContext>> contexts;
+    const auto endpoint = host + ":" + std::to_string(port);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto context = contexts[endpoint].lock();
+    if (context == nullptr) {
+      for (auto it = contexts.begin(); it != contexts.end();) {
+        it = it->second.expired() ? contexts.erase(it) : std::next(it);
+      }
+      context = std::make_shared<StreamingContext>(host, worker_threads);
+      contexts[endpoint] = context;
+    } else if ((worker_threads > 0u) && (worker_threads != context->GetNumberOfWorkerThreads())) {
+      log_warning(
+          "streaming client of", endpoint, "already running with",
+          context->GetNumberOfWorkerThreads(), "threads, ignoring worker_threads =",
+          worker_threads);
+    }
+    return context;
+  }
+
+  StreamingContext::StreamingContext(const std::string &host, const size_t worker_threads)
+    : _worker_threads(worker_threads > 0u ? worker_threads : std::thread::hardware_concurrency()),
+      _client(host) {
+    _client.AsyncRun(_worker_threads);
+  }
+
+  void StreamingContext::Subscribe(
+      const void *subscriber,
+      const streaming::Token &token,
+      CallbackFunctionType callback) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto &stream = _streams[GetStreamId(token)];
+    if (stream.subscribers == nullptr) {
+      stream.token = token;
+      stream.subscribers = std::make_shared<SharedSubscriberList>(
+          std::make_shared<const SubscriberList>());
+      std::weak_ptr<SharedSubscriberList> weak = stream.subscribers;
+      _client.Subscribe(token, [weak](Buffer buffer) {
+        auto shared = weak.lock();
+        if (shared != nullptr) {
+          auto subscribers = shared->load();
+          Dispatch(*subscribers, std::move(buffer));
+        }
+      });
+    }
+    auto subscribers = std::make_shared<SubscriberList>(*stream.subscribers->load());
+    DEBUG_ASSERT(std::none_of(subscribers->begin(), subscribers->end(), [=](const auto &item) {
+      return item.first == subscriber;
+    }));
+    subscribers->emplace_back(subscriber, std::move(callback));
+    stream.subscribers->store(std::move(subscribers));
+  }
+
+  void StreamingContext::UnSubscribe(const void *subscriber, const streaming::Token &token) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _streams.find(GetStreamId(token));
+    if (it != _streams.end()) {
+      Remove(subscriber, it);
+    }
+  }
+
+  void StreamingContext::UnSubscribeAll(const void *subscriber) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto it = _streams.begin(); it != _streams.end();) {
+      it = Remove(subscriber, it);
+    }
+  }
+
+  size_t StreamingContext::GetNumberOfSubscribers(const streaming::Token &token) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _streams.find(GetStreamId(token));
+    return it != _streams.end() ? it->second.subscribers->load()->size() : 0u;
+  }
+
+  uint16_t StreamingContext::ServeMetrics(uint16_t port) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _client.ServeMetrics(port);
+  }
+
+  StreamingContext::StreamMap::iterator StreamingContext::Remove(
+      const void *subscriber,
+      StreamMap::iterator it) {
+    auto subscribers = std::make_shared<SubscriberList>(*it->second.subscribers->load());
+    subscribers->erase(
+        std::remove_if(subscribers->begin(), subscribers->end(), [=](const auto &item) {
+          return item.first == subscriber;
+        }),
+        subscribers->end());
+    if (subscribers->empty()) {
+      _client.UnSubscribe(it->second.token);
+      return _streams.erase(it);
+    }
+    it->second.subscribers->store(std::move(subscribers));
+    return std::next(it);
+  }
+
+  void StreamingContext::Dispatch(const SubscriberList &subscribers, Buffer buffer) {
+    auto call = [](const CallbackFunctionType &callback, Buffer data) {
+      try {
+        callback(std::move(data));
+      } catch (const std::exception &e) {
+        log_error("exception in stream subscriber:", e.what());
+      }
+    };
+    // every subscriber but the last one gets a copy of the data.
+    for (auto i = 1u; i < subscribers.size(); ++i) {
+      call(subscribers[i - 1u].second, Buffer(buffer.data(), buffer.size()));
+    }
+    if (!subscribers.empty()) {
+      call(subscribers.back().second, std::move(buffer));
+    }
+  }
+
+} // namespace detail
+} // namespace client
+} // namespace carla
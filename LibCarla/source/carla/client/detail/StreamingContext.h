@@ -0,0 +1,109 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/AtomicSharedPtr.h"
+#include "carla/Buffer.h"
+#include "carla/NonCopyable.h"
+#include "carla/streaming/Client.h"
+#include "carla/streaming/detail/Types.h"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace carla {
+namespace client {
+namespace detail {
+
+  /// Streaming client shared by every client of the process connected to the
+  /// same simulator. Holds a single thread pool and a single connection per
+  /// stream; the data received is dispatched to every subscriber of the
+  /// stream.
+  class StreamingContext : private NonCopyable {
+  public:
+
+    using CallbackFunctionType = std::function<void(Buffer)>;
+
+    /// Return the context of the simulator at @a host and @a port, creating
+    /// it with @a worker_threads threads if no other client of the process is
+    /// using it.
+    ///
+    /// @note An existing context keeps the threads it was created with, a
+    /// different @a worker_threads is ignored with a warning.
+    static std::shared_ptr<StreamingContext> Get(
+        const std::string &host,
+        uint16_t port,
+        size_t worker_threads);
+
+    StreamingContext(const std::string &host, size_t worker_threads);
+
+    /// Register @a callback to be called by @a subscriber each time data is
+    /// received on the stream of @a token. Connects to the stream on the first
+    /// subscription.
+    ///
+    /// @warning a subscriber cannot subscribe twice to the same stream.
+    void Subscribe(
+        const void *subscriber,
+        const streaming::Token &token,
+        CallbackFunctionType callback);
+
+    /// Remove the callback of @a subscriber. Disconnects from the stream when
+    /// no subscriber is left.
+    void UnSubscribe(const void *subscriber, const streaming::Token &token);
+
+    /// Remove every callback of @a subscriber.
+    void UnSubscribeAll(const void *subscriber);
+
+    size_t GetNumberOfSubscribers(const streaming::Token &token) const;
+
+    size_t GetNumberOfWorkerThreads() const {
+      return _worker_threads;
+    }
+
+    std::vector<streaming::StreamMetrics> GetMetrics() const {
+      return _client.GetMetrics();
+    }
+
+    /// Serve the metrics on @a port of the loopback interface, see
+    /// streaming::Client::ServeMetrics.
+    uint16_t ServeMetrics(uint16_t port);
+
+  private:
+
+    using SubscriberList = std::vector<std::pair<const void *, CallbackFunctionType>>;
+
+    using SharedSubscriberList = AtomicSharedPtr<const SubscriberList>;
+
+    struct Stream {
+      streaming::Token token;
+      std::shared_ptr<SharedSubscriberList> subscribers;
+    };
+
+    using StreamMap = std::unordered_map<streaming::detail::stream_id_type, Stream>;
+
+    static void Dispatch(const SubscriberList &subscribers, Buffer buffer);
+
+    /// Remove @a subscriber from @a it, returns the next stream.
+    StreamMap::iterator Remove(const void *subscriber, StreamMap::iterator it);
+
+    const size_t _worker_threads;
+
+    mutable std::mutex _mutex;
+
+    streaming::Client _client;
+
+    StreamMap _streams;
+  };
+
+} // namespace detail
+} // namespace client
+} // namespace carla
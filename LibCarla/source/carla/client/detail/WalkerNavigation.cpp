@@ -9,11 +9,14 @@
 #include "carla/client/detail/Client.h"
 #include "carla/client/detail/Episode.h"
 #include "carla/client/detail/EpisodeState.h"
+#include "carla/geom/Math.h"
 #include "carla/nav/Navigation.h"
 #include "carla/rpc/Command.h"
 #include "carla/rpc/DebugShape.h"
 #include "carla/rpc/WalkerControl.h"
 
+#include <algorithm>
+#include <cmath>
 #include <sstream>
 
 namespace carla {
@@ -81,27 +84,81 @@ namespace detail {
 
   }
 
-  // add/update/delete all vehicles in crowd
+  // vehicles closer than these to their last pushed transform are not updated
+  static constexpr float VEHICLE_MOVED_DISTANCE_SQUARED = 0.05f * 0.05f;
+  static constexpr float VEHICLE_ROTATED_DEGREES = 0.5f;
+
+  static bool HasVehicleMoved(const geom::Transform &previous, const geom::Transform &current) {
+    const float yaw_diff = std::fmod(std::abs(current.rotation.yaw - previous.rotation.yaw), 360.0f);
+    return
+        geom::Math::DistanceSquared(previous.location, current.location) > VEHICLE_MOVED_DISTANCE_SQUARED ||
+        std::min(yaw_diff, 360.0f - yaw_diff) > VEHICLE_ROTATED_DEGREES;
+  }
+
+  void WalkerNavigation::UpdateKnownActors(Episode &episode, const EpisodeState &state) {
+    // look for spawned actors, only these need a description
+    std::vector<ActorId> spawned;
+    for (auto id : state.GetActorIds()) {
+      if (_known_actors.find(id) == _known_actors.end()) {
+        spawned.push_back(id);
+      }
+    }
+    if (!spawned.empty()) {
+      // if the call fails they are retried on the next tick
+      const auto actors = episode.GetActorsById(spawned);
+      // actors the server does not describe anymore are not retried
+      for (auto id : spawned) {
+        _known_actors.emplace(id, false);
+      }
+      for (auto &&actor : actors) {
+        // only vehicles
+        if (actor.description.id.rfind("vehicle.", 0) == 0) {
+          _known_actors[actor.id] = true;
+          _vehicles.emplace(actor.id, VehicleObstacle{actor.bounding_box, geom::Transform{}, false});
+        }
+      }
+    }
+
+    // forget destroyed actors (vehicles are removed from the crowd in
+    // UpdateVehiclesInCrowd)
+    if (_known_actors.size() > state.size()) {
+      for (auto it = _known_actors.begin(); it != _known_actors.end();) {
+        if (state.ContainsActorSnapshot(it->first)) {
+          ++it;
+        } else {
+          it = _known_actors.erase(it);
+        }
+      }
+    }
+  }
+
+  // add/update/delete the vehicles in crowd that changed since last tick
   void WalkerNavigation::UpdateVehiclesInCrowd(std::shared_ptr<Episode> episode, bool show_debug) {
-    std::vector<carla::nav::VehicleCollisionInfo> vehicles;
 
     // get current state
     std::shared_ptr<const EpisodeState> state = episode->GetState();
 
-    // get all vehicles from episode
-    for (auto &&actor : episode->GetActors()) {
-      // only vehicles
-      if (actor.description.id.rfind("vehicle.", 0) == 0) {
-        // get the snapshot
-        ActorSnapshot snapshot = state->GetActorSnapshot(actor.id);
-        // add to the vector
-        vehicles.emplace_back(carla::nav::VehicleCollisionInfo{actor.id, snapshot.transform, actor.bounding_box});
+    UpdateKnownActors(*episode, *state);
+
+    for (auto it = _vehicles.begin(); it != _vehicles.end();) {
+      auto snapshot = state->GetActorSnapshotIfPresent(it->first);
+      if (!snapshot.has_value()) {
+        // destroyed
+        _nav.RemoveAgent(it->first);
+        it = _vehicles.erase(it);
+        continue;
+      }
+      VehicleObstacle &vehicle = it->second;
+      if (!vehicle.in_crowd || HasVehicleMoved(vehicle.transform, snapshot->transform)) {
+        carla::nav::VehicleCollisionInfo info{it->first, snapshot->transform, vehicle.bounding};
+        if (_nav.AddOrUpdateVehicle(info)) {
+          vehicle.transform = snapshot->transform;
+          vehicle.in_crowd = true;
+        }
       }
+      ++it;
     }
 
-    // update the vehicles found
-    _nav.UpdateVehicles(vehicles);
-
     // optional debug info
     if (show_debug) {
       if (_nav.GetCrowd() == nullptr) return;
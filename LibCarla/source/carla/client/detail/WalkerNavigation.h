@@ -14,6 +14,7 @@
 #include "carla/rpc/ActorId.h"
 
 #include <memory>
+#include <unordered_map>
 
 namespace carla {
 namespace client {
@@ -104,10 +105,27 @@ namespace detail {
 
     AtomicList<WalkerHandle> _walkers;
 
+    /// vehicle added to the crowd as an obstacle
+    struct VehicleObstacle {
+      geom::BoundingBox bounding;
+      /// last transform pushed to the crowd
+      geom::Transform transform;
+      bool in_crowd;
+    };
+
+    /// vehicles tracked across ticks
+    std::unordered_map<ActorId, VehicleObstacle> _vehicles;
+
+    /// actors already classified (true if it is a vehicle), used to detect
+    /// spawned and destroyed actors from the episode state
+    std::unordered_map<ActorId, bool> _known_actors;
+
     /// check a few walkers and if they don't exist then remove from the crowd
     void CheckIfWalkerExist(std::vector<WalkerHandle> walkers, const EpisodeState &state);
-    /// add/update/delete all vehicles in crowd
+    /// add/update/delete the vehicles in crowd that changed since last tick
     void UpdateVehiclesInCrowd(std::shared_ptr<Episode> episode, bool show_debug = false);
+    /// track the actors spawned and destroyed since last tick
+    void UpdateKnownActors(Episode &episode, const EpisodeState &state);
   };
 
 } // namespace detail
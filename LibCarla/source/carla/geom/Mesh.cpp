@@ -6,10 +6,16 @@
 
 #include <carla/geom/Mesh.h>
 
-#include <string>
-#include <sstream>
+#include <algorithm>
+#include <cstring>
 #include <ios>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
 
+#include <carla/Debug.h>
+#include <carla/Exception.h>
 #include <carla/geom/Math.h>
 
 namespace carla {
@@ -138,112 +144,329 @@ namespace geom {
   }
 
   std::string Mesh::GenerateOBJ() const {
+    std::ostringstream out;
+    WriteOBJ(out);
+    return out.str();
+  }
+
+  std::string Mesh::GenerateOBJForRecast() const {
+    std::ostringstream out;
+    WriteOBJForRecast(out);
+    return out.str();
+  }
+
+  std::string Mesh::GeneratePLY() const {
+    if (!IsValid()) {
+      return "Invalid Mesh";
+    }
+    std::ostringstream out;
+    WritePLY(out);
+    return out.str();
+  }
+
+  // Writes the "f" lines shared by both OBJ exporters. Faces are written as
+  // (i0, i1, i2) or, if @a flip is true, as (i0, i2, i1).
+  static void WriteOBJFaces(
+      std::ostream &out,
+      const std::vector<Mesh::index_type> &indexes,
+      const std::vector<Mesh::material_type> &materials,
+      const bool flip) {
+    out << "\n# Polygonal face element.\n";
+    auto it_m = materials.begin();
+    for (size_t i = 0u; i + 2u < indexes.size(); i += 3u) {
+      // While exist materials
+      if (it_m != materials.end()) {
+        // If the current material ends at this index
+        if (it_m->index_end == i) {
+          ++it_m;
+        }
+        // If the current material start at this index
+        if (it_m != materials.end() && it_m->index_start == i) {
+          out << "\nusemtl " << it_m->name << '\n';
+        }
+      }
+      // Add the actual face using the 3 consecutive indices. When flipped,
+      // changes the face build direction to clockwise.
+      const auto i_2 = flip ? indexes[i + 2u] : indexes[i + 1u];
+      const auto i_3 = flip ? indexes[i + 1u] : indexes[i + 2u];
+      out << "f " << indexes[i] << ' ' << i_2 << ' ' << i_3 << '\n';
+    }
+  }
+
+  void Mesh::WriteOBJ(std::ostream &out) const {
     if (!IsValid()) {
-      return "";
+      return;
     }
-    std::stringstream out;
+    const auto flags = out.flags();
     out << std::fixed; // Avoid using scientific notation
 
-    out << "# List of geometric vertices, with (x, y, z) coordinates." << std::endl;
+    out << "# List of geometric vertices, with (x, y, z) coordinates.\n";
     for (auto &v : _vertices) {
-      out << "v " << v.x << " " << v.y << " " << v.z << std::endl;
+      out << "v " << v.x << ' ' << v.y << ' ' << v.z << '\n';
     }
 
     if (!_uvs.empty()) {
-      out << std::endl << "# List of texture coordinates, in (u, v) coordinates, these will vary between 0 and 1." << std::endl;
+      out << "\n# List of texture coordinates, in (u, v) coordinates, these will vary between 0 and 1.\n";
       for (auto &vt : _uvs) {
-        out << "vt " << vt.x << " " << vt.y << std::endl;
+        out << "vt " << vt.x << ' ' << vt.y << '\n';
       }
     }
 
     if (!_normals.empty()) {
-      out << std::endl << "# List of vertex normals in (x, y, z) form; normals might not be unit vectors." << std::endl;
+      out << "\n# List of vertex normals in (x, y, z) form; normals might not be unit vectors.\n";
       for (auto &vn : _normals) {
-        out << "vn " << vn.x << " " << vn.y << " " << vn.z << std::endl;
+        out << "vn " << vn.x << ' ' << vn.y << ' ' << vn.z << '\n';
       }
     }
 
     if (!_indexes.empty()) {
-      out << std::endl << "# Polygonal face element." << std::endl;
-      auto it_m = _materials.begin();
-      auto it = _indexes.begin();
-      size_t index_counter = 0u;
-      while (it != _indexes.end()) {
-        // While exist materials
-        if (it_m != _materials.end()) {
-          // If the current material ends at this index
-          if (it_m->index_end == index_counter) {
-            ++it_m;
-          }
-          // If the current material start at this index
-          if (it_m->index_start == index_counter) {
-            out << "\nusemtl " << it_m->name << std::endl;
-          }
-        }
-
-        // Add the actual face using the 3 consecutive indices
-        out << "f " << *it; ++it;
-        out << " " << *it; ++it;
-        out << " " << *it << std::endl; ++it;
-
-        index_counter += 3;
-      }
+      WriteOBJFaces(out, _indexes, _materials, false);
     }
-
-    return out.str();
+    out.flags(flags);
   }
 
-  std::string Mesh::GenerateOBJForRecast() const {
+  void Mesh::WriteOBJForRecast(std::ostream &out) const {
     if (!IsValid()) {
-      return "";
+      return;
     }
-    std::stringstream out;
+    const auto flags = out.flags();
     out << std::fixed; // Avoid using scientific notation
 
-    out << "# List of geometric vertices, with (x, y, z) coordinates." << std::endl;
+    out << "# List of geometric vertices, with (x, y, z) coordinates.\n";
     for (auto &v : _vertices) {
       // Switched "y" and "z" for Recast library
-      out << "v " << v.x << " " << v.z << " " << v.y << std::endl;
+      out << "v " << v.x << ' ' << v.z << ' ' << v.y << '\n';
     }
 
     if (!_indexes.empty()) {
-      out << std::endl << "# Polygonal face element." << std::endl;
-      auto it_m = _materials.begin();
-      auto it = _indexes.begin();
-      size_t index_counter = 0u;
-      while (it != _indexes.end()) {
-        // While exist materials
-        if (it_m != _materials.end()) {
-          // If the current material ends at this index
-          if (it_m->index_end == index_counter) {
-            ++it_m;
-          }
-          // If the current material start at this index
-          if (it_m->index_start == index_counter) {
-            out << "\nusemtl " << it_m->name << std::endl;
-          }
-        }
-        // Add the actual face using the 3 consecutive indices
-        // Changes the face build direction to clockwise since
-        // the space has changed.
-        out << "f " << *it; ++it;
-        const auto i_2 = *it; ++it;
-        const auto i_3 = *it; ++it;
-        out << " " << i_3 << " " << i_2 << std::endl;
-        index_counter += 3;
+      // Changes the face build direction to clockwise since the space has
+      // changed.
+      WriteOBJFaces(out, _indexes, _materials, true);
+    }
+    out.flags(flags);
+  }
+
+  void Mesh::WritePLY(std::ostream &out) const {
+    if (!IsValid()) {
+      return;
+    }
+    const auto flags = out.flags();
+    out << "ply\n"
+           "format ascii 1.0\n"
+           "element vertex " << _vertices.size() << "\n"
+           "property float32 x\n"
+           "property float32 y\n"
+           "property float32 z\n"
+           "element face " << _indexes.size() / 3u << "\n"
+           "property list uint8 int32 vertex_indices\n"
+           "end_header\n";
+    out << std::fixed;
+    for (auto &v : _vertices) {
+      out << v.x << ' ' << v.y << ' ' << v.z << '\n';
+    }
+    // PLY indices are 0-based.
+    for (size_t i = 0u; i + 2u < _indexes.size(); i += 3u) {
+      out << "3 " << _indexes[i] - 1u << ' '
+          << _indexes[i + 1u] - 1u << ' '
+          << _indexes[i + 2u] - 1u << '\n';
+    }
+    out.flags(flags);
+  }
+
+  // ===========================================================================
+  // -- Binary export ----------------------------------------------------------
+  // ===========================================================================
+
+  /// Number of elements staged in memory before each write to the output
+  /// stream in the binary exporters.
+  static constexpr size_t BINARY_CHUNK_SIZE = 4096u;
+
+  template <typename T>
+  static unsigned char *WriteRaw(unsigned char *data, const T &value) {
+    std::memcpy(data, &value, sizeof(T));
+    return data + sizeof(T);
+  }
+
+  template <typename T>
+  static void WriteRaw(std::ostream &out, const T *data, size_t count) {
+    out.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(sizeof(T) * count));
+  }
+
+  /// Streams @a vertices as packed float32 triplets.
+  static void WriteBinaryVertices(
+      std::ostream &out,
+      const std::vector<Mesh::vertex_type> &vertices) {
+    std::vector<float> chunk;
+    chunk.reserve(3u * BINARY_CHUNK_SIZE);
+    for (size_t i = 0u; i < vertices.size(); i += BINARY_CHUNK_SIZE) {
+      chunk.clear();
+      const size_t end = std::min(vertices.size(), i + BINARY_CHUNK_SIZE);
+      for (size_t j = i; j < end; ++j) {
+        chunk.push_back(vertices[j].x);
+        chunk.push_back(vertices[j].y);
+        chunk.push_back(vertices[j].z);
       }
+      WriteRaw(out, chunk.data(), chunk.size());
     }
+  }
 
-    return out.str();
+  void Mesh::WriteBinaryPLY(std::ostream &out) const {
+    if (!IsValid()) {
+      return;
+    }
+    const size_t face_count = _indexes.size() / 3u;
+    out << "ply\n"
+           "format binary_little_endian 1.0\n"
+           "element vertex " << _vertices.size() << "\n"
+           "property float32 x\n"
+           "property float32 y\n"
+           "property float32 z\n"
+           "element face " << face_count << "\n"
+           "property list uint8 uint32 vertex_indices\n"
+           "end_header\n";
+
+    WriteBinaryVertices(out, _vertices);
+
+    // Each face is written as a uint8 count followed by three uint32 indices.
+    constexpr size_t face_size = sizeof(uint8_t) + 3u * sizeof(uint32_t);
+    std::vector<unsigned char> chunk(face_size * BINARY_CHUNK_SIZE);
+    for (size_t f = 0u; f < face_count; f += BINARY_CHUNK_SIZE) {
+      const size_t end = std::min(face_count, f + BINARY_CHUNK_SIZE);
+      unsigned char *it = chunk.data();
+      for (size_t j = f; j < end; ++j) {
+        it = WriteRaw(it, uint8_t(3u));
+        // PLY indices are 0-based.
+        it = WriteRaw(it, static_cast<uint32_t>(_indexes[3u * j] - 1u));
+        it = WriteRaw(it, static_cast<uint32_t>(_indexes[3u * j + 1u] - 1u));
+        it = WriteRaw(it, static_cast<uint32_t>(_indexes[3u * j + 2u] - 1u));
+      }
+      WriteRaw(out, chunk.data(), static_cast<size_t>(it - chunk.data()));
+    }
   }
 
-  std::string Mesh::GeneratePLY() const {
+  RecastGeometry Mesh::GenerateRecastGeometry() const {
+    RecastGeometry geometry;
     if (!IsValid()) {
-      return "Invalid Mesh";
+      return geometry;
     }
-    // Generate header
-    std::stringstream out;
-    return out.str();
+    geometry.vertices.reserve(3u * _vertices.size());
+    for (auto &v : _vertices) {
+      // Switched "y" and "z" for Recast library
+      geometry.vertices.push_back(v.x);
+      geometry.vertices.push_back(v.z);
+      geometry.vertices.push_back(v.y);
+    }
+    geometry.triangles.reserve(_indexes.size());
+    for (size_t i = 0u; i + 2u < _indexes.size(); i += 3u) {
+      // Clockwise faces and 0-based indices.
+      geometry.triangles.push_back(static_cast<int>(_indexes[i] - 1u));
+      geometry.triangles.push_back(static_cast<int>(_indexes[i + 2u] - 1u));
+      geometry.triangles.push_back(static_cast<int>(_indexes[i + 1u] - 1u));
+    }
+    return geometry;
+  }
+
+  // ===========================================================================
+  // -- Indexed buffer export --------------------------------------------------
+  // ===========================================================================
+
+  constexpr uint32_t Mesh::IndexedBufferMagic;
+  constexpr uint32_t Mesh::IndexedBufferVersion;
+
+  static constexpr size_t INDEXED_BUFFER_HEADER_SIZE = 4u * sizeof(uint32_t);
+
+  size_t Mesh::GetIndexedBufferSize() const {
+    return
+        INDEXED_BUFFER_HEADER_SIZE +
+        3u * sizeof(float) * _vertices.size() +
+        sizeof(uint32_t) * _indexes.size();
+  }
+
+  size_t Mesh::WriteIndexedBuffer(unsigned char *data) const {
+    DEBUG_ASSERT(data != nullptr);
+    if (!IsValid()) {
+      return 0u;
+    }
+    unsigned char *it = data;
+    it = WriteRaw(it, IndexedBufferMagic);
+    it = WriteRaw(it, IndexedBufferVersion);
+    it = WriteRaw(it, static_cast<uint32_t>(_vertices.size()));
+    it = WriteRaw(it, static_cast<uint32_t>(_indexes.size()));
+    for (auto &v : _vertices) {
+      it = WriteRaw(it, v.x);
+      it = WriteRaw(it, v.y);
+      it = WriteRaw(it, v.z);
+    }
+    for (auto index : _indexes) {
+      it = WriteRaw(it, static_cast<uint32_t>(index - 1u));
+    }
+    const auto size = static_cast<size_t>(it - data);
+    DEBUG_ASSERT(size == GetIndexedBufferSize());
+    return size;
+  }
+
+  void Mesh::WriteIndexedBuffer(std::ostream &out) const {
+    if (!IsValid()) {
+      return;
+    }
+    const uint32_t header[] = {
+        IndexedBufferMagic,
+        IndexedBufferVersion,
+        static_cast<uint32_t>(_vertices.size()),
+        static_cast<uint32_t>(_indexes.size())};
+    WriteRaw(out, header, 4u);
+    WriteBinaryVertices(out, _vertices);
+    std::vector<uint32_t> chunk;
+    chunk.reserve(BINARY_CHUNK_SIZE);
+    for (size_t i = 0u; i < _indexes.size(); i += BINARY_CHUNK_SIZE) {
+      chunk.clear();
+      const size_t end = std::min(_indexes.size(), i + BINARY_CHUNK_SIZE);
+      for (size_t j = i; j < end; ++j) {
+        chunk.push_back(static_cast<uint32_t>(_indexes[j] - 1u));
+      }
+      WriteRaw(out, chunk.data(), chunk.size());
+    }
+  }
+
+  Mesh Mesh::ReadIndexedBuffer(const unsigned char *data, const size_t size) {
+    auto read_u32 = [](const unsigned char *src) {
+      uint32_t value;
+      std::memcpy(&value, src, sizeof(value));
+      return value;
+    };
+    if (data == nullptr || size < INDEXED_BUFFER_HEADER_SIZE) {
+      throw_exception(std::invalid_argument("mesh buffer too small"));
+    }
+    if (read_u32(data) != IndexedBufferMagic ||
+        read_u32(data + 4u) != IndexedBufferVersion) {
+      throw_exception(std::invalid_argument("invalid mesh buffer header"));
+    }
+    const size_t vertex_count = read_u32(data + 8u);
+    const size_t index_count = read_u32(data + 12u);
+    const size_t expected_size =
+        INDEXED_BUFFER_HEADER_SIZE +
+        3u * sizeof(float) * vertex_count +
+        sizeof(uint32_t) * index_count;
+    if (size < expected_size) {
+      throw_exception(std::invalid_argument("mesh buffer truncated"));
+    }
+    std::vector<vertex_type> vertices;
+    vertices.reserve(vertex_count);
+    const unsigned char *it = data + INDEXED_BUFFER_HEADER_SIZE;
+    for (size_t i = 0u; i < vertex_count; ++i) {
+      float xyz[3u];
+      std::memcpy(xyz, it, sizeof(xyz));
+      it += sizeof(xyz);
+      vertices.emplace_back(xyz[0u], xyz[1u], xyz[2u]);
+    }
+    std::vector<index_type> indexes;
+    indexes.reserve(index_count);
+    for (size_t i = 0u; i < index_count; ++i) {
+      // Back to 1-based indices.
+      indexes.push_back(static_cast<index_type>(read_u32(it)) + 1u);
+      it += sizeof(uint32_t);
+    }
+    return Mesh(vertices, {}, indexes, {});
   }
 
   const std::vector<Mesh::vertex_type> &Mesh::GetVertices() const {
@@ -6,6 +6,9 @@
 
 #pragma once
 
+#include <cstdint>
+#include <ostream>
+#include <string>
 #include <vector>
 
 #include <carla/geom/Vector3D.h>
@@ -38,6 +41,24 @@ namespace geom {
 
   };
 
+  /// Vertex and triangle arrays ready to be consumed by Recast. Vertices are
+  /// packed as (x, y, z) triplets with "y" and "z" switched, triangles are
+  /// 0-based and clockwise.
+  struct RecastGeometry {
+
+    std::vector<float> vertices;
+
+    std::vector<int> triangles;
+
+    size_t GetVerticesNum() const {
+      return vertices.size() / 3u;
+    }
+
+    size_t GetTrianglesNum() const {
+      return triangles.size() / 3u;
+    }
+  };
+
   /// Mesh data container, validator and exporter.
   class Mesh {
   public:
@@ -117,6 +138,56 @@ namespace geom {
     /// Units are in meters.
     std::string GeneratePLY() const;
 
+    /// Same as GenerateOBJ but streams the output directly into @a out.
+    void WriteOBJ(std::ostream &out) const;
+
+    /// Same as GenerateOBJForRecast but streams the output directly into
+    /// @a out.
+    void WriteOBJForRecast(std::ostream &out) const;
+
+    /// Streams the mesh encoded in ASCII PLY into @a out.
+    void WritePLY(std::ostream &out) const;
+
+    /// Streams the mesh encoded in binary little-endian PLY into @a out.
+    /// Vertices are written as float32 and faces as uint32 indices.
+    void WriteBinaryPLY(std::ostream &out) const;
+
+    /// Returns the vertex and triangle arrays in the same space used by
+    /// GenerateOBJForRecast, without going through any text encoding.
+    RecastGeometry GenerateRecastGeometry() const;
+
+    // =========================================================================
+    // -- Indexed buffer export ------------------------------------------------
+    // =========================================================================
+
+    /// Compact indexed-buffer layout, all fields are little-endian:
+    ///
+    ///   uint32 magic (IndexedBufferMagic)
+    ///   uint32 version (IndexedBufferVersion)
+    ///   uint32 number of vertices
+    ///   uint32 number of indices
+    ///   float32[3 * number of vertices] vertices
+    ///   uint32[number of indices] 0-based indices
+    static constexpr uint32_t IndexedBufferMagic = 0x48534d43u; // "CMSH"
+
+    static constexpr uint32_t IndexedBufferVersion = 1u;
+
+    /// Size in bytes required by WriteIndexedBuffer.
+    size_t GetIndexedBufferSize() const;
+
+    /// Writes the mesh in the compact indexed-buffer layout into @a data,
+    /// which must hold at least GetIndexedBufferSize() bytes. Returns the
+    /// number of bytes written, or zero if the mesh is not valid.
+    size_t WriteIndexedBuffer(unsigned char *data) const;
+
+    /// Streams the mesh in the compact indexed-buffer layout into @a out.
+    void WriteIndexedBuffer(std::ostream &out) const;
+
+    /// Builds a mesh (vertices and indices only) from a buffer written by
+    /// WriteIndexedBuffer. Throws std::invalid_argument if the buffer is
+    /// malformed.
+    static Mesh ReadIndexedBuffer(const unsigned char *data, size_t size);
+
     // =========================================================================
     // -- Other methods --------------------------------------------------------
     // =========================================================================
@@ -13,9 +13,12 @@
 #include "carla/nav/WalkerManager.h"
 #include "carla/geom/Math.h"
 
+#include <algorithm>
+#include <future>
 #include <iterator>
 #include <fstream>
 #include <mutex>
+#include <thread>
 
 namespace carla {
 namespace nav {
@@ -40,6 +43,11 @@ namespace nav {
   static const float AGENT_UNBLOCK_DISTANCE_SQUARED = AGENT_UNBLOCK_DISTANCE * AGENT_UNBLOCK_DISTANCE;
   static const float AGENT_UNBLOCK_TIME = 4.0f;
 
+  // routes of blocked walkers are computed in parallel only when there are
+  // enough of them to pay for the worker threads
+  static const size_t MIN_RETARGETS_PER_WORKER = 8u;
+  static const size_t MAX_ROUTE_WORKERS = 4u;
+
   static const float AREA_GRASS_COST =  1.0f;
   static const float AREA_ROAD_COST  = 10.0f;
 
@@ -48,7 +56,8 @@ namespace nav {
     return static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
   }
 
-  Navigation::Navigation() {
+  Navigation::Navigation()
+    : _max_route_workers(MAX_ROUTE_WORKERS) {
     // assign walker manager
     _walker_manager.SetNav(this);
   }
@@ -63,6 +72,7 @@ namespace nav {
     _yaw_walkers.clear();
     _binary_mesh.clear();
     dtFreeCrowd(_crowd);
+    FreeWorkerQueries();
     dtFreeNavMeshQuery(_nav_query);
     dtFreeNavMesh(_nav_mesh);
   }
@@ -177,6 +187,7 @@ namespace nav {
     _nav_mesh = mesh;
 
     // prepare the query object
+    FreeWorkerQueries();
     dtFreeNavMeshQuery(_nav_query);
     _nav_query = dtAllocNavMeshQuery();
     _nav_query->init(_nav_mesh, MAX_QUERY_SEARCH_NODES);
@@ -364,16 +375,6 @@ namespace nav {
 
   bool Navigation::GetAgentRoute(ActorId id, carla::geom::Location from, carla::geom::Location to,
   std::vector<carla::geom::Location> &path, std::vector<unsigned char> &area) {
-    // path found
-    float straight_path[MAX_POLYS * 3];
-    unsigned char straight_path_flags[MAX_POLYS];
-    dtPolyRef straight_path_polys[MAX_POLYS];
-    int num_straight_path = 0;
-    int straight_path_options = DT_STRAIGHTPATH_AREA_CROSSINGS;
-
-    // polys in path
-    dtPolyRef polys[MAX_POLYS];
-    int num_polys;
 
     // check if all is ready
     if (!_ready) {
@@ -382,42 +383,47 @@ namespace nav {
 
     DEBUG_ASSERT(_nav_query != nullptr);
 
-    // point extension
-    float poly_pick_ext[3] = {2,4,2};
-
     // get current filter from agent
     auto it = _mapped_walkers_id.find(id);
     if (it == _mapped_walkers_id.end())
       return false;
 
-    const dtQueryFilter *filter;
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      filter = _crowd->getFilter(_crowd->getAgent(it->second)->params.queryFilterType);
-    }
+    // critical section, force single thread running this
+    std::lock_guard<std::mutex> lock(_mutex);
+    const dtQueryFilter *filter = _crowd->getFilter(_crowd->getAgent(it->second)->params.queryFilterType);
+    return ComputeRoute(*_nav_query, filter, from, to, path, area);
+  }
+
+  bool Navigation::ComputeRoute(const dtNavMeshQuery &query, const dtQueryFilter *filter,
+  carla::geom::Location from, carla::geom::Location to,
+  std::vector<carla::geom::Location> &path, std::vector<unsigned char> &area) const {
+    // path found
+    float straight_path[MAX_POLYS * 3];
+    unsigned char straight_path_flags[MAX_POLYS];
+    dtPolyRef straight_path_polys[MAX_POLYS];
+    int num_straight_path = 0;
+    int straight_path_options = DT_STRAIGHTPATH_AREA_CROSSINGS;
+
+    // polys in path
+    dtPolyRef polys[MAX_POLYS];
+    int num_polys = 0;
+
+    // point extension
+    float poly_pick_ext[3] = {2,4,2};
 
     // set the points
     dtPolyRef start_ref = 0;
     dtPolyRef end_ref = 0;
     float start_pos[3] = { from.x, from.z, from.y };
     float end_pos[3] = { to.x, to.z, to.y };
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      _nav_query->findNearestPoly(start_pos, poly_pick_ext, filter, &start_ref, 0);
-      _nav_query->findNearestPoly(end_pos, poly_pick_ext, filter, &end_ref, 0);
-    }
+    query.findNearestPoly(start_pos, poly_pick_ext, filter, &start_ref, 0);
+    query.findNearestPoly(end_pos, poly_pick_ext, filter, &end_ref, 0);
     if (!start_ref || !end_ref) {
       return false;
     }
 
     // get the path of nodes
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      _nav_query->findPath(start_ref, end_ref, start_pos, end_pos, filter, polys, &num_polys, MAX_POLYS);
-    }
+    query.findPath(start_ref, end_ref, start_pos, end_pos, filter, polys, &num_polys, MAX_POLYS);
 
     // get the path of points
     if (num_polys == 0) {
@@ -429,21 +435,16 @@ namespace nav {
     float end_pos2[3];
     dtVcopy(end_pos2, end_pos);
     if (polys[num_polys - 1] != end_ref) {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      _nav_query->closestPointOnPoly(polys[num_polys - 1], end_pos, end_pos2, 0);
+      query.closestPointOnPoly(polys[num_polys - 1], end_pos, end_pos2, 0);
     }
 
     // get the points
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      _nav_query->findStraightPath(start_pos, end_pos2, polys, num_polys,
-      straight_path, straight_path_flags,
-      straight_path_polys, &num_straight_path, MAX_POLYS, straight_path_options);
-    }
+    query.findStraightPath(start_pos, end_pos2, polys, num_polys,
+    straight_path, straight_path_flags,
+    straight_path_polys, &num_straight_path, MAX_POLYS, straight_path_options);
 
-    // copy the path to the output buffer
+    // copy the path to the output buffer (the nav mesh is only read here, so
+    // it can be shared between queries)
     path.clear();
     path.reserve(static_cast<unsigned long>(num_straight_path));
     unsigned char area_type;
@@ -451,11 +452,7 @@ namespace nav {
       // save coordinate for Unreal axis (x, z, y)
       path.emplace_back(straight_path[i], straight_path[i + 2], straight_path[i + 1]);
       // save area type
-      {
-        // critical section, force single thread running this
-        std::lock_guard<std::mutex> lock(_mutex);
-        _nav_mesh->getPolyArea(straight_path_polys[j], &area_type);
-      }
+      _nav_mesh->getPolyArea(straight_path_polys[j], &area_type);
       area.emplace_back(area_type);
     }
 
@@ -673,8 +670,8 @@ namespace nav {
       }
       _walker_manager.RemoveWalker(id);
       // remove from mapping
-      _mapped_walkers_id.erase(it);
       _mapped_by_index.erase(it->second);
+      _mapped_walkers_id.erase(it);
 
       return true;
     }
@@ -689,8 +686,8 @@ namespace nav {
         _crowd->removeAgent(it->second);
       }
       // remove from mapping
-      _mapped_vehicles_id.erase(it);
       _mapped_by_index.erase(it->second);
+      _mapped_vehicles_id.erase(it);
 
       return true;
     }
@@ -825,6 +822,10 @@ namespace nav {
 
   // update all walkers in crowd
   void Navigation::UpdateCrowd(const client::detail::EpisodeState &state) {
+    UpdateCrowd(state.GetTimestamp().delta_seconds);
+  }
+
+  void Navigation::UpdateCrowd(double delta_seconds) {
 
     // check if all is ready
     if (!_ready) {
@@ -833,82 +834,149 @@ namespace nav {
 
     DEBUG_ASSERT(_crowd != nullptr);
 
-    // update crowd agents
-    _delta_seconds = state.GetTimestamp().delta_seconds;
+    // update the time to check for blocked agents
+    _delta_seconds = delta_seconds;
+    _time_to_unblock += _delta_seconds;
+    const bool check_blocked = (_time_to_unblock >= AGENT_UNBLOCK_TIME);
+
+    // update crowd agents, and take a snapshot of the walkers in the same
+    // critical section if we need to check for blocked ones
+    _walkers_snapshot.clear();
     {
       // critical section, force single thread running this
       std::lock_guard<std::mutex> lock(_mutex);
       _crowd->update(static_cast<float>(_delta_seconds), nullptr);
+
+      if (check_blocked) {
+        const int total_agents = _crowd->getAgentCount();
+        _walkers_snapshot.reserve(static_cast<size_t>(total_agents));
+        for (int i = 0; i < total_agents; ++i) {
+          const dtCrowdAgent *ag = _crowd->getAgent(i);
+          // check only pedestrians not paused, and no vehicles
+          if (!ag->active || ag->paused || ag->params.useObb) {
+            continue;
+          }
+          _walkers_snapshot.push_back(WalkerSnapshot{
+              i,
+              carla::geom::Vector3D(ag->npos[0], ag->npos[1], ag->npos[2]),
+              _crowd->getFilter(ag->params.queryFilterType)});
+        }
+        if (_walkers_blocked_position.size() < static_cast<size_t>(total_agents)) {
+          _walkers_blocked_position.resize(static_cast<size_t>(total_agents));
+        }
+      }
     }
 
     // update the walkers route
     _walker_manager.Update(_delta_seconds);
 
-    // update the time to check for blocked agents
-    _time_to_unblock += _delta_seconds;
-
-    // check all active agents
-    int total_unblocked = 0;
-    int total_agents;
-    {
-      // critical section, force single thread running this
-      std::lock_guard<std::mutex> lock(_mutex);
-      total_agents = _crowd->getAgentCount();
+    if (!check_blocked) {
+      return;
     }
-    const dtCrowdAgent *ag;
-    for (int i = 0; i < total_agents; ++i) {
-      {
-        // critical section, force single thread running this
-        std::lock_guard<std::mutex> lock(_mutex);
-        ag = _crowd->getAgent(i);
+
+    // find the blocked walkers from the snapshot, without taking any lock
+    _walkers_retarget.clear();
+    for (const auto &walker : _walkers_snapshot) {
+      // get the distance moved by each actor
+      const auto index = static_cast<size_t>(walker.index);
+      const carla::geom::Vector3D distance = walker.position - _walkers_blocked_position[index];
+      // update with current position
+      _walkers_blocked_position[index] = walker.position;
+      if (distance.SquaredLength() >= AGENT_UNBLOCK_DISTANCE_SQUARED) {
+        continue;
       }
-      if (!ag->active || ag->paused) {
+      auto it = _mapped_by_index.find(walker.index);
+      if (it == _mapped_by_index.end()) {
         continue;
       }
+      // positions in Unreal coordinates
+      WalkerRetarget retarget;
+      retarget.id = it->second;
+      retarget.filter = walker.filter;
+      retarget.from = carla::geom::Location(walker.position.x, walker.position.z, walker.position.y);
+      _walkers_retarget.emplace_back(std::move(retarget));
+    }
+
+    if (!_walkers_retarget.empty()) {
+      // set a new random target for each one, in order to keep the sequence
+      // of random numbers deterministic
+      for (auto &retarget : _walkers_retarget) {
+        GetRandomLocation(retarget.to, nullptr);
+      }
+      // compute all the routes and assign them
+      ComputeRetargetRoutes(_walkers_retarget);
+      for (auto &retarget : _walkers_retarget) {
+        _walker_manager.SetWalkerRoute(
+            retarget.id,
+            retarget.from,
+            retarget.to,
+            retarget.path,
+            retarget.area);
+      }
+    }
 
-      // check only pedestrians not paused, and no vehicles
-      if (!ag->params.useObb && !ag->paused) {
-        bool reset_target_pos = false;
-        bool use_same_filter = false;
-
-        // check for unblocking actors
-        if (_time_to_unblock >= AGENT_UNBLOCK_TIME) {
-          // get the distance moved by each actor
-          carla::geom::Vector3D previous = _walkers_blocked_position[i];
-          carla::geom::Vector3D current = carla::geom::Vector3D(ag->npos[0], ag->npos[1], ag->npos[2]);
-          carla::geom::Vector3D distance = current - previous;
-          float d = distance.SquaredLength();
-          if (d < AGENT_UNBLOCK_DISTANCE_SQUARED) {
-            ++total_unblocked;
-            reset_target_pos = true;
-            use_same_filter = true;
-          }
-          // update with current position
-          _walkers_blocked_position[i] = current;
-
-          // check to assign a new target position
-          if (reset_target_pos) {
-            // set if the agent can cross roads or not
-            if (!use_same_filter) {
-              if (frand() <= _probability_crossing) {
-                SetAgentFilter(i, 1);
-              } else {
-                SetAgentFilter(i, 0);
-              }
-            }
-            // set a new random target
-            carla::geom::Location location;
-            GetRandomLocation(location, nullptr);
-            _walker_manager.SetWalkerRoute(_mapped_by_index[i], location);
-          }
-        }
+    // reset the time
+    _time_to_unblock = 0.0;
+  }
+
+  void Navigation::ComputeRetargetRoutes(std::vector<WalkerRetarget> &retargets) {
+    const size_t hardware_workers = std::max(1u, std::thread::hardware_concurrency());
+    size_t workers = std::min({
+        _max_route_workers,
+        hardware_workers,
+        std::max<size_t>(1u, retargets.size() / MIN_RETARGETS_PER_WORKER)});
+
+    // each worker needs its own query object, the nav mesh can be shared
+    while (_worker_queries.size() < workers) {
+      dtNavMeshQuery *query = dtAllocNavMeshQuery();
+      if (query == nullptr || dtStatusFailed(query->init(_nav_mesh, MAX_QUERY_SEARCH_NODES))) {
+        dtFreeNavMeshQuery(query);
+        break;
       }
+      _worker_queries.push_back(query);
     }
+    // use only the workers we got a query for
+    workers = std::min(workers, _worker_queries.size());
+
+    auto compute = [this, &retargets](const dtNavMeshQuery &query, size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        auto &retarget = retargets[i];
+        retarget.path.clear();
+        retarget.area.clear();
+        ComputeRoute(query, retarget.filter, retarget.from, retarget.to, retarget.path, retarget.area);
+      }
+    };
+
+    if (workers < 2u) {
+      // not worth it (or not possible) to go parallel
+      std::lock_guard<std::mutex> lock(_mutex);
+      compute(*_nav_query, 0u, retargets.size());
+      return;
+    }
+
+    const size_t chunk = (retargets.size() + workers - 1u) / workers;
+    std::vector<std::future<void>> futures;
+    futures.reserve(workers - 1u);
+    for (size_t w = 1u; w < workers; ++w) {
+      const size_t begin = std::min(retargets.size(), w * chunk);
+      const size_t end = std::min(retargets.size(), begin + chunk);
+      futures.emplace_back(std::async(std::launch::async, compute, std::cref(*_worker_queries[w]), begin, end));
+    }
+    compute(*_worker_queries[0u], 0u, std::min(retargets.size(), chunk));
+    for (auto &future : futures) {
+      future.get();
+    }
+  }
+
+  void Navigation::SetMaxRouteWorkers(size_t workers) {
+    _max_route_workers = std::max<size_t>(1u, workers);
+  }
 
-    // check for resetting time
-    if (_time_to_unblock >= AGENT_UNBLOCK_TIME) {
-      _time_to_unblock = 0.0f;
+  void Navigation::FreeWorkerQueries() {
+    for (auto query : _worker_queries) {
+      dtFreeNavMeshQuery(query);
     }
+    _worker_queries.clear();
   }
 
   // get the walker current transform
@@ -98,6 +98,8 @@ namespace nav {
     float GetWalkerSpeed(ActorId id);
     /// update all walkers in crowd
     void UpdateCrowd(const client::detail::EpisodeState &state);
+    /// update all walkers in crowd advancing the simulation @a delta_seconds
+    void UpdateCrowd(double delta_seconds);
     /// get a random location for navigation
     bool GetRandomLocation(carla::geom::Location &location, dtQueryFilter * filter = nullptr) const;
     /// set the probability that an agent could cross the roads in its path following
@@ -108,6 +110,9 @@ namespace nav {
     bool HasVehicleNear(ActorId id, float distance, carla::geom::Location direction);
     /// make agent look at some location
     bool SetWalkerLookAt(ActorId id, carla::geom::Location location);
+    /// set the maximum number of threads computing the routes of blocked
+    /// walkers, 1 computes them sequentially
+    void SetMaxRouteWorkers(size_t workers);
 
     dtCrowd *GetCrowd() { return _crowd; };
 
@@ -116,6 +121,23 @@ namespace nav {
 
   private:
 
+    /// state of an active walker copied right after the crowd update
+    struct WalkerSnapshot {
+      int index;
+      carla::geom::Vector3D position;
+      const dtQueryFilter *filter;
+    };
+
+    /// new route requested for a blocked walker
+    struct WalkerRetarget {
+      ActorId id;
+      const dtQueryFilter *filter;
+      carla::geom::Location from;
+      carla::geom::Location to;
+      std::vector<carla::geom::Location> path;
+      std::vector<unsigned char> area;
+    };
+
     bool _ready { false };
     std::vector<uint8_t> _binary_mesh;
     double _delta_seconds { 0.0 };
@@ -132,8 +154,15 @@ namespace nav {
     /// store walkers yaw angle from previous tick
     std::unordered_map<ActorId, float> _yaw_walkers;
     /// saves the position of each actor at intervals and check if any is blocked
-    std::unordered_map<int, carla::geom::Vector3D> _walkers_blocked_position;
+    /// (indexed by crowd agent index)
+    std::vector<carla::geom::Vector3D> _walkers_blocked_position;
     double _time_to_unblock { 0.0 };
+    /// scratch buffers reused between ticks for the unblock check
+    std::vector<WalkerSnapshot> _walkers_snapshot;
+    std::vector<WalkerRetarget> _walkers_retarget;
+    /// private queries used by the workers that compute routes in parallel
+    std::vector<dtNavMeshQuery *> _worker_queries;
+    size_t _max_route_workers;
 
     /// walker manager for the route planning with events
     WalkerManager _walker_manager;
@@ -144,6 +173,15 @@ namespace nav {
 
     /// assign a filter index to an agent
     void SetAgentFilter(int agent_index, int filter_index);
+    /// compute the route between two points using the given query object,
+    /// the caller must guarantee exclusive access to @a query
+    bool ComputeRoute(const dtNavMeshQuery &query, const dtQueryFilter *filter,
+    carla::geom::Location from, carla::geom::Location to,
+    std::vector<carla::geom::Location> &path, std::vector<unsigned char> &area) const;
+    /// compute the routes of all the blocked walkers, in parallel if needed
+    void ComputeRetargetRoutes(std::vector<WalkerRetarget> &retargets);
+    /// free the private queries of the route workers
+    void FreeWorkerQueries();
   };
 
 } // namespace nav
@@ -118,20 +118,37 @@ namespace nav {
         if (it == _walkers.end())
             return false;
 
-        // get it
-        WalkerInfo &info = it->second;
         std::vector<carla::geom::Location> path;
         std::vector<unsigned char> area;
 
+        // get a route from navigation
+        carla::geom::Location from = it->second.from;
+        _nav->GetWalkerPosition(id, from);
+        _nav->GetAgentRoute(id, from, to, path, area);
+
+        return SetWalkerRoute(id, from, to, path, area);
+    }
+
+    bool WalkerManager::SetWalkerRoute(ActorId id, carla::geom::Location from, carla::geom::Location to,
+    std::vector<carla::geom::Location> &path, std::vector<unsigned char> &area) {
+        // check
+        if (_nav == nullptr)
+            return false;
+
+        // search
+        auto it = _walkers.find(id);
+        if (it == _walkers.end())
+            return false;
+
+        // get it
+        WalkerInfo &info = it->second;
+
         // save both points for the route
-        _nav->GetWalkerPosition(id, info.from);
+        info.from = from;
         info.to = to;
         info.currentIndex = 0;
         info.state = WALKER_IDLE;
 
-        // get a route from navigation
-        _nav->GetAgentRoute(id, info.from, to, path, area);
-
         // create each point of the route
         info.route.clear();
         info.route.reserve(path.size());
@@ -61,6 +61,9 @@ namespace nav {
     /// set a new route from its current position
     bool SetWalkerRoute(ActorId id);
     bool SetWalkerRoute(ActorId id, carla::geom::Location to);
+    /// set a route already computed by the navigation
+    bool SetWalkerRoute(ActorId id, carla::geom::Location from, carla::geom::Location to,
+    std::vector<carla::geom::Location> &path, std::vector<unsigned char> &area);
 
     /// set the next point in the route
     bool SetWalkerNextPoint(ActorId id);
@@ -0,0 +1,282 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Debug.h"
+#include "carla/Exception.h"
+#include "carla/NonCopyable.h"
+#include "carla/geom/Transform.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace carla {
+namespace pointcloud {
+
+  /// Keeps the points of the last @a window_size semantic lidar measurements
+  /// in world frame, and downsamples them to a voxel grid.
+  ///
+  /// Thread-safe, measurements can be added from the sensor callback while
+  /// another thread reads the accumulated cloud.
+  class PointCloudAccumulator : private NonCopyable {
+  public:
+
+    /// Result of Downsample, one entry per occupied voxel sorted by voxel.
+    struct VoxelGrid {
+      /// Centroid of the points of each voxel, as x, y, z.
+      std::vector<float> points;
+      /// Most frequent tag in each voxel, the lowest tag on ties.
+      std::vector<std::uint32_t> tags;
+      /// Number of points in each voxel.
+      std::vector<std::uint32_t> counts;
+
+      size_t size() const {
+        return tags.size();
+      }
+    };
+
+    explicit PointCloudAccumulator(size_t window_size = 10u)
+      : _window_size(std::max<size_t>(window_size, 1u)) {}
+
+    size_t GetWindowSize() const {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _window_size;
+    }
+
+    /// Change the number of measurements kept, dropping the oldest ones if
+    /// necessary.
+    void SetWindowSize(size_t window_size) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _window_size = std::max<size_t>(window_size, 1u);
+      while (_frames.size() > _window_size) {
+        _frames.pop_front();
+      }
+    }
+
+    size_t GetNumberOfFrames() const {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _frames.size();
+    }
+
+    size_t GetNumberOfPoints() const {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return CountPoints();
+    }
+
+    void Clear() {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _frames.clear();
+    }
+
+    /// Add the detections of a measurement taken with the sensor at
+    /// @a sensor_transform. PointIt must point to detections with "point" and
+    /// "object_tag" members, as sensor::data::SemanticLidarDetection.
+    template <typename PointIt>
+    void Add(const geom::Transform &sensor_transform, PointIt begin, PointIt end);
+
+    /// Copy the accumulated points, from the oldest measurement to the
+    /// newest, into @a xyz (3 floats per point) and @a tags.
+    void CopyPoints(float *xyz, std::uint32_t *tags) const;
+
+    /// Same as above, resizing @a xyz and @a tags to fit the points.
+    void CopyPoints(std::vector<float> &xyz, std::vector<std::uint32_t> &tags) const;
+
+    /// Downsample the accumulated points to a grid of cubic voxels of
+    /// @a voxel_size side.
+    ///
+    /// @throw std::invalid_argument if a point is more than 2^20 voxels away
+    /// from the origin on any axis.
+    VoxelGrid Downsample(float voxel_size) const;
+
+    /// Apply @a transform to the points in [begin, end), writing them into
+    /// @a xyz. The matrix is computed once, the loop is left to the compiler
+    /// to vectorize.
+    template <typename PointIt>
+    static void TransformPoints(const geom::Transform &transform, PointIt begin, PointIt end, float *xyz);
+
+  private:
+
+    struct Frame {
+      std::vector<float> xyz;
+      std::vector<std::uint32_t> tags;
+
+      size_t size() const {
+        return tags.size();
+      }
+    };
+
+    size_t CountPoints() const {
+      size_t count = 0u;
+      for (const auto &frame : _frames) {
+        count += frame.size();
+      }
+      return count;
+    }
+
+    mutable std::mutex _mutex;
+
+    size_t _window_size;
+
+    std::deque<Frame> _frames;
+  };
+
+  // ===========================================================================
+  // -- PointCloudAccumulator implementation -----------------------------------
+  // ===========================================================================
+
+  template <typename PointIt>
+  inline void PointCloudAccumulator::TransformPoints(
+      const geom::Transform &transform,
+      PointIt begin,
+      PointIt end,
+      float *xyz) {
+    const auto m = transform.GetMatrix();
+    for (; begin != end; ++begin, xyz += 3) {
+      const float x = begin->point.x;
+      const float y = begin->point.y;
+      const float z = begin->point.z;
+      xyz[0] = m[0] * x + m[1] * y + m[2] * z + m[3];
+      xyz[1] = m[4] * x + m[5] * y + m[6] * z + m[7];
+      xyz[2] = m[8] * x + m[9] * y + m[10] * z + m[11];
+    }
+  }
+
+  template <typename PointIt>
+  inline void PointCloudAccumulator::Add(
+      const geom::Transform &sensor_transform,
+      PointIt begin,
+      PointIt end) {
+    DEBUG_ASSERT(std::distance(begin, end) >= 0);
+    const auto count = static_cast<size_t>(std::distance(begin, end));
+    Frame frame;
+    {
+      // Reuse the buffers of the measurement that leaves the window.
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_frames.size() >= _window_size) {
+        frame = std::move(_frames.front());
+        _frames.pop_front();
+      }
+    }
+    frame.xyz.resize(3u * count);
+    frame.tags.resize(count);
+    TransformPoints(sensor_transform, begin, end, frame.xyz.data());
+    std::transform(begin, end, frame.tags.begin(), [](const auto &detection) {
+      return static_cast<std::uint32_t>(detection.object_tag);
+    });
+    std::lock_guard<std::mutex> lock(_mutex);
+    _frames.emplace_back(std::move(frame));
+    while (_frames.size() > _window_size) {
+      _frames.pop_front();
+    }
+  }
+
+  inline void PointCloudAccumulator::CopyPoints(float *xyz, std::uint32_t *tags) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const auto &frame : _frames) {
+      xyz = std::copy(frame.xyz.begin(), frame.xyz.end(), xyz);
+      tags = std::copy(frame.tags.begin(), frame.tags.end(), tags);
+    }
+  }
+
+  inline void PointCloudAccumulator::CopyPoints(
+      std::vector<float> &xyz,
+      std::vector<std::uint32_t> &tags) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    const size_t count = CountPoints();
+    xyz.resize(3u * count);
+    tags.resize(count);
+    auto xyz_it = xyz.begin();
+    auto tags_it = tags.begin();
+    for (const auto &frame : _frames) {
+      xyz_it = std::copy(frame.xyz.begin(), frame.xyz.end(), xyz_it);
+      tags_it = std::copy(frame.tags.begin(), frame.tags.end(), tags_it);
+    }
+  }
+
+  inline PointCloudAccumulator::VoxelGrid PointCloudAccumulator::Downsample(const float voxel_size) const {
+    if (!(voxel_size > 0.0f)) {
+      throw_exception(std::invalid_argument("voxel size must be greater than zero"));
+    }
+    // Each voxel coordinate is stored in 21 bits of the key, centered at
+    // zero, so at 1 cm voxels the grid spans about 20 km.
+    constexpr std::int64_t offset = std::int64_t(1) << 20;
+    constexpr std::uint64_t mask = (std::uint64_t(1) << 21) - 1u;
+    const double inverse = 1.0 / static_cast<double>(voxel_size);
+    auto coordinate = [=](float value) {
+      const double index = std::floor(static_cast<double>(value) * inverse);
+      // Also rejects NaN.
+      if (!((index >= -static_cast<double>(offset)) && (index < static_cast<double>(offset)))) {
+        throw_exception(std::invalid_argument("point out of the voxel grid range"));
+      }
+      return static_cast<std::uint64_t>(static_cast<std::int64_t>(index) + offset) & mask;
+    };
+
+    struct Entry {
+      std::uint64_t key;
+      std::uint32_t tag;
+      std::uint32_t frame;
+      std::uint32_t index;
+    };
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::vector<Entry> entries;
+    entries.reserve(CountPoints());
+    for (auto f = 0u; f < _frames.size(); ++f) {
+      const auto &frame = _frames[f];
+      for (auto i = 0u; i < frame.size(); ++i) {
+        const float *p = frame.xyz.data() + 3u * i;
+        const std::uint64_t key =
+            (coordinate(p[0]) << 42u) | (coordinate(p[1]) << 21u) | coordinate(p[2]);
+        entries.push_back(Entry{key, frame.tags[i], f, i});
+      }
+    }
+    // Sorting by key and tag leaves the points of each voxel together, and
+    // the points of each tag together inside the voxel.
+    std::sort(entries.begin(), entries.end(), [](const Entry &lhs, const Entry &rhs) {
+      return (lhs.key < rhs.key) || ((lhs.key == rhs.key) && (lhs.tag < rhs.tag));
+    });
+
+    VoxelGrid result;
+    for (auto it = entries.begin(); it != entries.end();) {
+      double sum[3u] = {0.0, 0.0, 0.0};
+      std::uint32_t count = 0u;
+      std::uint32_t best_tag = it->tag;
+      std::uint32_t best_count = 0u;
+      const auto key = it->key;
+      while ((it != entries.end()) && (it->key == key)) {
+        const auto tag = it->tag;
+        std::uint32_t tag_count = 0u;
+        for (; (it != entries.end()) && (it->key == key) && (it->tag == tag); ++it) {
+          const float *p = _frames[it->frame].xyz.data() + 3u * it->index;
+          sum[0u] += p[0u];
+          sum[1u] += p[1u];
+          sum[2u] += p[2u];
+          ++tag_count;
+        }
+        if (tag_count > best_count) {
+          best_tag = tag;
+          best_count = tag_count;
+        }
+        count += tag_count;
+      }
+      for (auto i = 0u; i < 3u; ++i) {
+        result.points.emplace_back(static_cast<float>(sum[i] / count));
+      }
+      result.tags.emplace_back(best_tag);
+      result.counts.emplace_back(count);
+    }
+    return result;
+  }
+
+} // namespace pointcloud
+} // namespace carla
@@ -6,44 +6,190 @@
 
 #pragma once
 
+#include "carla/Debug.h"
+#include "carla/Exception.h"
 #include "carla/FileSystem.h"
 
+#include <boost/predef/other/endian.h>
+
 #include <fstream>
 #include <iterator>
 #include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#ifndef LIBCARLA_POINTCLOUD_WITH_ZLIB_SUPPORT
+#  if defined(__has_include) && __has_include("zlib.h")
+#    define LIBCARLA_POINTCLOUD_WITH_ZLIB_SUPPORT true
+#  else
+#    define LIBCARLA_POINTCLOUD_WITH_ZLIB_SUPPORT false
+#  endif
+#endif
+
+#if LIBCARLA_POINTCLOUD_WITH_ZLIB_SUPPORT == true
+#  include <zlib.h>
+#endif
 
 namespace carla {
 namespace pointcloud {
 
+  enum class PointCloudFormat {
+    /// Human readable PLY.
+    Ascii,
+    /// PLY with the detections stored as they are in memory.
+    BinaryLittleEndian,
+    /// Binary PLY compressed with gzip (".ply.gz").
+    Compressed
+  };
+
   class PointCloudIO {
 
   public:
+
+    static constexpr bool has_zlib_support() {
+      return LIBCARLA_POINTCLOUD_WITH_ZLIB_SUPPORT;
+    }
+
     template <typename PointIt>
     static void Dump(std::ostream &out, PointIt begin, PointIt end) {
-      WriteHeader(out, begin, end);
+      WriteHeader(out, begin, end, "ascii");
+      out << std::fixed << std::setprecision(4u);
       for (; begin != end; ++begin) {
         begin->WriteDetection(out);
         out << '\n';
       }
     }
 
+    /// Write a binary little-endian PLY. The properties declared by the point
+    /// type must match its memory layout. If the points are contiguous they
+    /// are written with a single call.
     template <typename PointIt>
-    static std::string SaveToDisk(std::string path, PointIt begin, PointIt end) {
-      FileSystem::ValidateFilePath(path, ".ply");
-      std::ofstream out(path);
-      Dump(out, begin, end);
+    static void DumpBinary(std::ostream &out, PointIt begin, PointIt end) {
+      WriteHeader(out, begin, end, "binary_little_endian");
+      WriteBinary(out, begin, end);
+    }
+
+    template <typename PointIt>
+    static std::string SaveToDisk(
+        std::string path,
+        PointIt begin,
+        PointIt end,
+        PointCloudFormat format = PointCloudFormat::Ascii) {
+      FileSystem::ValidateFilePath(path, GetExtension(format));
+      switch (format) {
+        case PointCloudFormat::Ascii: {
+          std::ofstream out(path);
+          Dump(out, begin, end);
+          break;
+        }
+        case PointCloudFormat::BinaryLittleEndian: {
+          std::ofstream out(path, std::ios::binary);
+          DumpBinary(out, begin, end);
+          break;
+        }
+        case PointCloudFormat::Compressed: {
+          std::ostringstream header;
+          WriteHeader(header, begin, end, "binary_little_endian");
+          WriteCompressed(path, header.str(), begin, end);
+          break;
+        }
+      }
       return path;
     }
 
+    static const char *GetExtension(PointCloudFormat format) {
+      return format == PointCloudFormat::Compressed ? ".ply.gz" : ".ply";
+    }
+
   private:
-    template <typename PointIt> static void WriteHeader(std::ostream &out, PointIt begin, PointIt end) {
+
+    template <typename PointIt>
+    static void WriteHeader(std::ostream &out, PointIt begin, PointIt end, const char *format) {
       DEBUG_ASSERT(std::distance(begin, end) >= 0);
       out << "ply\n"
-           "format ascii 1.0\n"
+           "format " << format << " 1.0\n"
            "element vertex " << std::to_string(static_cast<size_t>(std::distance(begin, end))) << "\n";
-      begin->WritePlyHeaderInfo(out);
+      if (begin != end) {
+        begin->WritePlyHeaderInfo(out);
+      } else {
+        typename std::iterator_traits<PointIt>::value_type{}.WritePlyHeaderInfo(out);
+      }
       out << "\nend_header\n";
-      out << std::fixed << std::setprecision(4u);
+    }
+
+    template <typename T>
+    static void CheckBinaryLayout() {
+      static_assert(std::is_trivially_copyable<T>::value, "Point type must be trivially copyable");
+#if BOOST_ENDIAN_BIG_BYTE
+      static_assert(sizeof(T) == 0u, "Binary point clouds require a little-endian platform");
+#endif
+    }
+
+    /// Contiguous points, a single write.
+    template <typename T>
+    static void WriteBinary(std::ostream &out, const T *begin, const T *end) {
+      CheckBinaryLayout<T>();
+      out.write(
+          reinterpret_cast<const char *>(begin),
+          static_cast<std::streamsize>(sizeof(T) * static_cast<size_t>(end - begin)));
+    }
+
+    template <typename T>
+    static void WriteBinary(std::ostream &out, T *begin, T *end) {
+      WriteBinary(out, static_cast<const T *>(begin), static_cast<const T *>(end));
+    }
+
+    template <typename PointIt>
+    static void WriteBinary(std::ostream &out, PointIt begin, PointIt end) {
+      using T = typename std::iterator_traits<PointIt>::value_type;
+      CheckBinaryLayout<T>();
+      for (; begin != end; ++begin) {
+        const T &point = *begin;
+        out.write(reinterpret_cast<const char *>(&point), sizeof(T));
+      }
+    }
+
+    template <typename PointIt>
+    static void WriteCompressed(
+        const std::string &path,
+        const std::string &header,
+        PointIt begin,
+        PointIt end) {
+#if LIBCARLA_POINTCLOUD_WITH_ZLIB_SUPPORT == true
+      using T = typename std::iterator_traits<PointIt>::value_type;
+      CheckBinaryLayout<T>();
+      // Copy the points only if they are not already contiguous.
+      std::vector<T> copy;
+      const T *data = nullptr;
+      const size_t count = static_cast<size_t>(std::distance(begin, end));
+      if (std::is_pointer<PointIt>::value) {
+        data = count > 0u ? &*begin : nullptr;
+      } else {
+        copy.assign(begin, end);
+        data = copy.data();
+      }
+      // Favour speed over ratio to keep up with the rate of the sensor.
+      gzFile file = gzopen(path.c_str(), "wb1");
+      if (file == nullptr) {
+        throw_exception(std::runtime_error(path + ": cannot open file for writing"));
+      }
+      bool ok = gzwrite(file, header.data(), static_cast<unsigned>(header.size())) > 0;
+      const size_t bytes = sizeof(T) * count;
+      if (ok && (bytes > 0u)) {
+        ok = gzwrite(file, data, static_cast<unsigned>(bytes)) == static_cast<int>(bytes);
+      }
+      if ((gzclose(file) != Z_OK) || !ok) {
+        throw_exception(std::runtime_error(path + ": error writing compressed point cloud"));
+      }
+#else
+      (void)header;
+      (void)begin;
+      (void)end;
+      throw_exception(std::runtime_error(
+          path + ": compressed point clouds require LibCarla built with zlib support"));
+#endif // LIBCARLA_POINTCLOUD_WITH_ZLIB_SUPPORT
     }
   };
 
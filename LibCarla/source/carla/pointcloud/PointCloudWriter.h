@@ -0,0 +1,98 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Logging.h"
+#include "carla/NonCopyable.h"
+#include "carla/ThreadPool.h"
+#include "carla/pointcloud/PointCloudIO.h"
+
+#include <condition_variable>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <vector>
+
+namespace carla {
+namespace pointcloud {
+
+  /// Writes point clouds to disk in a background thread, in the order they
+  /// were queued. The points are copied (or moved) into the queue, so the
+  /// caller can release its sensor data right away.
+  ///
+  /// At most @a max_pending writes are queued, further calls block until
+  /// there is room, so a slow disk slows down the producer instead of
+  /// exhausting the memory.
+  class PointCloudWriter : private NonCopyable {
+  public:
+
+    explicit PointCloudWriter(size_t max_pending = 32u)
+      : _max_pending(max_pending > 0u ? max_pending : 1u) {
+      _pool.AsyncRun(1u);
+    }
+
+    /// Waits for the pending writes.
+    ~PointCloudWriter() {
+      Flush();
+    }
+
+    /// Queue @a points to be written to @a path. Returns the path of the file
+    /// as SaveToDisk would, the file is complete after Flush.
+    template <typename PointT>
+    std::string Write(std::string path, std::vector<PointT> points, PointCloudFormat format) {
+      FileSystem::ValidateFilePath(path, PointCloudIO::GetExtension(format));
+      {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _condition.wait(lock, [this]() { return _pending < _max_pending; });
+        ++_pending;
+      }
+      _pool.Post([this, path, points=std::move(points), format]() {
+        try {
+          PointCloudIO::SaveToDisk(path, points.data(), points.data() + points.size(), format);
+        } catch (const std::exception &e) {
+          log_error("failed to save point cloud:", e.what());
+        }
+        std::lock_guard<std::mutex> lock(_mutex);
+        --_pending;
+        _condition.notify_all();
+      });
+      return path;
+    }
+
+    template <typename PointIt>
+    std::string Write(std::string path, PointIt begin, PointIt end, PointCloudFormat format) {
+      using PointT = typename std::iterator_traits<PointIt>::value_type;
+      return Write(std::move(path), std::vector<PointT>(begin, end), format);
+    }
+
+    /// Block until every queued point cloud has been written.
+    void Flush() {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _condition.wait(lock, [this]() { return _pending == 0u; });
+    }
+
+    size_t GetNumberOfPendingWrites() const {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _pending;
+    }
+
+  private:
+
+    const size_t _max_pending;
+
+    mutable std::mutex _mutex;
+
+    std::condition_variable _condition;
+
+    size_t _pending = 0u;
+
+    /// Declared last so its thread is joined before the rest is destroyed.
+    ThreadPool _pool;
+  };
+
+} // namespace pointcloud
+} // namespace carla
@@ -6,8 +6,12 @@
 
 #pragma once
 
+#include "carla/profiler/Tracer.h"
+
+// Without LIBCARLA_ENABLE_PROFILER the profiled scopes are still recorded by
+// the tracer when it is enabled at runtime.
 #ifndef LIBCARLA_ENABLE_PROFILER
-#  define CARLA_PROFILE_SCOPE(context, profiler_name)
+#  define CARLA_PROFILE_SCOPE(context, profiler_name) CARLA_TRACE_SCOPE(context, profiler_name)
 #  define CARLA_PROFILE_FPS(context, profiler_name)
 #else
 
@@ -104,7 +108,8 @@ namespace detail {
     static thread_local ::carla::profiler::detail::ProfilerData carla_profiler_ ## context ## _ ## profiler_name ## _data( \
         LIBCARLA_GTEST_GET_TEST_NAME() + "." #context "." #profiler_name); \
     ::carla::profiler::detail::ScopedProfiler carla_profiler_ ## context ## _ ## profiler_name ## _scoped_profiler( \
-        carla_profiler_ ## context ## _ ## profiler_name ## _data);
+        carla_profiler_ ## context ## _ ## profiler_name ## _data); \
+    CARLA_TRACE_SCOPE(context, profiler_name)
 
 #define CARLA_PROFILE_FPS(context, profiler_name) \
     { \
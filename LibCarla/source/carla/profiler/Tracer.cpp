@@ -0,0 +1,321 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/profiler/Tracer.h"
+
+#include "carla/Exception.h"
+#include "carla/NonCopyable.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace carla {
+namespace profiler {
+namespace detail {
+
+  std::atomic<bool> TRACING_ENABLED{false};
+
+  static std::atomic<std::uint64_t> CURRENT_FRAME{0u};
+
+  struct TraceEvent {
+    const char *category;
+    const char *name;
+    std::int64_t begin_ns;
+    /// Negative for frame markers.
+    std::int64_t end_ns;
+    std::uint64_t frame;
+  };
+
+  /// Events of a single thread, the oldest are overwritten when full.
+  class ThreadTrace : private NonCopyable {
+  public:
+
+    explicit ThreadTrace(std::uint32_t id) : _id(id) {}
+
+    void Reset(size_t capacity) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _events.clear();
+      _events.shrink_to_fit();
+      _capacity = std::max<size_t>(capacity, 1u);
+      _count = 0u;
+    }
+
+    void Add(const TraceEvent &event) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_events.size() < _capacity) {
+        _events.emplace_back(event);
+      } else {
+        _events[_count % _capacity] = event;
+      }
+      ++_count;
+    }
+
+    void SetName(std::string name) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _name = std::move(name);
+    }
+
+    size_t size() const {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _events.size();
+    }
+
+    void Close() {
+      _closed = true;
+    }
+
+    bool IsClosed() const {
+      return _closed;
+    }
+
+    template <typename FunctorT>
+    void ForEach(FunctorT &&functor) const {
+      std::lock_guard<std::mutex> lock(_mutex);
+      for (const auto &event : _events) {
+        functor(event);
+      }
+    }
+
+    std::string GetName() const {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _name;
+    }
+
+    std::uint32_t GetId() const {
+      return _id;
+    }
+
+  private:
+
+    mutable std::mutex _mutex;
+
+    const std::uint32_t _id;
+
+    std::string _name;
+
+    std::vector<TraceEvent> _events;
+
+    size_t _capacity = Tracer::DefaultEventsPerThread;
+
+    size_t _count = 0u;
+
+    std::atomic<bool> _closed{false};
+  };
+
+  /// Trace of the calling thread, closed when the thread exits.
+  struct ThreadTraceHolder {
+    ~ThreadTraceHolder() {
+      if (trace != nullptr) {
+        trace->Close();
+      }
+    }
+
+    std::shared_ptr<ThreadTrace> trace;
+  };
+
+  static thread_local ThreadTraceHolder THREAD_TRACE;
+
+  class TraceRegistry : private NonCopyable {
+  public:
+
+    static TraceRegistry &Get() {
+      static TraceRegistry registry;
+      return registry;
+    }
+
+    ThreadTrace &GetThreadTrace() {
+      if (THREAD_TRACE.trace == nullptr) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        THREAD_TRACE.trace = std::make_shared<ThreadTrace>(++_thread_count);
+        THREAD_TRACE.trace->Reset(_events_per_thread);
+        _traces.emplace_back(THREAD_TRACE.trace);
+      }
+      return *THREAD_TRACE.trace;
+    }
+
+    /// Discard every event, and the traces of the threads that exited.
+    void Reset(size_t events_per_thread) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _events_per_thread = events_per_thread;
+      _traces.erase(
+          std::remove_if(_traces.begin(), _traces.end(), [](const auto &trace) { return trace->IsClosed(); }),
+          _traces.end());
+      for (auto &trace : _traces) {
+        trace->Reset(_events_per_thread);
+      }
+      _origin_ns = Tracer::Now();
+    }
+
+    std::vector<std::shared_ptr<ThreadTrace>> GetTraces() const {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _traces;
+    }
+
+    size_t GetEventsPerThread() const {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _events_per_thread;
+    }
+
+    std::int64_t GetOrigin() const {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _origin_ns;
+    }
+
+  private:
+
+    TraceRegistry() = default;
+
+    mutable std::mutex _mutex;
+
+    std::vector<std::shared_ptr<ThreadTrace>> _traces;
+
+    std::uint32_t _thread_count = 0u;
+
+    size_t _events_per_thread = Tracer::DefaultEventsPerThread;
+
+    std::int64_t _origin_ns = Tracer::Now();
+  };
+
+  static void WriteJsonString(std::ostream &out, const char *str) {
+    out << '"';
+    for (; *str != '\0'; ++str) {
+      const char c = *str;
+      if ((c == '"') || (c == '\\')) {
+        out << '\\' << c;
+      } else if (static_cast<unsigned char>(c) < 0x20u) {
+        out << ' ';
+      } else {
+        out << c;
+      }
+    }
+    out << '"';
+  }
+
+  /// Chrome trace timestamps are in microseconds.
+  static void WriteMicroseconds(std::ostream &out, std::int64_t ns) {
+    const bool negative = ns < 0;
+    const auto abs_ns = negative ? -ns : ns;
+    out << (negative ? "-" : "") << (abs_ns / 1000) << '.'
+        << std::setfill('0') << std::setw(3) << (abs_ns % 1000) << std::setfill(' ');
+  }
+
+} // namespace detail
+
+  const size_t Tracer::DefaultEventsPerThread = 1u << 16u;
+
+  void Tracer::Enable(size_t events_per_thread) {
+    detail::TRACING_ENABLED = false;
+    detail::TraceRegistry::Get().Reset(events_per_thread);
+    detail::TRACING_ENABLED = true;
+  }
+
+  void Tracer::Disable() {
+    detail::TRACING_ENABLED = false;
+  }
+
+  void Tracer::MarkFrame(std::uint64_t frame) {
+    detail::CURRENT_FRAME.store(frame, std::memory_order_relaxed);
+    if (IsEnabled()) {
+      detail::TraceRegistry::Get().GetThreadTrace().Add(
+          detail::TraceEvent{"frame", "frame", Now(), -1, frame});
+    }
+  }
+
+  void Tracer::SetThreadName(std::string name) {
+    detail::TraceRegistry::Get().GetThreadTrace().SetName(std::move(name));
+  }
+
+  void Tracer::Clear() {
+    const bool enabled = detail::TRACING_ENABLED.exchange(false);
+    auto &registry = detail::TraceRegistry::Get();
+    registry.Reset(registry.GetEventsPerThread());
+    detail::TRACING_ENABLED = enabled;
+  }
+
+  size_t Tracer::GetNumberOfEvents() {
+    size_t count = 0u;
+    for (const auto &trace : detail::TraceRegistry::Get().GetTraces()) {
+      count += trace->size();
+    }
+    return count;
+  }
+
+  void Tracer::Record(
+      const char *category,
+      const char *name,
+      std::int64_t begin_ns,
+      std::int64_t end_ns) {
+    detail::TraceRegistry::Get().GetThreadTrace().Add(detail::TraceEvent{
+        category,
+        name,
+        begin_ns,
+        end_ns,
+        detail::CURRENT_FRAME.load(std::memory_order_relaxed)});
+  }
+
+  void Tracer::ExportChromeTrace(std::ostream &out) {
+    using namespace detail;
+    const auto &registry = TraceRegistry::Get();
+    const auto origin = registry.GetOrigin();
+    bool first = true;
+    auto separator = [&]() {
+      out << (first ? "\n" : ",\n");
+      first = false;
+    };
+    out << "{\"traceEvents\":[";
+    for (const auto &trace : registry.GetTraces()) {
+      const auto tid = trace->GetId();
+      const auto name = trace->GetName();
+      if (!name.empty()) {
+        separator();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid << ",\"args\":{\"name\":";
+        WriteJsonString(out, name.c_str());
+        out << "}}";
+      }
+      trace->ForEach([&](const TraceEvent &event) {
+        separator();
+        out << "{\"name\":";
+        WriteJsonString(out, event.name);
+        out << ",\"cat\":";
+        WriteJsonString(out, event.category);
+        if (event.end_ns < 0) {
+          out << ",\"ph\":\"i\",\"s\":\"g\",\"ts\":";
+          WriteMicroseconds(out, event.begin_ns - origin);
+        } else {
+          out << ",\"ph\":\"X\",\"ts\":";
+          WriteMicroseconds(out, event.begin_ns - origin);
+          out << ",\"dur\":";
+          WriteMicroseconds(out, event.end_ns - event.begin_ns);
+        }
+        out << ",\"pid\":1,\"tid\":" << tid << ",\"args\":{\"frame\":" << event.frame << "}}";
+      });
+    }
+    out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+  }
+
+  std::string Tracer::ExportChromeTrace() {
+    std::ostringstream out;
+    ExportChromeTrace(out);
+    return out.str();
+  }
+
+  std::string Tracer::SaveChromeTrace(std::string path) {
+    std::ofstream out(path);
+    if (!out) {
+      throw_exception(std::runtime_error(path + ": cannot open file for writing"));
+    }
+    ExportChromeTrace(out);
+    return path;
+  }
+
+} // namespace profiler
+} // namespace carla
@@ -0,0 +1,120 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+namespace carla {
+namespace profiler {
+
+namespace detail {
+
+  extern std::atomic<bool> TRACING_ENABLED;
+
+} // namespace detail
+
+  /// Records the time spent in the scopes marked with CARLA_TRACE_SCOPE, in
+  /// every thread, and exports them in the Chrome trace event format. The
+  /// result can be opened with chrome://tracing or https://ui.perfetto.dev.
+  ///
+  /// Each thread keeps its events in its own ring buffer, so only the last
+  /// events of each thread are kept. The lock of each buffer is only
+  /// contended while exporting. When tracing is disabled a trace point
+  /// costs an atomic load.
+  class Tracer {
+  public:
+
+    static const size_t DefaultEventsPerThread;
+
+    /// Start a new trace, discarding the events of the previous one.
+    static void Enable(size_t events_per_thread = DefaultEventsPerThread);
+
+    /// Stop recording, the events are kept until the next trace starts.
+    static void Disable();
+
+    static bool IsEnabled() {
+      return detail::TRACING_ENABLED.load(std::memory_order_relaxed);
+    }
+
+    /// Mark the start of a simulation frame. The scopes recorded afterwards
+    /// are tagged with this frame number.
+    static void MarkFrame(std::uint64_t frame);
+
+    /// Name shown for the calling thread in the trace.
+    static void SetThreadName(std::string name);
+
+    static void Clear();
+
+    /// Number of events currently stored.
+    static size_t GetNumberOfEvents();
+
+    static void ExportChromeTrace(std::ostream &out);
+
+    static std::string ExportChromeTrace();
+
+    /// Write the trace to @a path, returns the path.
+    static std::string SaveChromeTrace(std::string path);
+
+    /// Nanoseconds of the clock used by the trace events.
+    static std::int64_t Now() {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /// Record a scope of the calling thread. @a category and @a name must
+    /// outlive the trace, usually they are string literals.
+    static void Record(
+        const char *category,
+        const char *name,
+        std::int64_t begin_ns,
+        std::int64_t end_ns);
+  };
+
+  /// Records the lifetime of this object if tracing is enabled on
+  /// construction.
+  class ScopedTrace {
+  public:
+
+    ScopedTrace(const char *category, const char *name)
+      : _category(category),
+        _name(name),
+        _begin(Tracer::IsEnabled() ? Tracer::Now() : -1) {}
+
+    ~ScopedTrace() {
+      if (_begin >= 0) {
+        Tracer::Record(_category, _name, _begin, Tracer::Now());
+      }
+    }
+
+    ScopedTrace(const ScopedTrace &) = delete;
+    ScopedTrace &operator=(const ScopedTrace &) = delete;
+
+  private:
+
+    const char *_category;
+
+    const char *_name;
+
+    const std::int64_t _begin;
+  };
+
+} // namespace profiler
+} // namespace carla
+
+#ifdef LIBCARLA_DISABLE_TRACING
+#  define CARLA_TRACE_SCOPE(context, name)
+#  define CARLA_TRACE_FRAME(frame)
+#else
+#  define CARLA_TRACE_SCOPE(context, name) \
+      ::carla::profiler::ScopedTrace carla_trace_ ## context ## _ ## name(#context, #name);
+#  define CARLA_TRACE_FRAME(frame) \
+      ::carla::profiler::Tracer::MarkFrame(frame);
+#endif // LIBCARLA_DISABLE_TRACING
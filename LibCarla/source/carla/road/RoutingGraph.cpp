@@ -0,0 +1,942 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/road/RoutingGraph.h"
+
+#include "carla/Debug.h"
+#include "carla/Exception.h"
+#include "carla/road/Map.h"
+#include "carla/road/element/RoadInfoSpeed.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace carla {
+namespace road {
+
+  using NodeId = uint32_t;
+
+  static constexpr uint32_t ROUTING_GRAPH_MAGIC = 0x47545243u; // "CRTG"
+  static constexpr uint32_t ROUTING_GRAPH_VERSION = 2u;
+
+  static constexpr double EPSILON = 10.0 * std::numeric_limits<double>::epsilon();
+
+  static constexpr double INF = std::numeric_limits<double>::infinity();
+
+  /// Maximum number of nodes settled by a witness search before giving up and
+  /// adding the shortcut.
+  static constexpr size_t WITNESS_SETTLE_LIMIT = 500u;
+
+  // ===========================================================================
+  // -- Static local methods ---------------------------------------------------
+  // ===========================================================================
+
+  static uint64_t MakeKey(RoadId road_id, SectionId section_id, LaneId lane_id) {
+    return (static_cast<uint64_t>(road_id) << 32u) |
+           (static_cast<uint64_t>(section_id & 0xFFFFu) << 16u) |
+           static_cast<uint64_t>(static_cast<uint16_t>(lane_id));
+  }
+
+  static uint64_t MakeKey(const element::Waypoint &waypoint) {
+    return MakeKey(waypoint.road_id, waypoint.section_id, waypoint.lane_id);
+  }
+
+  static bool CompareByKey(const element::Waypoint &lhs, const element::Waypoint &rhs) {
+    return MakeKey(lhs) < MakeKey(rhs);
+  }
+
+  /// Entry waypoint of every drivable lane of the topology, sorted by key.
+  static std::vector<element::Waypoint> CollectLanes(const Map &map) {
+    std::vector<element::Waypoint> result;
+    for (auto &&pair : map.GenerateTopology()) {
+      result.emplace_back(pair.first);
+      result.emplace_back(pair.second);
+    }
+    std::sort(result.begin(), result.end(), CompareByKey);
+    auto last = std::unique(result.begin(), result.end(), [](const auto &lhs, const auto &rhs) {
+      return MakeKey(lhs) == MakeKey(rhs);
+    });
+    result.erase(last, result.end());
+    return result;
+  }
+
+  static uint64_t ComputeFingerprint(const Map &map, const std::vector<element::Waypoint> &lanes) {
+    uint64_t seed = lanes.size();
+    for (auto &&waypoint : lanes) {
+      const auto centimeters = std::llround(map.GetLane(waypoint).GetLength() * 100.0);
+      for (auto value : {MakeKey(waypoint), static_cast<uint64_t>(centimeters)}) {
+        seed ^= std::hash<uint64_t>()(value) + 0x9e3779b9u + (seed << 6u) + (seed >> 2u);
+      }
+    }
+    return seed;
+  }
+
+  /// Speed limit of the lane at @a s in m/s.
+  static double GetSpeedLimit(const Lane &lane, double s, double default_speed_limit) {
+    const element::RoadInfoSpeed *info = lane.GetInfo<element::RoadInfoSpeed>(s);
+    if (info == nullptr && lane.GetRoad() != nullptr) {
+      info = lane.GetRoad()->GetInfo<element::RoadInfoSpeed>(s);
+    }
+    const double speed = (info != nullptr && info->GetSpeed() > 0.0) ?
+        info->GetSpeed() :
+        default_speed_limit;
+    return speed / 3.6;
+  }
+
+  /// Same rules as client::Waypoint::GetLaneChange.
+  static uint8_t GetAllowedLaneChange(const Map &map, const element::Waypoint &waypoint) {
+    using LaneChange = element::LaneMarking::LaneChange;
+    const auto right = static_cast<uint8_t>(LaneChange::Right);
+    const auto left = static_cast<uint8_t>(LaneChange::Left);
+    const auto swap = [&](uint8_t value) -> uint8_t {
+      return static_cast<uint8_t>(((value & right) != 0u ? left : 0u) | ((value & left) != 0u ? right : 0u));
+    };
+
+    const auto marks = map.GetMarkRecord(waypoint);
+    uint8_t c_right = marks.first != nullptr ?
+        static_cast<uint8_t>(marks.first->GetLaneChange()) :
+        static_cast<uint8_t>(LaneChange::Both);
+    uint8_t c_left = marks.second != nullptr ?
+        static_cast<uint8_t>(marks.second->GetLaneChange()) :
+        static_cast<uint8_t>(LaneChange::Both);
+    if (waypoint.lane_id > 0) {
+      c_right = swap(c_right);
+    }
+    if (((waypoint.lane_id > 0) ? waypoint.lane_id - 1 : waypoint.lane_id + 1) > 0) {
+      c_left = swap(c_left);
+    }
+    return static_cast<uint8_t>((c_right & right) | (c_left & left));
+  }
+
+  /// Copies @a lists into @a offsets and @a arcs in CSR layout.
+  template <typename T>
+  static void Flatten(
+      const std::vector<std::vector<T>> &lists,
+      std::vector<uint32_t> &offsets,
+      std::vector<T> &arcs) {
+    offsets.clear();
+    arcs.clear();
+    offsets.emplace_back(0u);
+    for (auto &&list : lists) {
+      arcs.insert(arcs.end(), list.begin(), list.end());
+      offsets.emplace_back(static_cast<uint32_t>(arcs.size()));
+    }
+  }
+
+  // ===========================================================================
+  // -- Serialization helpers --------------------------------------------------
+  // ===========================================================================
+
+  template <typename T>
+  static void WriteValue(std::ostream &out, const T &value) {
+    static_assert(std::is_trivially_copyable<T>::value, "");
+    out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  template <typename T>
+  static T ReadValue(std::istream &in) {
+    static_assert(std::is_trivially_copyable<T>::value, "");
+    T value{};
+    if (!in.read(reinterpret_cast<char *>(&value), sizeof(T))) {
+      throw_exception(std::invalid_argument("routing graph: unexpected end of stream"));
+    }
+    return value;
+  }
+
+  // ===========================================================================
+  // -- Search space -----------------------------------------------------------
+  // ===========================================================================
+
+  namespace {
+
+    /// Scratch memory of a bidirectional search, reused between queries of the
+    /// same thread; only the touched entries are reset.
+    struct SearchSpace {
+
+      std::vector<double> distance[2u];
+
+      std::vector<NodeId> parent[2u];
+
+      std::vector<NodeId> touched;
+
+      void Reset(size_t number_of_nodes) {
+        for (auto node : touched) {
+          distance[0u][node] = distance[1u][node] = INF;
+        }
+        touched.clear();
+        if (distance[0u].size() < number_of_nodes) {
+          for (auto i = 0u; i < 2u; ++i) {
+            distance[i].resize(number_of_nodes, INF);
+            parent[i].resize(number_of_nodes, std::numeric_limits<NodeId>::max());
+          }
+        }
+      }
+
+      void Set(size_t side, NodeId node, double value, NodeId parent_node) {
+        if (distance[0u][node] == INF && distance[1u][node] == INF) {
+          touched.emplace_back(node);
+        }
+        distance[side][node] = value;
+        parent[side][node] = parent_node;
+      }
+    };
+
+    using QueueItem = std::pair<double, NodeId>;
+
+    using Queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+
+  } // namespace
+
+  // ===========================================================================
+  // -- RoutingGraph -----------------------------------------------------------
+  // ===========================================================================
+
+  constexpr RoutingGraph::NodeId RoutingGraph::INVALID_NODE;
+
+  RoutingGraph::RoutingGraph(const Map &map, Metric metric, Parameters parameters)
+    : _metric(metric),
+      _parameters(parameters) {
+    const auto lanes = CollectLanes(map);
+    _fingerprint = ComputeFingerprint(map, lanes);
+
+    std::vector<double> speeds;
+    _nodes.reserve(lanes.size());
+    speeds.reserve(lanes.size());
+    for (auto &&waypoint : lanes) {
+      const auto &lane = map.GetLane(waypoint);
+      const double length = lane.GetLength();
+      const double s_end = waypoint.lane_id > 0 ?
+          lane.GetDistance() + 10.0 * EPSILON :
+          lane.GetDistance() + length - 10.0 * EPSILON;
+      const double speed = GetSpeedLimit(
+          lane,
+          lane.GetDistance() + 0.5 * length,
+          _parameters.default_speed_limit);
+      const double cost = _metric == Metric::Distance ? length : length / speed;
+      _nodes.emplace_back(Node{
+          waypoint.road_id,
+          waypoint.section_id,
+          waypoint.lane_id,
+          waypoint.s,
+          s_end,
+          cost});
+      speeds.emplace_back(speed);
+    }
+
+    auto add_arc = [](std::vector<std::vector<Arc>> &lists, NodeId from, NodeId to, double weight) {
+      if ((from == INVALID_NODE) || (to == INVALID_NODE) || (from == to)) {
+        return;
+      }
+      for (auto &arc : lists[from]) {
+        if (arc.target == to) {
+          arc.weight = std::min(arc.weight, weight);
+          return;
+        }
+      }
+      lists[from].emplace_back(Arc{to, INVALID_NODE, weight});
+    };
+
+    // successors, driving the whole lane.
+    std::vector<std::vector<Arc>> successors(_nodes.size());
+    for (auto &&pair : map.GenerateTopology()) {
+      const auto from = FindNode(pair.first);
+      if (from != INVALID_NODE) {
+        add_arc(successors, from, FindNode(pair.second), _nodes[from].cost);
+      }
+    }
+
+    // lane changes, only outside junctions and towards lanes going in the
+    // same direction.
+    std::vector<std::vector<Arc>> lane_changes(_nodes.size());
+    for (NodeId from = 0u; from < _nodes.size(); ++from) {
+      const auto &node = _nodes[from];
+      if (map.IsJunction(node.road_id)) {
+        continue;
+      }
+      const Waypoint middle{
+          node.road_id,
+          node.section_id,
+          node.lane_id,
+          0.5 * (node.s_begin + node.s_end)};
+      const double penalty = _metric == Metric::Distance ?
+          _parameters.lane_change_cost :
+          _parameters.lane_change_cost / speeds[from];
+      const auto allowed = GetAllowedLaneChange(map, middle);
+      using LaneChange = element::LaneMarking::LaneChange;
+      auto try_lane_change = [&](boost::optional<Waypoint> neighbour, LaneChange direction) {
+        if (neighbour.has_value() &&
+            ((allowed & static_cast<uint8_t>(direction)) != 0u) &&
+            ((neighbour->lane_id > 0) == (node.lane_id > 0))) {
+          add_arc(lane_changes, from, FindNode(*neighbour), penalty);
+        }
+      };
+      try_lane_change(map.GetRight(middle), LaneChange::Right);
+      try_lane_change(map.GetLeft(middle), LaneChange::Left);
+    }
+
+    Flatten(successors, _successor_offsets, _successor_arcs);
+    Flatten(lane_changes, _lane_change_offsets, _lane_change_arcs);
+
+    // the graph changes lanes at the entry of a lane, or at its exit right
+    // before taking the successor of the new lane.
+    std::vector<std::vector<Arc>> out_arcs(std::move(lane_changes));
+    for (NodeId from = 0u; from < _nodes.size(); ++from) {
+      for (auto &&change : GetLaneChanges(from, false)) {
+        for (auto i = _successor_offsets[change.node]; i < _successor_offsets[change.node + 1u]; ++i) {
+          add_arc(out_arcs, from, _successor_arcs[i].target, _nodes[from].cost + change.cost);
+        }
+      }
+    }
+
+    BuildHierarchy(std::move(out_arcs));
+  }
+
+  void RoutingGraph::BuildHierarchy(std::vector<std::vector<Arc>> out_arcs) {
+    const auto number_of_nodes = static_cast<NodeId>(_nodes.size());
+
+    // incoming arcs store the source node as target.
+    std::vector<std::vector<Arc>> in_arcs(number_of_nodes);
+    for (NodeId from = 0u; from < number_of_nodes; ++from) {
+      for (auto &&arc : out_arcs[from]) {
+        in_arcs[arc.target].emplace_back(Arc{from, arc.middle, arc.weight});
+      }
+    }
+
+    std::vector<bool> contracted(number_of_nodes, false);
+    std::vector<int> contracted_neighbours(number_of_nodes, 0);
+
+    std::vector<double> witness_distance(number_of_nodes, INF);
+    std::vector<NodeId> witness_touched;
+
+    // Dijkstra from @a source ignoring @a excluded and the contracted nodes,
+    // leaves the result in witness_distance.
+    auto witness_search = [&](NodeId source, NodeId excluded, double max_distance) {
+      for (auto node : witness_touched) {
+        witness_distance[node] = INF;
+      }
+      witness_touched.clear();
+      Queue queue;
+      witness_distance[source] = 0.0;
+      witness_touched.emplace_back(source);
+      queue.emplace(0.0, source);
+      size_t settled = 0u;
+      while (!queue.empty() && (settled < WITNESS_SETTLE_LIMIT)) {
+        const auto item = queue.top();
+        queue.pop();
+        if (item.first > witness_distance[item.second]) {
+          continue;
+        }
+        if (item.first > max_distance) {
+          break;
+        }
+        ++settled;
+        for (auto &&arc : out_arcs[item.second]) {
+          if (contracted[arc.target] || (arc.target == excluded)) {
+            continue;
+          }
+          const double distance = item.first + arc.weight;
+          if (distance < witness_distance[arc.target]) {
+            if (witness_distance[arc.target] == INF) {
+              witness_touched.emplace_back(arc.target);
+            }
+            witness_distance[arc.target] = distance;
+            queue.emplace(distance, arc.target);
+          }
+        }
+      }
+    };
+
+    // contracts @a node, or only counts the shortcuts it would need if
+    // @a simulate is true.
+    auto contract = [&](NodeId node, bool simulate) {
+      int shortcuts = 0;
+      for (auto &&in : in_arcs[node]) {
+        if (contracted[in.target]) {
+          continue;
+        }
+        double max_distance = -1.0;
+        for (auto &&out : out_arcs[node]) {
+          if (!contracted[out.target] && (out.target != in.target)) {
+            max_distance = std::max(max_distance, in.weight + out.weight);
+          }
+        }
+        if (max_distance < 0.0) {
+          continue;
+        }
+        witness_search(in.target, node, max_distance);
+        for (auto &&out : out_arcs[node]) {
+          if (contracted[out.target] || (out.target == in.target)) {
+            continue;
+          }
+          const double via = in.weight + out.weight;
+          if (witness_distance[out.target] <= via) {
+            continue;
+          }
+          ++shortcuts;
+          if (simulate) {
+            continue;
+          }
+          auto &outgoing = out_arcs[in.target];
+          auto it = std::find_if(outgoing.begin(), outgoing.end(), [&](const Arc &arc) {
+            return arc.target == out.target;
+          });
+          if (it == outgoing.end()) {
+            outgoing.emplace_back(Arc{out.target, node, via});
+            in_arcs[out.target].emplace_back(Arc{in.target, node, via});
+          } else if (via < it->weight) {
+            *it = Arc{out.target, node, via};
+            for (auto &arc : in_arcs[out.target]) {
+              if (arc.target == in.target) {
+                arc = Arc{in.target, node, via};
+              }
+            }
+          }
+        }
+      }
+      return shortcuts;
+    };
+
+    auto priority = [&](NodeId node) {
+      int removed = 0;
+      for (auto &&arc : in_arcs[node]) {
+        removed += contracted[arc.target] ? 0 : 1;
+      }
+      for (auto &&arc : out_arcs[node]) {
+        removed += contracted[arc.target] ? 0 : 1;
+      }
+      return contract(node, true) - removed + contracted_neighbours[node];
+    };
+
+    // lazy updates: a node is only contracted if its priority is still the
+    // lowest after recomputing it.
+    using PriorityItem = std::pair<int, NodeId>;
+    std::priority_queue<PriorityItem, std::vector<PriorityItem>, std::greater<PriorityItem>> queue;
+    for (NodeId node = 0u; node < number_of_nodes; ++node) {
+      queue.emplace(priority(node), node);
+    }
+
+    _ranks.assign(number_of_nodes, INVALID_NODE);
+    NodeId rank = 0u;
+    while (!queue.empty()) {
+      const auto node = queue.top().second;
+      queue.pop();
+      const auto current = priority(node);
+      if (!queue.empty() && (current > queue.top().first)) {
+        queue.emplace(current, node);
+        continue;
+      }
+      contract(node, false);
+      contracted[node] = true;
+      _ranks[node] = rank++;
+      for (auto &&arc : in_arcs[node]) {
+        ++contracted_neighbours[arc.target];
+      }
+      for (auto &&arc : out_arcs[node]) {
+        ++contracted_neighbours[arc.target];
+      }
+    }
+
+    // split every arc into the upward graph of its lowest ranked end.
+    std::vector<std::vector<Arc>> forward(number_of_nodes);
+    std::vector<std::vector<Arc>> backward(number_of_nodes);
+    for (NodeId from = 0u; from < number_of_nodes; ++from) {
+      for (auto &&arc : out_arcs[from]) {
+        if (_ranks[from] < _ranks[arc.target]) {
+          forward[from].emplace_back(arc);
+        } else {
+          backward[arc.target].emplace_back(Arc{from, arc.middle, arc.weight});
+        }
+      }
+    }
+    Flatten(forward, _forward_offsets, _forward_arcs);
+    Flatten(backward, _backward_offsets, _backward_arcs);
+  }
+
+  RoutingGraph::NodeId RoutingGraph::FindNode(const Waypoint &waypoint) const {
+    const auto key = MakeKey(waypoint);
+    auto it = std::lower_bound(_nodes.begin(), _nodes.end(), key, [](const Node &node, uint64_t value) {
+      return MakeKey(node.road_id, node.section_id, node.lane_id) < value;
+    });
+    if ((it == _nodes.end()) || (MakeKey(it->road_id, it->section_id, it->lane_id) != key)) {
+      return INVALID_NODE;
+    }
+    return static_cast<NodeId>(std::distance(_nodes.begin(), it));
+  }
+
+  double RoutingGraph::GetRatio(NodeId node, const Waypoint &waypoint) const {
+    const auto &n = _nodes[node];
+    const double length = std::abs(n.s_end - n.s_begin);
+    if (length <= 0.0) {
+      return 0.0;
+    }
+    return std::min(1.0, std::abs(waypoint.s - n.s_begin) / length);
+  }
+
+  std::vector<RoutingGraph::LaneChange> RoutingGraph::GetLaneChanges(NodeId node, bool reverse) const {
+    // the lanes of a section are contiguous in _nodes.
+    const auto same_section = [&](NodeId other) {
+      return (_nodes[other].road_id == _nodes[node].road_id) &&
+             (_nodes[other].section_id == _nodes[node].section_id);
+    };
+    NodeId first = node;
+    while ((first > 0u) && same_section(first - 1u)) {
+      --first;
+    }
+    NodeId last = node + 1u;
+    while ((last < _nodes.size()) && same_section(last)) {
+      ++last;
+    }
+
+    // Dijkstra over the lane changes of the section, only a handful of lanes.
+    std::vector<LaneChange> result;
+    std::vector<bool> settled(last - first, false);
+    result.emplace_back(LaneChange{node, 0.0, INVALID_NODE});
+    for (auto index = 0u; index < result.size();) {
+      const auto &current = result[index];
+      settled[current.node - first] = true;
+      const auto current_node = current.node;
+      const auto current_cost = current.cost;
+      auto relax = [&](NodeId next, double weight) {
+        if ((next < first) || (next >= last) || settled[next - first]) {
+          return;
+        }
+        auto it = std::find_if(result.begin(), result.end(), [&](const LaneChange &item) {
+          return item.node == next;
+        });
+        if (it == result.end()) {
+          result.emplace_back(LaneChange{next, current_cost + weight, current_node});
+        } else if (current_cost + weight < it->cost) {
+          *it = LaneChange{next, current_cost + weight, current_node};
+        }
+      };
+      if (reverse) {
+        for (auto from = first; from < last; ++from) {
+          for (auto i = _lane_change_offsets[from]; i < _lane_change_offsets[from + 1u]; ++i) {
+            if (_lane_change_arcs[i].target == current_node) {
+              relax(from, _lane_change_arcs[i].weight);
+            }
+          }
+        }
+      } else {
+        for (auto i = _lane_change_offsets[current_node]; i < _lane_change_offsets[current_node + 1u]; ++i) {
+          relax(_lane_change_arcs[i].target, _lane_change_arcs[i].weight);
+        }
+      }
+      // move the cheapest pending lane to the next position.
+      ++index;
+      auto cheapest = std::min_element(
+          result.begin() + index,
+          result.end(),
+          [](const LaneChange &lhs, const LaneChange &rhs) { return lhs.cost < rhs.cost; });
+      if (cheapest != result.end()) {
+        std::iter_swap(result.begin() + index, cheapest);
+      }
+    }
+    return result;
+  }
+
+  std::vector<RoutingGraph::NodeId> RoutingGraph::FollowPrevious(
+      const std::vector<LaneChange> &lane_changes,
+      NodeId node) {
+    std::vector<NodeId> result;
+    while (node != INVALID_NODE) {
+      auto it = std::find_if(lane_changes.begin(), lane_changes.end(), [&](const LaneChange &item) {
+        return item.node == node;
+      });
+      DEBUG_ASSERT(it != lane_changes.end());
+      if ((it == lane_changes.end()) || (it->previous == INVALID_NODE)) {
+        break;
+      }
+      result.emplace_back(node);
+      node = it->previous;
+    }
+    return result;
+  }
+
+  bool RoutingGraph::IsSuccessor(NodeId from, NodeId to) const {
+    for (auto i = _successor_offsets[from]; i < _successor_offsets[from + 1u]; ++i) {
+      if (_successor_arcs[i].target == to) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  RoutingGraph::Waypoint RoutingGraph::MakeWaypoint(NodeId node, double s) const {
+    const auto &n = _nodes[node];
+    return Waypoint{n.road_id, n.section_id, n.lane_id, s};
+  }
+
+  void RoutingGraph::AppendStep(NodeId from, NodeId to, std::vector<Waypoint> &waypoints) const {
+    const auto &previous = _nodes[from];
+    const auto &node = _nodes[to];
+    if ((node.road_id == previous.road_id) &&
+        (node.section_id == previous.section_id) &&
+        (node.lane_id != previous.lane_id)) {
+      // lane change at the entry, keep the position along the road.
+      waypoints.emplace_back(MakeWaypoint(to, waypoints.back().s));
+      return;
+    }
+    if (!IsSuccessor(from, to)) {
+      // lane changes at the exit, then the successor of the last lane.
+      const auto changes = GetLaneChanges(from, false);
+      const LaneChange *best = nullptr;
+      for (auto &&change : changes) {
+        if (((best == nullptr) || (change.cost < best->cost)) && IsSuccessor(change.node, to)) {
+          best = &change;
+        }
+      }
+      DEBUG_ASSERT(best != nullptr);
+      if ((best != nullptr) && (best->node != from)) {
+        auto lanes = FollowPrevious(changes, best->node);
+        lanes.emplace_back(from);
+        std::reverse(lanes.begin(), lanes.end());
+        for (auto lane : lanes) {
+          waypoints.emplace_back(MakeWaypoint(lane, previous.s_end));
+        }
+      }
+    }
+    waypoints.emplace_back(MakeWaypoint(to, node.s_begin));
+  }
+
+  double RoutingGraph::Query(
+      const std::vector<Seed> &sources,
+      const std::vector<Seed> &targets,
+      std::vector<NodeId> &path) const {
+    path.clear();
+
+    static thread_local SearchSpace space;
+    space.Reset(_nodes.size());
+
+    Queue queues[2u];
+    for (auto side = 0u; side < 2u; ++side) {
+      for (auto &&seed : (side == 0u ? sources : targets)) {
+        if (seed.cost < space.distance[side][seed.node]) {
+          space.Set(side, seed.node, seed.cost, INVALID_NODE);
+          queues[side].emplace(seed.cost, seed.node);
+        }
+      }
+    }
+
+    double best = INF;
+    NodeId meeting = INVALID_NODE;
+    while (!queues[0u].empty() || !queues[1u].empty()) {
+      const double top_forward = queues[0u].empty() ? INF : queues[0u].top().first;
+      const double top_backward = queues[1u].empty() ? INF : queues[1u].top().first;
+      if (std::min(top_forward, top_backward) >= best) {
+        break;
+      }
+      const size_t side = top_forward <= top_backward ? 0u : 1u;
+      const auto item = queues[side].top();
+      queues[side].pop();
+      const auto node = item.second;
+      if (item.first > space.distance[side][node]) {
+        continue;
+      }
+      const double total = item.first + space.distance[1u - side][node];
+      if (total < best) {
+        best = total;
+        meeting = node;
+      }
+      const auto &offsets = side == 0u ? _forward_offsets : _backward_offsets;
+      const auto &arcs = side == 0u ? _forward_arcs : _backward_arcs;
+      for (auto i = offsets[node]; i < offsets[node + 1u]; ++i) {
+        const auto &arc = arcs[i];
+        const double distance = item.first + arc.weight;
+        if (distance < space.distance[side][arc.target]) {
+          space.Set(side, arc.target, distance, node);
+          queues[side].emplace(distance, arc.target);
+        }
+      }
+    }
+
+    if (meeting == INVALID_NODE) {
+      return INF;
+    }
+
+    // hierarchy path: source -> meeting -> target.
+    std::vector<NodeId> packed;
+    for (auto node = meeting; node != INVALID_NODE; node = space.parent[0u][node]) {
+      packed.emplace_back(node);
+    }
+    std::reverse(packed.begin(), packed.end());
+    for (auto node = space.parent[1u][meeting]; node != INVALID_NODE; node = space.parent[1u][node]) {
+      packed.emplace_back(node);
+    }
+
+    path.emplace_back(packed.front());
+    for (auto i = 1u; i < packed.size(); ++i) {
+      Unpack(packed[i - 1u], packed[i], path);
+    }
+    return best;
+  }
+
+  const RoutingGraph::Arc *RoutingGraph::FindArc(NodeId from, NodeId to) const {
+    if (_ranks[from] < _ranks[to]) {
+      for (auto i = _forward_offsets[from]; i < _forward_offsets[from + 1u]; ++i) {
+        if (_forward_arcs[i].target == to) {
+          return &_forward_arcs[i];
+        }
+      }
+    } else {
+      for (auto i = _backward_offsets[to]; i < _backward_offsets[to + 1u]; ++i) {
+        if (_backward_arcs[i].target == from) {
+          return &_backward_arcs[i];
+        }
+      }
+    }
+    return nullptr;
+  }
+
+  void RoutingGraph::Unpack(NodeId from, NodeId to, std::vector<NodeId> &path) const {
+    const Arc *arc = FindArc(from, to);
+    DEBUG_ASSERT(arc != nullptr);
+    if ((arc == nullptr) || (arc->middle == INVALID_NODE)) {
+      path.emplace_back(to);
+    } else {
+      const auto middle = arc->middle;
+      Unpack(from, middle, path);
+      Unpack(middle, to, path);
+    }
+  }
+
+  boost::optional<RoutingGraph::Route> RoutingGraph::ComputeRoute(
+      const Waypoint &origin,
+      const Waypoint &destination) const {
+    const auto source = FindNode(origin);
+    const auto target = FindNode(destination);
+    if ((source == INVALID_NODE) || (target == INVALID_NODE)) {
+      return {};
+    }
+
+    // fraction of the lanes driven at the origin and at the destination, the
+    // same for every lane of their sections.
+    const double origin_ratio = GetRatio(source, origin);
+    const double destination_ratio = GetRatio(target, destination);
+    const auto origin_changes = GetLaneChanges(source, false);
+    const auto destination_changes = GetLaneChanges(target, true);
+
+    // staying in the section, changing lanes at the origin and at the
+    // destination.
+    double cost = INF;
+    NodeId direct = INVALID_NODE;
+    if (destination_ratio >= origin_ratio) {
+      for (auto &&from : origin_changes) {
+        for (auto &&to : destination_changes) {
+          if (from.node != to.node) {
+            continue;
+          }
+          const double total =
+              from.cost +
+              (destination_ratio - origin_ratio) * _nodes[from.node].cost +
+              to.cost;
+          if (total < cost) {
+            cost = total;
+            direct = from.node;
+          }
+        }
+      }
+    }
+
+    // leaving the section, changing lanes at the origin and at the exit.
+    std::vector<Seed> sources;
+    std::vector<std::pair<NodeId, NodeId>> exits;
+    for (auto &&from : origin_changes) {
+      const double driven = from.cost + (1.0 - origin_ratio) * _nodes[from.node].cost;
+      for (auto &&change : GetLaneChanges(from.node, false)) {
+        for (auto i = _successor_offsets[change.node]; i < _successor_offsets[change.node + 1u]; ++i) {
+          const auto next = _successor_arcs[i].target;
+          const double total = driven + change.cost;
+          auto it = std::find_if(sources.begin(), sources.end(), [&](const Seed &seed) {
+            return seed.node == next;
+          });
+          if (it == sources.end()) {
+            sources.emplace_back(Seed{next, total});
+            exits.emplace_back(from.node, change.node);
+          } else if (total < it->cost) {
+            it->cost = total;
+            exits[static_cast<size_t>(std::distance(sources.begin(), it))] = {from.node, change.node};
+          }
+        }
+      }
+    }
+
+    // entering the section of the destination, changing lanes at the entry
+    // or at the destination.
+    std::vector<Seed> targets;
+    for (auto &&to : destination_changes) {
+      targets.emplace_back(Seed{to.node, destination_ratio * _nodes[to.node].cost + to.cost});
+    }
+
+    std::vector<NodeId> path;
+    if (!sources.empty()) {
+      const double total = Query(sources, targets, path);
+      if (total < cost) {
+        cost = total;
+        direct = INVALID_NODE;
+      }
+    }
+    if (cost == INF) {
+      return {};
+    }
+    DEBUG_ASSERT(cost >= 0.0);
+
+    Route route;
+    route.cost = cost;
+    route.waypoints.emplace_back(origin);
+    auto append_lanes = [&](const std::vector<NodeId> &lanes, double s) {
+      for (auto lane : lanes) {
+        route.waypoints.emplace_back(MakeWaypoint(lane, s));
+      }
+    };
+    auto append_origin_changes = [&](NodeId lane) {
+      auto lanes = FollowPrevious(origin_changes, lane);
+      std::reverse(lanes.begin(), lanes.end());
+      append_lanes(lanes, origin.s);
+    };
+    auto append_destination_changes = [&](NodeId lane) {
+      append_lanes(FollowPrevious(destination_changes, lane), destination.s);
+    };
+
+    if (direct != INVALID_NODE) {
+      append_origin_changes(direct);
+      append_destination_changes(direct);
+    } else {
+      const auto seed = std::find_if(sources.begin(), sources.end(), [&](const Seed &item) {
+        return item.node == path.front();
+      });
+      DEBUG_ASSERT(seed != sources.end());
+      const auto exit = exits[static_cast<size_t>(std::distance(sources.begin(), seed))];
+      append_origin_changes(exit.first);
+      if (exit.second != exit.first) {
+        auto lanes = FollowPrevious(GetLaneChanges(exit.first, false), exit.second);
+        lanes.emplace_back(exit.first);
+        std::reverse(lanes.begin(), lanes.end());
+        append_lanes(lanes, _nodes[exit.first].s_end);
+      }
+      route.waypoints.emplace_back(MakeWaypoint(path.front(), _nodes[path.front()].s_begin));
+      for (auto i = 1u; i < path.size(); ++i) {
+        AppendStep(path[i - 1u], path[i], route.waypoints);
+      }
+      append_destination_changes(path.back());
+    }
+    route.waypoints.emplace_back(destination);
+    return route;
+  }
+
+  bool RoutingGraph::IsCompatible(const Map &map) const {
+    return _fingerprint == ComputeFingerprint(map, CollectLanes(map));
+  }
+
+  // ===========================================================================
+  // -- RoutingGraph serialization ---------------------------------------------
+  // ===========================================================================
+
+  void RoutingGraph::Save(std::ostream &out) const {
+    WriteValue(out, ROUTING_GRAPH_MAGIC);
+    WriteValue(out, ROUTING_GRAPH_VERSION);
+    WriteValue(out, static_cast<uint8_t>(_metric));
+    WriteValue(out, _parameters.lane_change_cost);
+    WriteValue(out, _parameters.default_speed_limit);
+    WriteValue(out, _fingerprint);
+    WriteValue(out, static_cast<uint32_t>(_nodes.size()));
+    for (auto &&node : _nodes) {
+      WriteValue(out, node.road_id);
+      WriteValue(out, node.section_id);
+      WriteValue(out, node.lane_id);
+      WriteValue(out, node.s_begin);
+      WriteValue(out, node.s_end);
+      WriteValue(out, node.cost);
+    }
+    for (auto rank : _ranks) {
+      WriteValue(out, rank);
+    }
+    auto write_arcs = [&](const std::vector<uint32_t> &offsets, const std::vector<Arc> &arcs) {
+      for (auto offset : offsets) {
+        WriteValue(out, offset);
+      }
+      for (auto &&arc : arcs) {
+        WriteValue(out, arc.target);
+        WriteValue(out, arc.middle);
+        WriteValue(out, arc.weight);
+      }
+    };
+    write_arcs(_successor_offsets, _successor_arcs);
+    write_arcs(_lane_change_offsets, _lane_change_arcs);
+    write_arcs(_forward_offsets, _forward_arcs);
+    write_arcs(_backward_offsets, _backward_arcs);
+  }
+
+  RoutingGraph RoutingGraph::Load(std::istream &in) {
+    if ((ReadValue<uint32_t>(in) != ROUTING_GRAPH_MAGIC) ||
+        (ReadValue<uint32_t>(in) != ROUTING_GRAPH_VERSION)) {
+      throw_exception(std::invalid_argument("routing graph: invalid header"));
+    }
+    RoutingGraph graph;
+    const auto metric = ReadValue<uint8_t>(in);
+    if (metric > static_cast<uint8_t>(Metric::Time)) {
+      throw_exception(std::invalid_argument("routing graph: invalid metric"));
+    }
+    graph._metric = static_cast<Metric>(metric);
+    graph._parameters.lane_change_cost = ReadValue<double>(in);
+    graph._parameters.default_speed_limit = ReadValue<double>(in);
+    graph._fingerprint = ReadValue<uint64_t>(in);
+    const auto number_of_nodes = ReadValue<uint32_t>(in);
+    graph._nodes.reserve(number_of_nodes);
+    for (auto i = 0u; i < number_of_nodes; ++i) {
+      Node node;
+      node.road_id = ReadValue<RoadId>(in);
+      node.section_id = ReadValue<SectionId>(in);
+      node.lane_id = ReadValue<LaneId>(in);
+      node.s_begin = ReadValue<double>(in);
+      node.s_end = ReadValue<double>(in);
+      node.cost = ReadValue<double>(in);
+      graph._nodes.emplace_back(node);
+    }
+    graph._ranks.reserve(number_of_nodes);
+    for (auto i = 0u; i < number_of_nodes; ++i) {
+      const auto rank = ReadValue<NodeId>(in);
+      if (rank >= number_of_nodes) {
+        throw_exception(std::invalid_argument("routing graph: invalid rank"));
+      }
+      graph._ranks.emplace_back(rank);
+    }
+    auto read_arcs = [&](std::vector<uint32_t> &offsets, std::vector<Arc> &arcs) {
+      offsets.reserve(number_of_nodes + 1u);
+      for (auto i = 0u; i <= number_of_nodes; ++i) {
+        const auto offset = ReadValue<uint32_t>(in);
+        if ((i == 0u && offset != 0u) || (i > 0u && offset < offsets.back())) {
+          throw_exception(std::invalid_argument("routing graph: invalid offsets"));
+        }
+        offsets.emplace_back(offset);
+      }
+      arcs.reserve(offsets.back());
+      for (auto i = 0u; i < offsets.back(); ++i) {
+        Arc arc;
+        arc.target = ReadValue<NodeId>(in);
+        arc.middle = ReadValue<NodeId>(in);
+        arc.weight = ReadValue<double>(in);
+        if ((arc.target >= number_of_nodes) ||
+            ((arc.middle != INVALID_NODE) && (arc.middle >= number_of_nodes))) {
+          throw_exception(std::invalid_argument("routing graph: invalid arc"));
+        }
+        arcs.emplace_back(arc);
+      }
+    };
+    read_arcs(graph._successor_offsets, graph._successor_arcs);
+    read_arcs(graph._lane_change_offsets, graph._lane_change_arcs);
+    read_arcs(graph._forward_offsets, graph._forward_arcs);
+    read_arcs(graph._backward_offsets, graph._backward_arcs);
+    return graph;
+  }
+
+} // namespace road
+} // namespace carla
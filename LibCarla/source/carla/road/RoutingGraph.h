@@ -0,0 +1,215 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/road/element/Waypoint.h"
+#include "carla/road/RoadTypes.h"
+
+#include <boost/optional.hpp>
+
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+namespace carla {
+namespace road {
+
+  class Map;
+
+  /// Lane-level routing graph of a road::Map. Each node is the entry of a
+  /// drivable lane of a lane section, connected to its successors and,
+  /// outside junctions, to the neighbouring lanes it is allowed to change to.
+  /// A contraction hierarchy is precomputed on construction so route queries
+  /// only explore a few hundred nodes.
+  ///
+  /// Lane changes keep the position along the road and may happen anywhere
+  /// in the lane, the graph holds them at the entry and at the exit of the
+  /// lanes, and the queries also at the origin and at the destination.
+  class RoutingGraph {
+  public:
+
+    using Waypoint = element::Waypoint;
+
+    /// Cost used to weight the edges of the graph.
+    enum class Metric : uint8_t {
+      Distance, ///< Meters, shortest route.
+      Time      ///< Seconds at the speed limit, fastest route.
+    };
+
+    struct Parameters {
+      /// Extra cost of a lane change, in meters (converted to seconds using
+      /// the speed limit of the lane in the Time metric).
+      double lane_change_cost = 5.0;
+      /// Speed limit used for lanes without speed record, in km/h.
+      double default_speed_limit = 50.0;
+    };
+
+    struct Route {
+      /// Total cost of the route in the units of the metric.
+      double cost = 0.0;
+      /// Origin, the entry point of every lane traversed, and destination.
+      /// A lane change adds a waypoint on both lanes at the position of the
+      /// change.
+      std::vector<Waypoint> waypoints;
+    };
+
+    /// Creates an empty graph, every query fails.
+    RoutingGraph() = default;
+
+    RoutingGraph(const Map &map, Metric metric, Parameters parameters);
+
+    RoutingGraph(const Map &map, Metric metric)
+      : RoutingGraph(map, metric, Parameters{}) {}
+
+    Metric GetMetric() const {
+      return _metric;
+    }
+
+    const Parameters &GetParameters() const {
+      return _parameters;
+    }
+
+    size_t GetNumberOfNodes() const {
+      return _nodes.size();
+    }
+
+    /// Number of arcs of the hierarchy, including shortcuts.
+    size_t GetNumberOfArcs() const {
+      return _forward_arcs.size() + _backward_arcs.size();
+    }
+
+    /// Computes the route with the lowest cost between two waypoints on
+    /// drivable lanes. Returns nothing if any of them is not part of the graph
+    /// or the destination is unreachable. Thread-safe.
+    boost::optional<Route> ComputeRoute(
+        const Waypoint &origin,
+        const Waypoint &destination) const;
+
+    /// Returns whether this graph has been built from a map with the same lane
+    /// topology as @a map.
+    bool IsCompatible(const Map &map) const;
+
+    /// Writes the preprocessed graph in binary form.
+    void Save(std::ostream &out) const;
+
+    /// Reads a graph written with Save. Throws std::invalid_argument if the
+    /// stream does not contain a valid graph.
+    static RoutingGraph Load(std::istream &in);
+
+  private:
+
+    using NodeId = uint32_t;
+
+    static constexpr NodeId INVALID_NODE = std::numeric_limits<NodeId>::max();
+
+    struct Node {
+      RoadId road_id;
+      SectionId section_id;
+      LaneId lane_id;
+      /// s at which the lane is entered and left in its driving direction.
+      double s_begin;
+      double s_end;
+      /// Cost of driving the whole lane.
+      double cost;
+    };
+
+    struct Arc {
+      NodeId target;
+      /// Contracted node this arc is a shortcut of, INVALID_NODE for original
+      /// arcs.
+      NodeId middle;
+      double weight;
+    };
+
+    /// A lane reachable by changing lanes, see GetLaneChanges.
+    struct LaneChange {
+      NodeId node;
+      double cost;
+      /// Previous lane in the sequence of lane changes.
+      NodeId previous;
+    };
+
+    /// Node where a search starts or ends, with its initial cost.
+    struct Seed {
+      NodeId node;
+      double cost;
+    };
+
+    NodeId FindNode(const Waypoint &waypoint) const;
+
+    /// Fraction of @a node driven at @a waypoint, in [0, 1].
+    double GetRatio(NodeId node, const Waypoint &waypoint) const;
+
+    /// Lanes of the section of @a node reachable by changing lanes from it,
+    /// including itself, with the cost of the lane changes. If @a reverse,
+    /// the lanes from which @a node is reachable instead, and "previous" is
+    /// the next lane towards @a node.
+    std::vector<LaneChange> GetLaneChanges(NodeId node, bool reverse) const;
+
+    /// Follows the previous lanes of @a lane_changes from @a node, included,
+    /// up to the lane they were computed from, excluded.
+    static std::vector<NodeId> FollowPrevious(
+        const std::vector<LaneChange> &lane_changes,
+        NodeId node);
+
+    bool IsSuccessor(NodeId from, NodeId to) const;
+
+    Waypoint MakeWaypoint(NodeId node, double s) const;
+
+    /// Appends the waypoints of the step from @a from to @a to of a path.
+    void AppendStep(NodeId from, NodeId to, std::vector<Waypoint> &waypoints) const;
+
+    void BuildHierarchy(std::vector<std::vector<Arc>> out_arcs);
+
+    /// Bidirectional upward search from every source to every target, returns
+    /// the cost and fills @a path with the unpacked sequence of nodes, from a
+    /// source to a target.
+    double Query(
+        const std::vector<Seed> &sources,
+        const std::vector<Seed> &targets,
+        std::vector<NodeId> &path) const;
+
+    const Arc *FindArc(NodeId from, NodeId to) const;
+
+    void Unpack(NodeId from, NodeId to, std::vector<NodeId> &path) const;
+
+    Metric _metric = Metric::Distance;
+
+    Parameters _parameters;
+
+    uint64_t _fingerprint = 0u;
+
+    /// Sorted by road, section and lane.
+    std::vector<Node> _nodes;
+
+    std::vector<NodeId> _ranks;
+
+    /// Successors of each node, in CSR layout.
+    std::vector<uint32_t> _successor_offsets;
+
+    std::vector<Arc> _successor_arcs;
+
+    /// Lane changes allowed from each node, in CSR layout.
+    std::vector<uint32_t> _lane_change_offsets;
+
+    std::vector<Arc> _lane_change_arcs;
+
+    /// Arcs to higher ranked nodes, in CSR layout.
+    std::vector<uint32_t> _forward_offsets;
+
+    std::vector<Arc> _forward_arcs;
+
+    /// Reversed arcs coming from higher ranked nodes, in CSR layout.
+    std::vector<uint32_t> _backward_offsets;
+
+    std::vector<Arc> _backward_arcs;
+  };
+
+} // namespace road
+} // namespace carla
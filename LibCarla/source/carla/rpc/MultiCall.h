@@ -0,0 +1,208 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/MsgPack.h"
+#include "carla/rpc/Response.h"
+
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace carla {
+namespace rpc {
+
+  // ===========================================================================
+  // -- MultiCallRequest -------------------------------------------------------
+  // ===========================================================================
+
+  /// One of the calls of a "multi_call" request. The arguments are packed the
+  /// same way rpclib packs them for a regular call.
+  class MultiCallRequest {
+  public:
+
+    MultiCallRequest() = default;
+
+    template <typename... Args>
+    explicit MultiCallRequest(std::string function_name, Args &&... args)
+      : function(std::move(function_name)) {
+      ::clmdep_msgpack::sbuffer buffer;
+      ::clmdep_msgpack::pack(buffer, std::make_tuple(std::forward<Args>(args)...));
+      arguments.assign(buffer.data(), buffer.data() + buffer.size());
+    }
+
+    std::string function;
+
+    std::vector<uint8_t> arguments;
+
+    MSGPACK_DEFINE_ARRAY(function, arguments);
+  };
+
+  // ===========================================================================
+  // -- MultiCallResult --------------------------------------------------------
+  // ===========================================================================
+
+  /// Result of one of the calls of a "multi_call" request: the packed return
+  /// value of the function, or an error if the call could not be executed.
+  class MultiCallResult {
+  public:
+
+    MultiCallResult() = default;
+
+    template <typename T>
+    static MultiCallResult Value(const T &value) {
+      ::clmdep_msgpack::sbuffer buffer;
+      ::clmdep_msgpack::pack(buffer, value);
+      MultiCallResult result;
+      result.value.assign(buffer.data(), buffer.data() + buffer.size());
+      return result;
+    }
+
+    static MultiCallResult Error(std::string message) {
+      MultiCallResult result;
+      result.has_error = true;
+      result.error = std::move(message);
+      return result;
+    }
+
+    bool has_error = false;
+
+    std::string error;
+
+    std::vector<uint8_t> value;
+
+    MSGPACK_DEFINE_ARRAY(has_error, error, value);
+  };
+
+  // ===========================================================================
+  // -- MultiCallBatch ---------------------------------------------------------
+  // ===========================================================================
+
+  /// Calls queued to be sent to the server in a single "multi_call" request.
+  /// Each call returns a future that becomes ready once the request has been
+  /// sent and its results received; the calls are executed in order.
+  class MultiCallBatch {
+  public:
+
+    MultiCallBatch() = default;
+
+    MultiCallBatch(const MultiCallBatch &) = delete;
+
+    MultiCallBatch &operator=(const MultiCallBatch &) = delete;
+
+    MultiCallBatch(MultiCallBatch &&) = default;
+
+    MultiCallBatch &operator=(MultiCallBatch &&) = default;
+
+    ~MultiCallBatch() {
+      if (!empty()) {
+        SetException(std::make_exception_ptr(
+            std::runtime_error("multi-call batch destroyed before being sent")));
+      }
+    }
+
+    /// Queue a call to @a function, that returns a Response<T>.
+    template <typename T, typename... Args>
+    std::future<T> Add(const std::string &function, Args &&... args) {
+      auto promise = std::make_shared<std::promise<T>>();
+      _requests.emplace_back(function, std::forward<Args>(args)...);
+      _handlers.emplace_back(
+          [promise](const MultiCallResult &result) { SetResult(*promise, result); },
+          [promise](std::exception_ptr exception) { promise->set_exception(exception); });
+      return promise->get_future();
+    }
+
+    size_t size() const {
+      return _requests.size();
+    }
+
+    bool empty() const {
+      return _requests.empty();
+    }
+
+    const std::vector<MultiCallRequest> &GetRequests() const {
+      return _requests;
+    }
+
+    /// Fulfil the futures of the queued calls and empty the batch.
+    void SetResults(const std::vector<MultiCallResult> &results) {
+      if (results.size() != _handlers.size()) {
+        SetException(std::make_exception_ptr(
+            std::runtime_error("multi-call response size mismatch")));
+        return;
+      }
+      for (auto i = 0u; i < results.size(); ++i) {
+        _handlers[i].first(results[i]);
+      }
+      Clear();
+    }
+
+    /// Fail the futures of the queued calls and empty the batch.
+    void SetException(std::exception_ptr exception) {
+      for (auto &&handler : _handlers) {
+        handler.second(exception);
+      }
+      Clear();
+    }
+
+  private:
+
+    template <typename T>
+    static void SetResult(std::promise<T> &promise, const MultiCallResult &result) {
+      try {
+        auto response = Unpack<Response<T>>(result);
+        if (response.HasError()) {
+          throw std::runtime_error(response.GetError().What());
+        }
+        promise.set_value(std::move(response.Get()));
+      } catch (...) {
+        promise.set_exception(std::current_exception());
+      }
+    }
+
+    static void SetResult(std::promise<void> &promise, const MultiCallResult &result) {
+      try {
+        auto response = Unpack<Response<void>>(result);
+        if (response.HasError()) {
+          throw std::runtime_error(response.GetError().What());
+        }
+        promise.set_value();
+      } catch (...) {
+        promise.set_exception(std::current_exception());
+      }
+    }
+
+    template <typename R>
+    static R Unpack(const MultiCallResult &result) {
+      if (result.has_error) {
+        throw std::runtime_error(result.error);
+      }
+      return MsgPack::UnPack<R>(result.value.data(), result.value.size());
+    }
+
+    void Clear() {
+      _requests.clear();
+      _handlers.clear();
+    }
+
+    using ResultHandler = std::function<void(const MultiCallResult &)>;
+
+    using ExceptionHandler = std::function<void(std::exception_ptr)>;
+
+    std::vector<MultiCallRequest> _requests;
+
+    std::vector<std::pair<ResultHandler, ExceptionHandler>> _handlers;
+  };
+
+} // namespace rpc
+} // namespace carla
@@ -9,6 +9,7 @@
 #include "carla/MoveHandler.h"
 #include "carla/Time.h"
 #include "carla/rpc/Metadata.h"
+#include "carla/rpc/MultiCall.h"
 #include "carla/rpc/Response.h"
 
 #include <boost/asio/io_context.hpp>
@@ -16,7 +17,15 @@
 
 #include <rpc/server.h>
 
+#include <exception>
+#include <functional>
 #include <future>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace carla {
 namespace rpc {
@@ -34,6 +43,10 @@ namespace rpc {
   /// Functions that are bind using `BindAsync` will run asynchronously in the
   /// worker threads. Functions that are bind using `BindSync` will run within
   /// `SyncRunFor` function.
+  ///
+  /// Every function bound is also available through the "multi_call"
+  /// function, that executes a list of calls in order within `SyncRunFor`
+  /// and returns their results in a single response.
   class Server {
   public:
 
@@ -65,9 +78,15 @@ namespace rpc {
 
   private:
 
+    using MultiCallFunction = std::function<MultiCallResult(const MultiCallRequest &)>;
+
+    std::vector<MultiCallResult> MultiCall(const std::vector<MultiCallRequest> &requests) const;
+
     boost::asio::io_context _sync_io_context;
 
     ::rpc::server _server;
+
+    std::unordered_map<std::string, MultiCallFunction> _multi_call_functions;
   };
 
   // ===========================================================================
@@ -136,6 +155,38 @@ namespace detail {
         }
       };
     }
+
+    /// Wraps @a functor into a function that unpacks the arguments of a
+    /// MultiCallRequest and packs its return value into a MultiCallResult.
+    /// Errors are returned as part of the result instead of thrown.
+    template <typename FuncT>
+    static auto WrapMultiCall(FuncT &&functor) {
+      return [functor=std::forward<FuncT>(functor)](const MultiCallRequest &request) -> MultiCallResult {
+        try {
+          std::tuple<std::decay_t<Args>...> args;
+          auto handle = ::clmdep_msgpack::unpack(
+              reinterpret_cast<const char *>(request.arguments.data()),
+              request.arguments.size());
+          handle.get().convert(args);
+          return Invoke(std::is_void<R>{}, functor, args, std::index_sequence_for<Args...>{});
+        } catch (const std::exception &e) {
+          return MultiCallResult::Error(e.what());
+        }
+      };
+    }
+
+  private:
+
+    template <typename FuncT, typename TupleT, size_t... Is>
+    static MultiCallResult Invoke(std::false_type, const FuncT &functor, TupleT &args, std::index_sequence<Is...>) {
+      return MultiCallResult::Value(functor(std::get<Is>(args)...));
+    }
+
+    template <typename FuncT, typename TupleT, size_t... Is>
+    static MultiCallResult Invoke(std::true_type, const FuncT &functor, TupleT &args, std::index_sequence<Is...>) {
+      functor(std::get<Is>(args)...);
+      return MultiCallResult{};
+    }
   };
 
 } // namespace detail
@@ -144,11 +195,34 @@ namespace detail {
   inline Server::Server(Args && ... args)
     : _server(std::forward<Args>(args) ...) {
     _server.suppress_exceptions(true);
+    // multi_call runs in the game thread, hence it calls the functions
+    // directly instead of posting them to the io_context.
+    auto multi_call = [this](const std::vector<MultiCallRequest> &requests) {
+      return MultiCall(requests);
+    };
+    using Wrapper = detail::FunctionWrapper<decltype(multi_call)>;
+    _server.bind("multi_call", Wrapper::WrapSyncCall(_sync_io_context, std::move(multi_call)));
+  }
+
+  inline std::vector<MultiCallResult> Server::MultiCall(
+      const std::vector<MultiCallRequest> &requests) const {
+    std::vector<MultiCallResult> results;
+    results.reserve(requests.size());
+    for (auto &&request : requests) {
+      auto it = _multi_call_functions.find(request.function);
+      if (it == _multi_call_functions.end()) {
+        results.emplace_back(MultiCallResult::Error("function not found: " + request.function));
+      } else {
+        results.emplace_back(it->second(request));
+      }
+    }
+    return results;
   }
 
   template <typename FunctorT>
   inline void Server::BindSync(const std::string &name, FunctorT &&functor) {
     using Wrapper = detail::FunctionWrapper<FunctorT>;
+    _multi_call_functions[name] = Wrapper::WrapMultiCall(std::decay_t<FunctorT>(functor));
     _server.bind(
         name,
         Wrapper::WrapSyncCall(_sync_io_context, std::forward<FunctorT>(functor)));
@@ -157,6 +231,7 @@ namespace detail {
   template <typename FunctorT>
   inline void Server::BindAsync(const std::string &name, FunctorT &&functor) {
     using Wrapper = detail::FunctionWrapper<FunctorT>;
+    _multi_call_functions[name] = Wrapper::WrapMultiCall(std::decay_t<FunctorT>(functor));
     _server.bind(
         name,
         Wrapper::WrapAsyncCall(std::forward<FunctorT>(functor)));
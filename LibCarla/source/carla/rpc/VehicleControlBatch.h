@@ -0,0 +1,242 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Debug.h"
+#include "carla/Exception.h"
+#include "carla/MsgPack.h"
+#include "carla/rpc/ActorId.h"
+#include "carla/rpc/VehicleControl.h"
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace carla {
+namespace rpc {
+
+  /// Controls of several vehicles, stored as one contiguous array per field.
+  /// Serialized as a single msgpack binary blob, the element count followed by
+  /// the raw bytes of each array, instead of field by field.
+  ///
+  /// The values are written in the byte order of the host, both ends are
+  /// expected to share it (little-endian on every supported platform).
+  class VehicleControlBatch {
+  public:
+
+    VehicleControlBatch() = default;
+
+    void Add(ActorId actor, const VehicleControl &control) {
+      _actors.emplace_back(actor);
+      _throttle.emplace_back(control.throttle);
+      _steer.emplace_back(control.steer);
+      _brake.emplace_back(control.brake);
+      _gear.emplace_back(control.gear);
+      uint8_t flags = 0u;
+      flags |= control.hand_brake ? HandBrake : NoFlags;
+      flags |= control.reverse ? Reverse : NoFlags;
+      flags |= control.manual_gear_shift ? ManualGearShift : NoFlags;
+      _flags.emplace_back(flags);
+    }
+
+    size_t size() const {
+      return _actors.size();
+    }
+
+    bool empty() const {
+      return _actors.empty();
+    }
+
+    void reserve(size_t size);
+
+    void clear();
+
+    ActorId GetActor(size_t index) const {
+      DEBUG_ASSERT(index < size());
+      return _actors[index];
+    }
+
+    VehicleControl GetControl(size_t index) const {
+      DEBUG_ASSERT(index < size());
+      return VehicleControl{
+          _throttle[index],
+          _steer[index],
+          _brake[index],
+          (_flags[index] & HandBrake) != 0u,
+          (_flags[index] & Reverse) != 0u,
+          (_flags[index] & ManualGearShift) != 0u,
+          _gear[index]};
+    }
+
+    /// Size in bytes of the serialized batch.
+    size_t GetSerializedSize() const {
+      return sizeof(uint32_t) + size() * ElementSize;
+    }
+
+    /// Packs the arrays straight into the msgpack buffer.
+    template <typename Packer>
+    void msgpack_pack(Packer &pk) const {
+      const auto count = static_cast<uint32_t>(size());
+      pk.pack_array(1u);
+      pk.pack_bin(static_cast<uint32_t>(GetSerializedSize()));
+      pk.pack_bin_body(reinterpret_cast<const char *>(&count), sizeof(count));
+      PackArray(pk, _actors);
+      PackArray(pk, _throttle);
+      PackArray(pk, _steer);
+      PackArray(pk, _brake);
+      PackArray(pk, _gear);
+      PackArray(pk, _flags);
+    }
+
+    void msgpack_unpack(clmdep_msgpack::object const &o) {
+      if ((o.type != clmdep_msgpack::type::ARRAY) ||
+          (o.via.array.size != 1u) ||
+          (o.via.array.ptr[0].type != clmdep_msgpack::type::BIN)) {
+        throw_exception(clmdep_msgpack::type_error());
+      }
+      const auto &bin = o.via.array.ptr[0].via.bin;
+      Deserialize(reinterpret_cast<const unsigned char *>(bin.ptr), bin.size);
+    }
+
+    template <typename MSGPACK_OBJECT>
+    void msgpack_object(MSGPACK_OBJECT *o, clmdep_msgpack::zone &zone) const {
+      const auto bytes = GetSerializedSize();
+      auto *data = static_cast<unsigned char *>(zone.allocate_no_align(bytes));
+      Serialize(data);
+      o->type = clmdep_msgpack::type::ARRAY;
+      o->via.array.size = 1u;
+      o->via.array.ptr = static_cast<clmdep_msgpack::object *>(zone.allocate_align(
+          sizeof(clmdep_msgpack::object),
+          MSGPACK_ZONE_ALIGNOF(clmdep_msgpack::object)));
+      o->via.array.ptr[0].type = clmdep_msgpack::type::BIN;
+      o->via.array.ptr[0].via.bin.size = static_cast<uint32_t>(bytes);
+      o->via.array.ptr[0].via.bin.ptr = reinterpret_cast<const char *>(data);
+    }
+
+  private:
+
+    enum Flags : uint8_t {
+      NoFlags         = 0u,
+      HandBrake       = 1u << 0,
+      Reverse         = 1u << 1,
+      ManualGearShift = 1u << 2
+    };
+
+    static constexpr size_t ElementSize =
+        sizeof(ActorId) + 3u * sizeof(float) + sizeof(int32_t) + sizeof(uint8_t);
+
+    /// The arrays are copied as raw bytes.
+    template <typename T>
+    static void AssertRawCopyable() {
+      static_assert(
+          std::is_standard_layout<T>::value && std::is_trivially_copyable<T>::value,
+          "Only plain types can be copied as raw bytes.");
+    }
+
+    template <typename Packer, typename T>
+    static void PackArray(Packer &pk, const std::vector<T> &array) {
+      AssertRawCopyable<T>();
+      if (!array.empty()) {
+        pk.pack_bin_body(
+            reinterpret_cast<const char *>(array.data()),
+            static_cast<uint32_t>(array.size() * sizeof(T)));
+      }
+    }
+
+    template <typename T>
+    static unsigned char *WriteArray(unsigned char *it, const std::vector<T> &array) {
+      AssertRawCopyable<T>();
+      if (!array.empty()) {
+        std::memcpy(it, array.data(), array.size() * sizeof(T));
+      }
+      return it + array.size() * sizeof(T);
+    }
+
+    template <typename T>
+    static const unsigned char *ReadArray(const unsigned char *it, size_t size, std::vector<T> &array) {
+      AssertRawCopyable<T>();
+      array.resize(size);
+      if (size > 0u) {
+        std::memcpy(array.data(), it, size * sizeof(T));
+      }
+      return it + size * sizeof(T);
+    }
+
+    /// Writes GetSerializedSize() bytes to @a data.
+    void Serialize(unsigned char *data) const;
+
+    void Deserialize(const unsigned char *data, size_t size);
+
+    std::vector<ActorId> _actors;
+
+    std::vector<float> _throttle;
+
+    std::vector<float> _steer;
+
+    std::vector<float> _brake;
+
+    std::vector<int32_t> _gear;
+
+    std::vector<uint8_t> _flags;
+  };
+
+  // ===========================================================================
+  // -- VehicleControlBatch implementation -------------------------------------
+  // ===========================================================================
+
+  inline void VehicleControlBatch::reserve(const size_t size) {
+    _actors.reserve(size);
+    _throttle.reserve(size);
+    _steer.reserve(size);
+    _brake.reserve(size);
+    _gear.reserve(size);
+    _flags.reserve(size);
+  }
+
+  inline void VehicleControlBatch::clear() {
+    _actors.clear();
+    _throttle.clear();
+    _steer.clear();
+    _brake.clear();
+    _gear.clear();
+    _flags.clear();
+  }
+
+  inline void VehicleControlBatch::Serialize(unsigned char *data) const {
+    const auto count = static_cast<uint32_t>(size());
+    auto it = data;
+    std::memcpy(it, &count, sizeof(count));
+    it += sizeof(count);
+    it = WriteArray(it, _actors);
+    it = WriteArray(it, _throttle);
+    it = WriteArray(it, _steer);
+    it = WriteArray(it, _brake);
+    it = WriteArray(it, _gear);
+    it = WriteArray(it, _flags);
+    DEBUG_ASSERT(it == data + GetSerializedSize());
+  }
+
+  inline void VehicleControlBatch::Deserialize(const unsigned char *data, const size_t size) {
+    uint32_t count = 0u;
+    if (size >= sizeof(count)) {
+      std::memcpy(&count, data, sizeof(count));
+    }
+    if (size != sizeof(count) + count * ElementSize) {
+      throw_exception(clmdep_msgpack::type_error());
+    }
+    auto it = data + sizeof(count);
+    it = ReadArray(it, count, _actors);
+    it = ReadArray(it, count, _throttle);
+    it = ReadArray(it, count, _steer);
+    it = ReadArray(it, count, _brake);
+    it = ReadArray(it, count, _gear);
+    ReadArray(it, count, _flags);
+  }
+
+} // namespace rpc
+} // namespace carla
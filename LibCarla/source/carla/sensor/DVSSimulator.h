@@ -0,0 +1,272 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Debug.h"
+#include "carla/sensor/data/Color.h"
+#include "carla/sensor/data/DVSEvent.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace carla {
+namespace sensor {
+
+  /// Event generation model of the DVS camera. Converts each captured frame
+  /// to (log) intensity and emits an event every time the intensity of a
+  /// pixel crosses a contrast threshold since its last event, interpolating
+  /// the timestamp between frames.
+  ///
+  /// The image is processed in independent blocks of rows, that can be run
+  /// in parallel. Each block draws its threshold noise from its own random
+  /// engine seeded from the configured seed, the frame number and the block,
+  /// so the events do not depend on how the blocks are scheduled.
+  class DVSSimulator {
+  public:
+
+    struct Config {
+      float positive_threshold = 0.3f;
+      float negative_threshold = 0.3f;
+      float sigma_positive_threshold = 0.0f;
+      float sigma_negative_threshold = 0.0f;
+      std::uint64_t refractory_period_ns = 0u;
+      bool use_log = true;
+      float log_eps = 1e-03f;
+      std::uint32_t seed = 0u;
+    };
+
+    /// Number of rows of each block.
+    static constexpr size_t RowsPerBlock = 16u;
+
+    DVSSimulator() = default;
+
+    explicit DVSSimulator(const Config &config)
+      : _config(config) {}
+
+    const Config &GetConfig() const {
+      return _config;
+    }
+
+    void SetConfig(const Config &config) {
+      _config = config;
+    }
+
+    /// Discard the state, the next frame will be used as reference.
+    void Reset() {
+      _width = 0u;
+      _height = 0u;
+      _frame_count = 0u;
+      _last_image.clear();
+      _prev_image.clear();
+      _ref_values.clear();
+      _last_event_timestamp.clear();
+    }
+
+    /// Number of blocks of rows of an image of @a height rows.
+    static size_t GetNumberOfBlocks(size_t height) {
+      return (height + RowsPerBlock - 1u) / RowsPerBlock;
+    }
+
+    /// Generate the events between the previous frame and @a image, of
+    /// @a width x @a height pixels captured at @a timestamp_ns. The first
+    /// frame, or a frame of a different size, only sets the reference.
+    ///
+    /// @a parallel_for is called as parallel_for(count, body) and must call
+    /// body(index) once for each index in [0, count), in any order and from
+    /// any thread.
+    ///
+    /// Returns the events sorted by timestamp.
+    template <typename ParallelForT>
+    std::vector<data::DVSEvent> Simulate(
+        const data::Color *image,
+        size_t width,
+        size_t height,
+        std::int64_t timestamp_ns,
+        ParallelForT &&parallel_for);
+
+    /// Same as above, running every block in the calling thread.
+    std::vector<data::DVSEvent> Simulate(
+        const data::Color *image,
+        size_t width,
+        size_t height,
+        std::int64_t timestamp_ns) {
+      return Simulate(image, width, height, timestamp_ns, [](size_t count, auto &&body) {
+        for (auto i = 0u; i < count; ++i) {
+          body(i);
+        }
+      });
+    }
+
+  private:
+
+    static constexpr std::int64_t NoEvent = std::numeric_limits<std::int64_t>::lowest();
+
+    float ToIntensity(const data::Color &color) const {
+      const float gray = 0.2989f * color.r + 0.587f * color.g + 0.114f * color.b;
+      return _config.use_log ? std::log(_config.log_eps + gray / 255.0f) : gray;
+    }
+
+    void ConvertBlock(const data::Color *image, size_t block);
+
+    void SimulateBlock(size_t block, std::int64_t delta_t_ns, std::vector<data::DVSEvent> &events);
+
+    Config _config;
+
+    size_t _width = 0u;
+
+    size_t _height = 0u;
+
+    std::uint64_t _frame_count = 0u;
+
+    std::int64_t _current_time = 0;
+
+    /// Intensity of the last (current) and previous frame.
+    std::vector<float> _last_image;
+
+    std::vector<float> _prev_image;
+
+    /// Intensity at the last threshold crossing of each pixel.
+    std::vector<float> _ref_values;
+
+    /// Timestamp of the last event of each pixel, NoEvent if none.
+    std::vector<std::int64_t> _last_event_timestamp;
+  };
+
+  // ===========================================================================
+  // -- DVSSimulator implementation --------------------------------------------
+  // ===========================================================================
+
+  template <typename ParallelForT>
+  inline std::vector<data::DVSEvent> DVSSimulator::Simulate(
+      const data::Color *image,
+      const size_t width,
+      const size_t height,
+      const std::int64_t timestamp_ns,
+      ParallelForT &&parallel_for) {
+    DEBUG_ASSERT(image != nullptr);
+    const size_t blocks = GetNumberOfBlocks(height);
+    const bool first_frame = (_width != width) || (_height != height) || _prev_image.empty();
+    if (first_frame) {
+      Reset();
+      _width = width;
+      _height = height;
+      _last_image.resize(width * height);
+    }
+    parallel_for(blocks, [&](size_t block) { ConvertBlock(image, block); });
+
+    std::vector<data::DVSEvent> events;
+    if (first_frame) {
+      _ref_values = _last_image;
+      _prev_image = _last_image;
+      const std::int64_t no_event = NoEvent;
+      _last_event_timestamp.assign(_last_image.size(), no_event);
+      _current_time = timestamp_ns;
+      return events;
+    }
+
+    ++_frame_count;
+    const std::int64_t delta_t_ns = timestamp_ns - _current_time;
+    std::vector<std::vector<data::DVSEvent>> block_events(blocks);
+    parallel_for(blocks, [&](size_t block) {
+      SimulateBlock(block, delta_t_ns, block_events[block]);
+    });
+
+    size_t total = 0u;
+    for (const auto &item : block_events) {
+      total += item.size();
+    }
+    events.reserve(total);
+    for (const auto &item : block_events) {
+      events.insert(events.end(), item.begin(), item.end());
+    }
+    // Most event processing algorithms expect the events sorted by time, the
+    // stable sort keeps the result independent of the scheduling.
+    std::stable_sort(events.begin(), events.end(), [](const data::DVSEvent &lhs, const data::DVSEvent &rhs) {
+      return lhs.t < rhs.t;
+    });
+
+    _current_time = timestamp_ns;
+    std::swap(_prev_image, _last_image);
+    return events;
+  }
+
+  inline void DVSSimulator::ConvertBlock(const data::Color *image, const size_t block) {
+    const size_t begin = block * RowsPerBlock * _width;
+    const size_t end = std::min(begin + RowsPerBlock * _width, _last_image.size());
+    for (auto i = begin; i < end; ++i) {
+      _last_image[i] = ToIntensity(image[i]);
+    }
+  }
+
+  inline void DVSSimulator::SimulateBlock(
+      const size_t block,
+      const std::int64_t delta_t_ns,
+      std::vector<data::DVSEvent> &events) {
+    constexpr float tolerance = 1e-6f;
+    constexpr float minimum_contrast_threshold = 0.01f;
+
+    std::seed_seq seed{
+        _config.seed,
+        static_cast<std::uint32_t>(_frame_count),
+        static_cast<std::uint32_t>(_frame_count >> 32u),
+        static_cast<std::uint32_t>(block)};
+    std::minstd_rand engine(seed);
+
+    const size_t row_end = std::min((block + 1u) * RowsPerBlock, _height);
+    for (size_t y = block * RowsPerBlock; y < row_end; ++y) {
+      for (size_t x = 0u; x < _width; ++x) {
+        const size_t i = _width * y + x;
+        const float itdt = _last_image[i];
+        const float it = _prev_image[i];
+        if (std::fabs(it - itdt) <= tolerance) {
+          continue;
+        }
+        const float pol = (itdt >= it) ? +1.0f : -1.0f;
+        float C = (pol > 0.0f) ? _config.positive_threshold : _config.negative_threshold;
+        const float sigma_C = (pol > 0.0f) ? _config.sigma_positive_threshold : _config.sigma_negative_threshold;
+        if (sigma_C > 0.0f) {
+          C += std::normal_distribution<float>(0.0f, sigma_C)(engine);
+        }
+        C = std::max(minimum_contrast_threshold, C);
+        float curr_cross = _ref_values[i];
+        while (true) {
+          curr_cross += pol * C;
+          const bool crossed = (pol > 0.0f) ?
+              ((curr_cross > it) && (curr_cross <= itdt)) :
+              ((curr_cross < it) && (curr_cross >= itdt));
+          if (!crossed) {
+            break;
+          }
+          const std::int64_t edt = static_cast<std::int64_t>(
+              (curr_cross - it) * static_cast<float>(delta_t_ns) / (itdt - it));
+          const std::int64_t t = _current_time + edt;
+          // Check that the pixel is not in a "refractory" state, i.e. the
+          // time since its last event is at least the refractory period.
+          const std::int64_t last_stamp = _last_event_timestamp[i];
+          if ((last_stamp == NoEvent) || (t >= last_stamp)) {
+            if ((last_stamp == NoEvent) ||
+                (static_cast<std::uint64_t>(t - last_stamp) >= _config.refractory_period_ns)) {
+              events.emplace_back(
+                  static_cast<std::uint16_t>(x),
+                  static_cast<std::uint16_t>(y),
+                  t,
+                  pol > 0.0f);
+              _last_event_timestamp[i] = t;
+            }
+            _ref_values[i] = curr_cross;
+          }
+        }
+      }
+    }
+  }
+
+} // namespace sensor
+} // namespace carla
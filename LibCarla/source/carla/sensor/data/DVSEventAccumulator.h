@@ -0,0 +1,124 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Debug.h"
+#include "carla/sensor/data/DVSEvent.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace carla {
+namespace sensor {
+namespace data {
+
+  /// Conversions of a range of DVS events into contiguous arrays. The outputs
+  /// are written into caller-provided memory, so they can be filled in place
+  /// of a Python buffer.
+  class DVSEventAccumulator {
+  public:
+
+    /// Copy each field of the events into its own array of events.size()
+    /// elements. The polarity is written as +1 or -1.
+    template <typename EventRange>
+    static void CopyFields(
+        const EventRange &events,
+        std::uint16_t *x,
+        std::uint16_t *y,
+        std::int64_t *t,
+        std::int16_t *pol) {
+      for (const DVSEvent &event : events) {
+        *x++ = event.x;
+        *y++ = event.y;
+        *t++ = event.t;
+        *pol++ = event.pol ? 1 : -1;
+      }
+    }
+
+    /// Write into @a frame, an image of height x width, the sum of the
+    /// polarities of the events at each pixel with timestamp in
+    /// [t_begin, t_end).
+    template <typename EventRange>
+    static void AccumulateFrame(
+        const EventRange &events,
+        const size_t width,
+        const size_t height,
+        const std::int64_t t_begin,
+        const std::int64_t t_end,
+        std::int32_t *frame) {
+      std::memset(frame, 0, sizeof(std::int32_t) * width * height);
+      for (const DVSEvent &event : events) {
+        const std::int64_t t = event.t;
+        if ((t >= t_begin) && (t < t_end)) {
+          DEBUG_ASSERT((event.x < width) && (event.y < height));
+          frame[width * event.y + event.x] += event.pol ? 1 : -1;
+        }
+      }
+    }
+
+    /// Same as above for every event.
+    template <typename EventRange>
+    static void AccumulateFrame(
+        const EventRange &events,
+        const size_t width,
+        const size_t height,
+        std::int32_t *frame) {
+      AccumulateFrame(
+          events,
+          width,
+          height,
+          std::numeric_limits<std::int64_t>::lowest(),
+          std::numeric_limits<std::int64_t>::max(),
+          frame);
+    }
+
+    /// Write into @a grid a voxel grid of @a bins x height x width. The time
+    /// span of the events is normalized to [0, bins - 1] and the polarity of
+    /// each event is split between its two closest bins, weighted by the
+    /// distance to each.
+    template <typename EventRange>
+    static void AccumulateVoxelGrid(
+        const EventRange &events,
+        const size_t width,
+        const size_t height,
+        const size_t bins,
+        float *grid) {
+      const size_t bin_size = width * height;
+      std::memset(grid, 0, sizeof(float) * bins * bin_size);
+      if ((bins == 0u) || (std::begin(events) == std::end(events))) {
+        return;
+      }
+      std::int64_t t_min = std::numeric_limits<std::int64_t>::max();
+      std::int64_t t_max = std::numeric_limits<std::int64_t>::lowest();
+      for (const DVSEvent &event : events) {
+        const std::int64_t t = event.t;
+        t_min = std::min(t_min, t);
+        t_max = std::max(t_max, t);
+      }
+      const double span = static_cast<double>(t_max - t_min);
+      const double scale = span > 0.0 ? static_cast<double>(bins - 1u) / span : 0.0;
+      for (const DVSEvent &event : events) {
+        DEBUG_ASSERT((event.x < width) && (event.y < height));
+        const double time = scale * static_cast<double>(event.t - t_min);
+        const size_t bin = std::min(static_cast<size_t>(time), bins - 1u);
+        const float weight = static_cast<float>(time - static_cast<double>(bin));
+        const float polarity = event.pol ? 1.0f : -1.0f;
+        float *pixel = grid + width * event.y + event.x;
+        pixel[bin * bin_size] += polarity * (1.0f - weight);
+        if (bin + 1u < bins) {
+          pixel[(bin + 1u) * bin_size] += polarity * weight;
+        }
+      }
+    }
+  };
+
+} // namespace data
+} // namespace sensor
+} // namespace carla
@@ -10,8 +10,11 @@
 #include "carla/sensor/data/Array.h"
 #include "carla/sensor/data/DVSEvent.h"
 #include "carla/sensor/data/Color.h"
+#include "carla/sensor/data/DVSEventAccumulator.h"
 #include "carla/sensor/s11n/DVSEventArraySerializer.h"
 
+#include <algorithm>
+
 namespace carla {
 namespace sensor {
 namespace data {
@@ -55,9 +58,10 @@ namespace data {
 
     ///  Get an event "frame" image for visualization
     std::vector<Color> ToImage() const {
-      std::vector<Color> img(GetHeight() * GetWidth());
+      const size_t width = GetWidth();
+      std::vector<Color> img(GetHeight() * width);
       for (const auto &event : *this) {
-        size_t index = (GetWidth() * event.y) + event.x;
+        size_t index = (width * event.y) + event.x;
         if (event.pol == true) {
           // Blue is positive
           img[index].b = 255u;
@@ -72,6 +76,7 @@ namespace data {
     /// Get the array of events in pure vector format
     std::vector<std::vector<std::int64_t>> ToArray() const {
       std::vector<std::vector<std::int64_t>> array;
+      array.reserve(size());
       for (const auto &event : *this) {
         array.push_back({static_cast<std::int64_t>(event.x), static_cast<std::int64_t>(event.y), static_cast<std::int64_t>(event.t), (2*static_cast<std::int64_t>(event.pol)) - 1});
       }
@@ -80,40 +85,64 @@ namespace data {
 
     /// Get all events' x coordinate for convenience
     std::vector<std::uint16_t> ToArrayX() const {
-      std::vector<std::uint16_t> array;
-      for (const auto &event : *this) {
-        array.push_back(event.x);
-      }
+      std::vector<std::uint16_t> array(size());
+      std::transform(begin(), end(), array.begin(), [](const auto &event) { return event.x; });
       return array;
     }
 
     /// Get all events' y coordinate for convenience
     std::vector<std::uint16_t> ToArrayY() const {
-      std::vector<std::uint16_t> array;
-      for (const auto &event : *this) {
-        array.push_back(event.y);
-      }
+      std::vector<std::uint16_t> array(size());
+      std::transform(begin(), end(), array.begin(), [](const auto &event) { return event.y; });
       return array;
     }
 
     /// Get all events' timestamp for convenience
     std::vector<std::int64_t> ToArrayT() const {
-      std::vector<std::int64_t> array;
-      for (const auto &event : *this) {
-        array.push_back(event.t);
-      }
+      std::vector<std::int64_t> array(size());
+      std::transform(begin(), end(), array.begin(), [](const auto &event) { return event.t; });
       return array;
     }
 
     /// Get all events' polarity for convenience
     std::vector<short> ToArrayPol() const {
-      std::vector<short> array;
-      for (const auto &event : *this) {
-        array.push_back(2*static_cast<short>(event.pol) - 1);
-      }
+      std::vector<short> array(size());
+      std::transform(begin(), end(), array.begin(), [](const auto &event) {
+        return static_cast<short>(2*static_cast<short>(event.pol) - 1);
+      });
       return array;
     }
 
+    /// Copy the x, y, timestamp and polarity of the events into four arrays
+    /// of size() elements each, see DVSEventAccumulator::CopyFields.
+    void CopyFields(
+        std::uint16_t *x,
+        std::uint16_t *y,
+        std::int64_t *t,
+        std::int16_t *pol) const {
+      DVSEventAccumulator::CopyFields(*this, x, y, t, pol);
+    }
+
+    /// Write into @a frame, of GetHeight() x GetWidth() pixels, the sum of
+    /// the polarities of the events with timestamp in [t_begin, t_end).
+    void ToEventFrame(std::int64_t t_begin, std::int64_t t_end, std::int32_t *frame) const {
+      DVSEventAccumulator::AccumulateFrame(*this, GetWidth(), GetHeight(), t_begin, t_end, frame);
+    }
+
+    /// Get the sum of the polarities of all the events at each pixel.
+    std::vector<std::int32_t> ToEventFrame() const {
+      std::vector<std::int32_t> frame(GetWidth() * GetHeight());
+      DVSEventAccumulator::AccumulateFrame(*this, GetWidth(), GetHeight(), frame.data());
+      return frame;
+    }
+
+    /// Write into @a grid a voxel grid of @a bins x GetHeight() x GetWidth()
+    /// over the time span of the events, see
+    /// DVSEventAccumulator::AccumulateVoxelGrid.
+    void ToVoxelGrid(size_t bins, float *grid) const {
+      DVSEventAccumulator::AccumulateVoxelGrid(*this, GetWidth(), GetHeight(), bins, grid);
+    }
+
   };
 
 } // namespace data
@@ -0,0 +1,71 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Debug.h"
+#include "carla/sensor/SensorData.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace carla {
+namespace sensor {
+namespace data {
+
+  /// Measurements of several sensors generated on the same frame, see
+  /// client::SensorBundle. Holds one element per sensor of the bundle, in the
+  /// order the sensors were given; missing measurements are nullptr.
+  class SensorBundleData : public SensorData {
+  public:
+
+    using value_type = SharedPtr<SensorData>;
+    using const_iterator = std::vector<value_type>::const_iterator;
+    using iterator = const_iterator;
+
+    explicit SensorBundleData(
+        size_t frame,
+        double timestamp,
+        const rpc::Transform &sensor_transform,
+        std::vector<value_type> measurements)
+      : SensorData(frame, timestamp, sensor_transform),
+        _measurements(std::move(measurements)) {}
+
+    /// Whether every sensor of the bundle delivered a measurement for this
+    /// frame.
+    bool IsComplete() const {
+      return std::none_of(begin(), end(), [](const value_type &item) { return item == nullptr; });
+    }
+
+    size_t size() const {
+      return _measurements.size();
+    }
+
+    const value_type &at(size_t pos) const {
+      return _measurements.at(pos);
+    }
+
+    const value_type &operator[](size_t pos) const {
+      DEBUG_ASSERT(pos < size());
+      return _measurements[pos];
+    }
+
+    const_iterator begin() const {
+      return _measurements.begin();
+    }
+
+    const_iterator end() const {
+      return _measurements.end();
+    }
+
+  private:
+
+    const std::vector<value_type> _measurements;
+  };
+
+} // namespace data
+} // namespace sensor
+} // namespace carla
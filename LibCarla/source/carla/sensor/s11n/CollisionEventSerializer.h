@@ -46,8 +46,9 @@ namespace s11n {
         const SensorT &,
         rpc::Actor self_actor,
         rpc::Actor other_actor,
-        geom::Vector3D normal_impulse) {
-      return MsgPack::Pack(Data{self_actor, other_actor, normal_impulse});
+        geom::Vector3D normal_impulse,
+        Buffer &&output) {
+      return MsgPack::Pack(Data{self_actor, other_actor, normal_impulse}, std::move(output));
     }
 
     static SharedPtr<SensorData> Deserialize(RawData &&data);
@@ -5,6 +5,7 @@
 #include "carla/Memory.h"
 #include "carla/geom/Vector2D.h"
 #include "carla/geom/Vector3D.h"
+#include "carla/profiler/Tracer.h"
 #include "carla/sensor/RawData.h"
 
 #include <cstdint>
@@ -81,12 +82,14 @@ class DReyeVRSerializer
 
     static Data DeserializeRawData(const RawData &message)
     {
+        CARLA_TRACE_SCOPE(dreyevr, deserialize);
         return MsgPack::UnPack<Data>(message.begin(), message.size());
     }
 
-    template <typename SensorT> static Buffer Serialize(const SensorT &, struct Data &&DataIn)
+    template <typename SensorT> static Buffer Serialize(const SensorT &, struct Data &&DataIn, Buffer &&output)
     {
-        return MsgPack::Pack(DataIn);
+        CARLA_TRACE_SCOPE(dreyevr, serialize);
+        return MsgPack::Pack(DataIn, std::move(output));
     }
     static SharedPtr<SensorData> Deserialize(RawData &&data);
 };
@@ -31,9 +31,9 @@ namespace s11n {
     template <typename SensorT>
     static Buffer Serialize(
         const SensorT &,
-        const geom::GeoLocation &geo_location
-        ) {
-      return MsgPack::Pack(geo_location);
+        const geom::GeoLocation &geo_location,
+        Buffer &&output) {
+      return MsgPack::Pack(geo_location, std::move(output));
     }
 
     static SharedPtr<SensorData> Deserialize(RawData &&data);
@@ -37,7 +37,8 @@ namespace s11n {
       const SensorT &sensor,
       const geom::Vector3D &accelerometer,
       const geom::Vector3D &gyroscope,
-      const float compass);
+      const float compass,
+      Buffer &&output);
 
     static Data DeserializeRawData(const RawData &message) {
       return MsgPack::UnPack<Data>(message.begin(), message.size());
@@ -51,8 +52,9 @@ namespace s11n {
       const SensorT &,
       const geom::Vector3D &accelerometer,
       const geom::Vector3D &gyroscope,
-      const float compass) {
-    return MsgPack::Pack(Data{accelerometer, gyroscope, compass});
+      const float compass,
+      Buffer &&output) {
+    return MsgPack::Pack(Data{accelerometer, gyroscope, compass}, std::move(output));
   }
 
 } // namespace s11n
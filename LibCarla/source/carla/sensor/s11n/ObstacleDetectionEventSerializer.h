@@ -45,8 +45,9 @@ namespace s11n {
         const SensorT &,
         rpc::Actor self_actor,
         rpc::Actor other_actor,
-        float distance) {
-      return MsgPack::Pack(Data{self_actor, other_actor, distance});
+        float distance,
+        Buffer &&output) {
+      return MsgPack::Pack(Data{self_actor, other_actor, distance}, std::move(output));
     }
 
     static SharedPtr<SensorData> Deserialize(RawData &&data);
@@ -8,12 +8,17 @@
 
 #include "carla/Logging.h"
 #include "carla/ThreadPool.h"
+#include "carla/streaming/Metrics.h"
 #include "carla/streaming/Token.h"
+#include "carla/streaming/detail/MetricsServer.h"
 #include "carla/streaming/detail/tcp/Client.h"
 #include "carla/streaming/low_level/Client.h"
 
 #include <boost/asio/io_context.hpp>
 
+#include <memory>
+#include <vector>
+
 namespace carla {
 namespace streaming {
 
@@ -52,6 +57,25 @@ namespace streaming {
       _service.AsyncRun(worker_threads);
     }
 
+    /// Metrics of the streams subscribed, the latency is measured from the
+    /// moment a message is received until its callback returns.
+    std::vector<StreamMetrics> GetMetrics() const {
+      return _client.GetMetrics();
+    }
+
+    /// Serve the metrics in the Prometheus text format on @a port of the
+    /// loopback interface, or on a free port if @a port is 0. Returns the
+    /// port. If already serving, returns the port in use.
+    uint16_t ServeMetrics(uint16_t port) {
+      if (_metrics_server == nullptr) {
+        _metrics_server = std::make_unique<detail::MetricsServer>(
+            _service.io_context(),
+            detail::MetricsServer::endpoint(boost::asio::ip::address_v4::loopback(), port),
+            [this]() { return WritePrometheusMetrics(GetMetrics(), "client"); });
+      }
+      return _metrics_server->GetLocalEndpoint().port();
+    }
+
   private:
 
     // The order of these two arguments is very important.
@@ -59,6 +83,8 @@ namespace streaming {
     ThreadPool _service;
 
     underlying_client _client;
+
+    std::unique_ptr<detail::MetricsServer> _metrics_server;
   };
 
 } // namespace streaming
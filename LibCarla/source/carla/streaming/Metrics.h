@@ -0,0 +1,347 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/streaming/detail/Types.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace carla {
+namespace streaming {
+
+  /// Percentiles of a latency distribution, in nanoseconds.
+  struct LatencySummary {
+    std::uint64_t count = 0u;
+    std::uint64_t sum = 0u;
+    std::uint64_t min = 0u;
+    std::uint64_t max = 0u;
+    std::uint64_t p50 = 0u;
+    std::uint64_t p90 = 0u;
+    std::uint64_t p99 = 0u;
+    std::uint64_t p999 = 0u;
+
+    double mean() const {
+      return count > 0u ? static_cast<double>(sum) / static_cast<double>(count) : 0.0;
+    }
+  };
+
+  /// Lock-free latency histogram with logarithmic buckets, each power of two
+  /// is split in 32 linear sub-buckets so the relative error of the
+  /// percentiles is below 3%. Values above 2^40 ns (~18 minutes) are clamped.
+  class LatencyHistogram : private NonCopyable {
+  public:
+
+    static constexpr unsigned SubBucketBits = 5u;
+
+    static constexpr unsigned MaxExponent = 40u;
+
+    static constexpr size_t NumberOfBuckets = (MaxExponent - SubBucketBits + 1u) << SubBucketBits;
+
+    LatencyHistogram() {
+      Reset();
+    }
+
+    void Record(std::uint64_t ns) {
+      _buckets[GetBucketIndex(ns)].fetch_add(1u, std::memory_order_relaxed);
+      _sum.fetch_add(ns, std::memory_order_relaxed);
+      auto min = _min.load(std::memory_order_relaxed);
+      while ((ns < min) && !_min.compare_exchange_weak(min, ns, std::memory_order_relaxed)) {}
+      auto max = _max.load(std::memory_order_relaxed);
+      while ((ns > max) && !_max.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {}
+    }
+
+    void Record(std::chrono::nanoseconds duration) {
+      Record(static_cast<std::uint64_t>(std::max<std::int64_t>(duration.count(), 0)));
+    }
+
+    /// Not atomic with respect to concurrent calls to Record, a value
+    /// recorded meanwhile may or may not be discarded.
+    void Reset() {
+      for (auto &bucket : _buckets) {
+        bucket.store(0u, std::memory_order_relaxed);
+      }
+      _sum = 0u;
+      _min = ~std::uint64_t(0u);
+      _max = 0u;
+    }
+
+    LatencySummary GetSummary() const {
+      LatencySummary summary;
+      std::array<std::uint64_t, NumberOfBuckets> buckets;
+      for (auto i = 0u; i < NumberOfBuckets; ++i) {
+        buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+        summary.count += buckets[i];
+      }
+      if (summary.count == 0u) {
+        return summary;
+      }
+      summary.sum = _sum.load(std::memory_order_relaxed);
+      summary.min = std::min(_min.load(std::memory_order_relaxed), _max.load(std::memory_order_relaxed));
+      summary.max = _max.load(std::memory_order_relaxed);
+      auto percentile = [&](double p) {
+        const auto rank = std::max<std::uint64_t>(
+            1u,
+            static_cast<std::uint64_t>(p * static_cast<double>(summary.count) + 0.5));
+        std::uint64_t accumulated = 0u;
+        for (auto i = 0u; i < NumberOfBuckets; ++i) {
+          accumulated += buckets[i];
+          if (accumulated >= rank) {
+            return std::max(std::min(GetBucketUpperBound(i), summary.max), summary.min);
+          }
+        }
+        return summary.max;
+      };
+      summary.p50 = percentile(0.5);
+      summary.p90 = percentile(0.9);
+      summary.p99 = percentile(0.99);
+      summary.p999 = percentile(0.999);
+      return summary;
+    }
+
+    static size_t GetBucketIndex(std::uint64_t value) {
+      constexpr std::uint64_t sub_buckets = 1u << SubBucketBits;
+      if (value < sub_buckets) {
+        return static_cast<size_t>(value);
+      }
+      auto exponent = Log2(value);
+      if (exponent >= MaxExponent) {
+        value = (std::uint64_t(1u) << MaxExponent) - 1u;
+        exponent = MaxExponent - 1u;
+      }
+      const auto shift = exponent - SubBucketBits;
+      return static_cast<size_t>(((shift + 1u) << SubBucketBits) + ((value >> shift) - sub_buckets));
+    }
+
+    /// Largest value stored in the bucket at @a index.
+    static std::uint64_t GetBucketUpperBound(size_t index) {
+      constexpr std::uint64_t sub_buckets = 1u << SubBucketBits;
+      if (index < sub_buckets) {
+        return index;
+      }
+      const auto shift = (index >> SubBucketBits) - 1u;
+      const auto sub_bucket = sub_buckets + (index & (sub_buckets - 1u));
+      return ((sub_bucket + 1u) << shift) - 1u;
+    }
+
+  private:
+
+    static unsigned Log2(std::uint64_t value) {
+      unsigned result = 0u;
+      for (unsigned bits = 32u; bits > 0u; bits /= 2u) {
+        if (value >= (std::uint64_t(1u) << bits)) {
+          value >>= bits;
+          result += bits;
+        }
+      }
+      return result;
+    }
+
+    std::array<std::atomic<std::uint64_t>, NumberOfBuckets> _buckets;
+
+    std::atomic<std::uint64_t> _sum{0u};
+
+    std::atomic<std::uint64_t> _min{0u};
+
+    std::atomic<std::uint64_t> _max{0u};
+  };
+
+  /// Snapshot of the metrics of a stream.
+  struct StreamMetrics {
+    detail::stream_id_type stream_id = 0u;
+    /// Messages successfully delivered.
+    std::uint64_t messages = 0u;
+    /// Bytes successfully delivered, including the size headers.
+    std::uint64_t bytes = 0u;
+    /// Messages discarded because the connection was too slow. Only the
+    /// server discards messages, always zero on the client side.
+    std::uint64_t dropped = 0u;
+    /// Messages waiting to be delivered.
+    std::uint64_t queue_depth = 0u;
+    std::uint64_t max_queue_depth = 0u;
+    /// Sessions connected to the stream. Only tracked by the server, always
+    /// zero on the client side.
+    std::uint64_t connections = 0u;
+    LatencySummary latency;
+  };
+
+namespace detail {
+
+  /// Live counters of a stream, shared by every connection to the stream.
+  class StreamCounters : private NonCopyable {
+  public:
+
+    void Connect() {
+      _connections.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    void Disconnect() {
+      _connections.fetch_sub(1u, std::memory_order_relaxed);
+    }
+
+    void Enqueue() {
+      const auto depth = ++_queue_depth;
+      auto max = _max_queue_depth.load(std::memory_order_relaxed);
+      while ((depth > max) && !_max_queue_depth.compare_exchange_weak(max, depth, std::memory_order_relaxed)) {}
+    }
+
+    void Drop() {
+      --_queue_depth;
+      _dropped.fetch_add(1u, std::memory_order_relaxed);
+    }
+
+    /// A message of @a bytes has been delivered after @a latency.
+    void Delivered(std::uint64_t bytes, std::chrono::nanoseconds latency) {
+      --_queue_depth;
+      _messages.fetch_add(1u, std::memory_order_relaxed);
+      _bytes.fetch_add(bytes, std::memory_order_relaxed);
+      _latency.Record(latency);
+    }
+
+    /// A message was enqueued but never delivered, e.g. the socket closed.
+    void Abandon() {
+      --_queue_depth;
+    }
+
+    StreamMetrics GetMetrics(stream_id_type stream_id) const {
+      StreamMetrics metrics;
+      metrics.stream_id = stream_id;
+      metrics.messages = _messages.load(std::memory_order_relaxed);
+      metrics.bytes = _bytes.load(std::memory_order_relaxed);
+      metrics.dropped = _dropped.load(std::memory_order_relaxed);
+      metrics.queue_depth = _queue_depth.load(std::memory_order_relaxed);
+      metrics.max_queue_depth = _max_queue_depth.load(std::memory_order_relaxed);
+      metrics.connections = _connections.load(std::memory_order_relaxed);
+      metrics.latency = _latency.GetSummary();
+      return metrics;
+    }
+
+  private:
+
+    std::atomic<std::uint64_t> _messages{0u};
+
+    std::atomic<std::uint64_t> _bytes{0u};
+
+    std::atomic<std::uint64_t> _dropped{0u};
+
+    std::atomic<std::uint64_t> _queue_depth{0u};
+
+    std::atomic<std::uint64_t> _max_queue_depth{0u};
+
+    std::atomic<std::uint64_t> _connections{0u};
+
+    LatencyHistogram _latency;
+  };
+
+} // namespace detail
+
+  /// Keeps track of the counters of the streams alive. The counters of a
+  /// stream are released once no connection uses them.
+  class StreamMetricsRegistry : private NonCopyable {
+  public:
+
+    std::shared_ptr<detail::StreamCounters> GetCounters(detail::stream_id_type stream_id) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      auto &weak = _counters[stream_id];
+      auto counters = weak.lock();
+      if (counters == nullptr) {
+        counters = std::make_shared<detail::StreamCounters>();
+        weak = counters;
+      }
+      return counters;
+    }
+
+    /// Metrics of every stream alive, sorted by stream id.
+    std::vector<StreamMetrics> GetMetrics() const {
+      std::vector<StreamMetrics> result;
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        result.reserve(_counters.size());
+        for (auto it = _counters.begin(); it != _counters.end();) {
+          auto counters = it->second.lock();
+          if (counters == nullptr) {
+            it = _counters.erase(it);
+          } else {
+            result.emplace_back(counters->GetMetrics(it->first));
+            ++it;
+          }
+        }
+      }
+      std::sort(result.begin(), result.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.stream_id < rhs.stream_id;
+      });
+      return result;
+    }
+
+  private:
+
+    mutable std::mutex _mutex;
+
+    mutable std::unordered_map<
+        detail::stream_id_type,
+        std::weak_ptr<detail::StreamCounters>> _counters;
+  };
+
+  /// Write @a metrics in the Prometheus text exposition format. @a side
+  /// labels every sample, usually "server" or "client".
+  inline void WritePrometheusMetrics(
+      std::ostream &out,
+      const std::vector<StreamMetrics> &metrics,
+      const std::string &side) {
+    auto labels = [&](const StreamMetrics &stream) {
+      return "{side=\"" + side + "\",stream=\"" + std::to_string(stream.stream_id) + "\"";
+    };
+    auto write = [&](const char *name, const char *type, const char *help, auto &&value) {
+      out << "# HELP carla_streaming_" << name << ' ' << help << '\n'
+          << "# TYPE carla_streaming_" << name << ' ' << type << '\n';
+      for (const auto &stream : metrics) {
+        out << "carla_streaming_" << name << labels(stream) << "} " << value(stream) << '\n';
+      }
+    };
+    write("messages_total", "counter", "Messages delivered.", [](const auto &s) { return s.messages; });
+    write("bytes_total", "counter", "Bytes delivered.", [](const auto &s) { return s.bytes; });
+    write("dropped_total", "counter", "Messages discarded because the connection was too slow.", [](const auto &s) { return s.dropped; });
+    write("queue_depth", "gauge", "Messages waiting to be delivered.", [](const auto &s) { return s.queue_depth; });
+    write("max_queue_depth", "gauge", "Maximum number of messages waiting to be delivered.", [](const auto &s) { return s.max_queue_depth; });
+    write("connections", "gauge", "Sessions connected to the stream.", [](const auto &s) { return s.connections; });
+
+    out << "# HELP carla_streaming_latency_seconds Delivery latency.\n"
+        << "# TYPE carla_streaming_latency_seconds summary\n";
+    auto seconds = [](std::uint64_t ns) { return 1e-9 * static_cast<double>(ns); };
+    for (const auto &stream : metrics) {
+      const auto &latency = stream.latency;
+      const auto prefix = "carla_streaming_latency_seconds" + labels(stream);
+      out << prefix << ",quantile=\"0.5\"} " << seconds(latency.p50) << '\n'
+          << prefix << ",quantile=\"0.9\"} " << seconds(latency.p90) << '\n'
+          << prefix << ",quantile=\"0.99\"} " << seconds(latency.p99) << '\n'
+          << prefix << ",quantile=\"0.999\"} " << seconds(latency.p999) << '\n'
+          << "carla_streaming_latency_seconds_sum" << labels(stream) << "} " << seconds(latency.sum) << '\n'
+          << "carla_streaming_latency_seconds_count" << labels(stream) << "} " << latency.count << '\n';
+    }
+  }
+
+  inline std::string WritePrometheusMetrics(
+      const std::vector<StreamMetrics> &metrics,
+      const std::string &side) {
+    std::ostringstream out;
+    WritePrometheusMetrics(out, metrics, side);
+    return out.str();
+  }
+
+} // namespace streaming
+} // namespace carla
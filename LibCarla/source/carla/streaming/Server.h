@@ -7,11 +7,16 @@
 #pragma once
 
 #include "carla/ThreadPool.h"
+#include "carla/streaming/Metrics.h"
+#include "carla/streaming/detail/MetricsServer.h"
 #include "carla/streaming/detail/tcp/Server.h"
 #include "carla/streaming/low_level/Server.h"
 
 #include <boost/asio/io_context.hpp>
 
+#include <memory>
+#include <vector>
+
 namespace carla {
 namespace streaming {
 
@@ -64,6 +69,44 @@ namespace streaming {
       _server.SetSynchronousMode(is_synchro);
     }
 
+    /// Metrics of the streams with at least one client connected, the
+    /// latency is measured from the moment a message is sent to the stream
+    /// until it is written to the socket.
+    std::vector<StreamMetrics> GetMetrics() const {
+      return _server.GetMetrics();
+    }
+
+    /// Serve the metrics in the Prometheus text format on @a port of the
+    /// loopback interface, or on a free port if @a port is 0. Returns the
+    /// port. If already serving, returns the port in use.
+    uint16_t ServeMetrics(uint16_t port) {
+      if (_metrics_server == nullptr) {
+        _metrics_server = std::make_unique<detail::MetricsServer>(
+            _pool.io_context(),
+            detail::MetricsServer::endpoint(boost::asio::ip::address_v4::loopback(), port),
+            [this]() { return WritePrometheusMetrics(GetMetrics(), "server"); });
+      }
+      return _metrics_server->GetLocalEndpoint().port();
+    }
+
+    /// Same as ServeMetrics(port), but reports the errors in @a ec instead of
+    /// throwing, and returns 0 on failure.
+    uint16_t ServeMetrics(uint16_t port, boost::system::error_code &ec) {
+      if (_metrics_server == nullptr) {
+        auto metrics_server = std::make_unique<detail::MetricsServer>(
+            _pool.io_context(),
+            detail::MetricsServer::endpoint(boost::asio::ip::address_v4::loopback(), port),
+            [this]() { return WritePrometheusMetrics(GetMetrics(), "server"); },
+            ec);
+        if (ec) {
+          return 0u;
+        }
+        _metrics_server = std::move(metrics_server);
+      }
+      const auto endpoint = _metrics_server->GetLocalEndpoint(ec);
+      return ec ? 0u : endpoint.port();
+    }
+
   private:
 
     // The order of these two arguments is very important.
@@ -71,6 +114,8 @@ namespace streaming {
     ThreadPool _pool;
 
     underlying_server _server;
+
+    std::unique_ptr<detail::MetricsServer> _metrics_server;
   };
 
 } // namespace streaming
@@ -0,0 +1,231 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Exception.h"
+#include "carla/Logging.h"
+#include "carla/NonCopyable.h"
+#include "carla/Time.h"
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/deadline_timer.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/streambuf.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/system/system_error.hpp>
+
+#include <functional>
+#include <istream>
+#include <memory>
+#include <string>
+
+namespace carla {
+namespace streaming {
+namespace detail {
+
+  /// Minimal HTTP server that answers every GET request with the text
+  /// returned by a provider, used to expose the streaming metrics to a
+  /// Prometheus scraper. Meant to listen on the loopback interface only.
+  ///
+  /// Runs on an external io_context, the provider is called from its threads.
+  /// Connections that do not send a complete request within @a timeout are
+  /// closed.
+  class MetricsServer : private NonCopyable {
+  public:
+
+    using endpoint = boost::asio::ip::tcp::endpoint;
+    using provider_type = std::function<std::string()>;
+
+    MetricsServer(
+        boost::asio::io_context &io_context,
+        const endpoint &ep,
+        provider_type provider,
+        time_duration timeout = time_duration::seconds(5u))
+      : _impl(std::make_shared<Impl>(io_context, std::move(provider), timeout)) {
+      boost::system::error_code ec;
+      _impl->Listen(ep, ec);
+      if (ec) {
+        throw_exception(boost::system::system_error(ec));
+      }
+      _impl->Accept();
+    }
+
+    /// Same as above, but if it cannot listen on @a ep, e.g. because the port
+    /// is in use, it reports the error in @a ec instead of throwing and the
+    /// server does nothing.
+    MetricsServer(
+        boost::asio::io_context &io_context,
+        const endpoint &ep,
+        provider_type provider,
+        boost::system::error_code &ec,
+        time_duration timeout = time_duration::seconds(5u))
+      : _impl(std::make_shared<Impl>(io_context, std::move(provider), timeout)) {
+      _impl->Listen(ep, ec);
+      if (!ec) {
+        _impl->Accept();
+      }
+    }
+
+    ~MetricsServer() {
+      auto impl = _impl;
+      boost::asio::post(impl->strand, [impl]() {
+        boost::system::error_code ec;
+        impl->acceptor.close(ec);
+      });
+    }
+
+    endpoint GetLocalEndpoint() const {
+      return _impl->acceptor.local_endpoint();
+    }
+
+    endpoint GetLocalEndpoint(boost::system::error_code &ec) const {
+      return _impl->acceptor.local_endpoint(ec);
+    }
+
+  private:
+
+    using socket_type = boost::asio::ip::tcp::socket;
+
+    /// Requests larger than this are rejected.
+    static constexpr size_t MaxRequestSize = 8192u;
+
+    /// A client connection, its handlers run on its own strand so the
+    /// timeout cannot close the socket while a read completes.
+    struct Connection {
+      explicit Connection(boost::asio::io_context &io)
+        : socket(io),
+          strand(io),
+          deadline(io),
+          request(MaxRequestSize) {}
+
+      socket_type socket;
+
+      boost::asio::io_context::strand strand;
+
+      boost::asio::deadline_timer deadline;
+
+      boost::asio::streambuf request;
+    };
+
+    /// Kept alive by the pending operations, so it outlives the server while
+    /// the io_context has work for it.
+    struct Impl : public std::enable_shared_from_this<Impl> {
+
+      Impl(boost::asio::io_context &io, provider_type p, time_duration t)
+        : io_context(io),
+          strand(io),
+          acceptor(io),
+          provider(std::move(p)),
+          timeout(t) {}
+
+      /// Same steps as the acceptor constructor taking an endpoint.
+      void Listen(const endpoint &ep, boost::system::error_code &ec) {
+        acceptor.open(ep.protocol(), ec);
+        if (!ec) {
+          acceptor.set_option(boost::asio::socket_base::reuse_address(true), ec);
+        }
+        if (!ec) {
+          acceptor.bind(ep, ec);
+        }
+        if (!ec) {
+          acceptor.listen(boost::asio::socket_base::max_listen_connections, ec);
+        }
+        if (ec) {
+          boost::system::error_code ignored;
+          acceptor.close(ignored);
+        }
+      }
+
+      void Accept() {
+        auto self = shared_from_this();
+        auto connection = std::make_shared<Connection>(io_context);
+        acceptor.async_accept(connection->socket, boost::asio::bind_executor(strand, [self, connection](
+            const boost::system::error_code &ec) {
+          if (!self->acceptor.is_open()) {
+            return;
+          }
+          if (!ec) {
+            self->Respond(connection);
+          } else {
+            log_debug("metrics server: accept error:", ec.message());
+          }
+          self->Accept();
+        }));
+      }
+
+      void Respond(std::shared_ptr<Connection> connection) {
+        auto self = shared_from_this();
+        connection->deadline.expires_from_now(timeout);
+        connection->deadline.async_wait(boost::asio::bind_executor(connection->strand, [connection](
+            const boost::system::error_code &) {
+          // the deadline is moved to infinity once the request is read.
+          if (connection->deadline.expires_at() <= boost::asio::deadline_timer::traits_type::now()) {
+            log_debug("metrics server: timed out waiting for the request");
+            boost::system::error_code ignored;
+            connection->socket.close(ignored);
+          }
+        }));
+        boost::asio::async_read_until(
+            connection->socket,
+            connection->request,
+            "\r\n\r\n",
+            boost::asio::bind_executor(connection->strand, [self, connection](
+                const boost::system::error_code &ec,
+                size_t) {
+          connection->deadline.expires_at(boost::posix_time::pos_infin);
+          if (ec) {
+            log_debug("metrics server: error reading request:", ec.message());
+            return;
+          }
+          std::istream in(&connection->request);
+          std::string method;
+          in >> method;
+          auto response = std::make_shared<std::string>(
+              method == "GET" ?
+                  MakeResponse("200 OK", self->provider()) :
+                  MakeResponse("405 Method Not Allowed", ""));
+          boost::asio::async_write(
+              connection->socket,
+              boost::asio::buffer(*response),
+              boost::asio::bind_executor(connection->strand, [connection, response](
+                  const boost::system::error_code &,
+                  size_t) {
+            boost::system::error_code ignored;
+            connection->socket.shutdown(socket_type::shutdown_both, ignored);
+          }));
+        }));
+      }
+
+      static std::string MakeResponse(const char *status, const std::string &body) {
+        return std::string("HTTP/1.1 ") + status + "\r\n"
+            "Content-Type: text/plain; version=0.0.4\r\n"
+            "Content-Length: " + std::to_string(body.size()) + "\r\n"
+            "Connection: close\r\n"
+            "\r\n" + body;
+      }
+
+      boost::asio::io_context &io_context;
+
+      boost::asio::io_context::strand strand;
+
+      boost::asio::ip::tcp::acceptor acceptor;
+
+      const provider_type provider;
+
+      const time_duration timeout;
+    };
+
+    std::shared_ptr<Impl> _impl;
+  };
+
+} // namespace detail
+} // namespace streaming
+} // namespace carla
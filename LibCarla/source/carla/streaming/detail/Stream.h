@@ -46,6 +46,12 @@ namespace detail {
       return _shared_state->MakeBuffer();
     }
 
+    /// Same as above, but only re-uses buffers of a size similar to
+    /// @a size_hint, use it when the size of the message is known.
+    Buffer MakeBuffer(size_t size_hint) {
+      return _shared_state->MakeBuffer(size_hint);
+    }
+
     /// Flush @a buffers down the stream. No copies are made.
     template <typename... Buffers>
     void Write(Buffers &&... buffers) {
@@ -22,6 +22,10 @@ namespace detail {
     return _buffer_pool->Pop();
   }
 
+  Buffer StreamStateBase::MakeBuffer(const size_t size_hint) {
+    return _buffer_pool->Pop(size_hint);
+  }
+
 } // namespace detail
 } // namespace streaming
 } // namespace carla
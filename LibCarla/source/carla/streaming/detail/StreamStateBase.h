@@ -34,6 +34,8 @@ namespace detail {
 
     Buffer MakeBuffer();
 
+    Buffer MakeBuffer(size_t size_hint);
+
     virtual void ConnectSession(std::shared_ptr<Session> session) = 0;
 
     virtual void DisconnectSession(std::shared_ptr<Session> session) = 0;
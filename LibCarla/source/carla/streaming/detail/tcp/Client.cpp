@@ -11,6 +11,7 @@
 #include "carla/Exception.h"
 #include "carla/Logging.h"
 #include "carla/Time.h"
+#include "carla/profiler/Tracer.h"
 
 #include <boost/asio/connect.hpp>
 #include <boost/asio/read.hpp>
@@ -18,6 +19,7 @@
 #include <boost/asio/post.hpp>
 #include <boost/asio/bind_executor.hpp>
 
+#include <chrono>
 #include <exception>
 
 namespace carla {
@@ -34,7 +36,8 @@ namespace tcp {
   class IncomingMessage {
   public:
 
-    explicit IncomingMessage(Buffer &&buffer) : _message(std::move(buffer)) {}
+    explicit IncomingMessage(std::shared_ptr<BufferPool> pool)
+      : _buffer_pool(std::move(pool)) {}
 
     boost::asio::mutable_buffer size_as_buffer() {
       return boost::asio::buffer(&_size, sizeof(_size));
@@ -42,6 +45,8 @@ namespace tcp {
 
     boost::asio::mutable_buffer buffer() {
       DEBUG_ASSERT(_size > 0u);
+      // Now that the size is known, pop a buffer of a similar size.
+      _message = _buffer_pool->Pop(_size);
       _message.reset(_size);
       return _message.buffer();
     }
@@ -56,6 +61,8 @@ namespace tcp {
 
   private:
 
+    std::shared_ptr<BufferPool> _buffer_pool;
+
     message_size_type _size = 0u;
 
     Buffer _message;
@@ -68,7 +75,8 @@ namespace tcp {
   Client::Client(
       boost::asio::io_context &io_context,
       const token_type &token,
-      callback_function_type callback)
+      callback_function_type callback,
+      std::shared_ptr<StreamCounters> counters)
     : LIBCARLA_INITIALIZE_LIFETIME_PROFILER(
           std::string("tcp client ") + std::to_string(token.get_stream_id())),
       _token(token),
@@ -76,7 +84,8 @@ namespace tcp {
       _socket(io_context),
       _strand(io_context),
       _connection_timer(io_context),
-      _buffer_pool(std::make_shared<BufferPool>()) {
+      _buffer_pool(std::make_shared<BufferPool>()),
+      _counters(counters != nullptr ? std::move(counters) : std::make_shared<StreamCounters>()) {
     if (!_token.protocol_is_tcp()) {
       throw_exception(std::invalid_argument("invalid token, only TCP tokens supported"));
     }
@@ -172,7 +181,7 @@ namespace tcp {
 
       // log_debug("streaming client: Client::ReadData");
 
-      auto message = std::make_shared<IncomingMessage>(_buffer_pool->Pop());
+      auto message = std::make_shared<IncomingMessage>(_buffer_pool);
 
       auto handle_read_data = [this, self, message](boost::system::error_code ec, size_t DEBUG_ONLY(bytes)) {
         DEBUG_ONLY(log_debug("streaming client: Client::ReadData.handle_read_data", bytes, "bytes"));
@@ -182,7 +191,17 @@ namespace tcp {
           // Move the buffer to the callback function and start reading the next
           // piece of data.
           // log_debug("streaming client: success reading data, calling the callback");
-          boost::asio::post(_strand, [self, message]() { self->_callback(message->pop()); });
+          // The latency measured is the time the message waits for the
+          // callback plus the time spent in the callback.
+          const auto received = std::chrono::steady_clock::now();
+          _counters->Enqueue();
+          boost::asio::post(_strand, [self, message, received]() {
+            CARLA_TRACE_SCOPE(streaming, client_callback);
+            self->_callback(message->pop());
+            self->_counters->Delivered(
+                sizeof(message_size_type) + message->size(),
+                std::chrono::steady_clock::now() - received);
+          });
           ReadData();
         } else {
           // As usual, if anything fails start over from the very top.
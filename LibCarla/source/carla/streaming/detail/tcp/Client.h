@@ -9,6 +9,7 @@
 #include "carla/Buffer.h"
 #include "carla/NonCopyable.h"
 #include "carla/profiler/LifetimeProfiled.h"
+#include "carla/streaming/Metrics.h"
 #include "carla/streaming/detail/Token.h"
 #include "carla/streaming/detail/Types.h"
 
@@ -43,10 +44,12 @@ namespace tcp {
     using protocol_type = endpoint::protocol_type;
     using callback_function_type = std::function<void (Buffer)>;
 
+    /// The metrics of the stream are added to @a counters if given.
     Client(
         boost::asio::io_context &io_context,
         const token_type &token,
-        callback_function_type callback);
+        callback_function_type callback,
+        std::shared_ptr<StreamCounters> counters = nullptr);
 
     ~Client();
 
@@ -76,6 +79,8 @@ namespace tcp {
 
     std::shared_ptr<BufferPool> _buffer_pool;
 
+    const std::shared_ptr<StreamCounters> _counters;
+
     std::atomic_bool _done{false};
   };
 
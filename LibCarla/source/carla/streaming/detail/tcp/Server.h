@@ -8,6 +8,7 @@
 
 #include "carla/NonCopyable.h"
 #include "carla/Time.h"
+#include "carla/streaming/Metrics.h"
 #include "carla/streaming/detail/tcp/ServerSession.h"
 
 #include <boost/asio/io_context.hpp>
@@ -15,6 +16,7 @@
 #include <boost/asio/post.hpp>
 
 #include <atomic>
+#include <vector>
 
 namespace carla {
 namespace streaming {
@@ -62,6 +64,15 @@ namespace tcp {
       return _synchronous;
     }
 
+    StreamMetricsRegistry &GetMetricsRegistry() {
+      return _metrics;
+    }
+
+    /// Metrics of the streams with at least one session open.
+    std::vector<StreamMetrics> GetMetrics() const {
+      return _metrics.GetMetrics();
+    }
+
   private:
 
     void OpenSession(
@@ -76,6 +87,8 @@ namespace tcp {
     std::atomic<time_duration> _timeout;
 
     bool _synchronous;
+
+    StreamMetricsRegistry _metrics;
   };
 
 } // namespace tcp
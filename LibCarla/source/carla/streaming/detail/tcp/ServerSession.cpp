@@ -9,6 +9,7 @@
 
 #include "carla/Debug.h"
 #include "carla/Logging.h"
+#include "carla/profiler/Tracer.h"
 
 #include <boost/asio/read.hpp>
 #include <boost/asio/write.hpp>
@@ -16,6 +17,7 @@
 #include <boost/asio/post.hpp>
 
 #include <atomic>
+#include <chrono>
 #include <thread>
 
 namespace carla {
@@ -38,6 +40,12 @@ namespace tcp {
       _deadline(io_context),
       _strand(io_context) {}
 
+  ServerSession::~ServerSession() {
+    if (_counters != nullptr) {
+      _counters->Disconnect();
+    }
+  }
+
   void ServerSession::Open(
       callback_function_type on_opened,
       callback_function_type on_closed) {
@@ -59,6 +67,8 @@ namespace tcp {
         if (!ec) {
           DEBUG_ASSERT_EQ(bytes_received, sizeof(_stream_id));
           log_debug("session", _session_id, "for stream", _stream_id, " started");
+          _counters = _server.GetMetricsRegistry().GetCounters(_stream_id);
+          _counters->Connect();
           boost::asio::post(_strand.context(), [=]() { callback(self); });
         } else {
           log_error("session", _session_id, ": error retrieving stream id :", ec.message());
@@ -78,9 +88,14 @@ namespace tcp {
   void ServerSession::Write(std::shared_ptr<const Message> message) {
     DEBUG_ASSERT(message != nullptr);
     DEBUG_ASSERT(!message->empty());
+    DEBUG_ASSERT(_counters != nullptr);
+    const auto enqueued = std::chrono::steady_clock::now();
+    _counters->Enqueue();
     auto self = shared_from_this();
     boost::asio::post(_strand, [=]() {
+      CARLA_TRACE_SCOPE(streaming, session_write);
       if (!_socket.is_open()) {
+        _counters->Abandon();
         return;
       }
       if (_is_writing) {
@@ -92,19 +107,22 @@ namespace tcp {
         } else {
           // ignore this message
           log_debug("session", _session_id, ": connection too slow: message discarded");
+          _counters->Drop();
           return;
         }      
       }
       _is_writing = true;
 
-      auto handle_sent = [this, self, message](const boost::system::error_code &ec, size_t DEBUG_ONLY(bytes)) {
+      auto handle_sent = [this, self, message, enqueued](const boost::system::error_code &ec, size_t bytes) {
         _is_writing = false;
         if (ec) {
+          _counters->Abandon();
           log_info("session", _session_id, ": error sending data :", ec.message());
           CloseNow();
         } else {
           DEBUG_ONLY(log_debug("session", _session_id, ": successfully sent", bytes, "bytes"));
           DEBUG_ASSERT_EQ(bytes, sizeof(message_size_type) + message->size());
+          _counters->Delivered(bytes, std::chrono::steady_clock::now() - enqueued);
         }
       };
 
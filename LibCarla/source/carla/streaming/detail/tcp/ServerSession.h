@@ -10,6 +10,7 @@
 #include "carla/Time.h"
 #include "carla/TypeTraits.h"
 #include "carla/profiler/LifetimeProfiled.h"
+#include "carla/streaming/Metrics.h"
 #include "carla/streaming/detail/Types.h"
 #include "carla/streaming/detail/tcp/Message.h"
 
@@ -45,6 +46,8 @@ namespace tcp {
         time_duration timeout,
         Server &server);
 
+    ~ServerSession();
+
     /// Starts the session and calls @a on_opened after successfully reading the
     /// stream id, and @a on_closed once the session is closed.
     void Open(
@@ -91,6 +94,10 @@ namespace tcp {
 
     stream_id_type _stream_id = 0u;
 
+    /// Set once the stream id is known, before the session is registered.
+    /// The session counts as a connection of the stream until destroyed.
+    std::shared_ptr<StreamCounters> _counters;
+
     socket_type _socket;
 
     time_duration _timeout;
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "carla/streaming/Metrics.h"
 #include "carla/streaming/detail/Token.h"
 #include "carla/streaming/detail/tcp/Client.h"
 
@@ -13,6 +14,7 @@
 
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 namespace carla {
 namespace streaming {
@@ -60,7 +62,8 @@ namespace low_level {
       auto client = std::make_shared<underlying_client>(
           io_context,
           token,
-          std::forward<Functor>(callback));
+          std::forward<Functor>(callback),
+          _metrics.GetCounters(token.get_stream_id()));
       client->Connect();
       _clients.emplace(token.get_stream_id(), std::move(client));
     }
@@ -73,10 +76,18 @@ namespace low_level {
       }
     }
 
+    /// Metrics of the streams subscribed. Unlike the rest of this class,
+    /// this function is thread-safe.
+    std::vector<StreamMetrics> GetMetrics() const {
+      return _metrics.GetMetrics();
+    }
+
   private:
 
     boost::asio::ip::address _fallback_address;
 
+    StreamMetricsRegistry _metrics;
+
     std::unordered_map<
         detail::stream_id_type,
         std::shared_ptr<underlying_client>> _clients;
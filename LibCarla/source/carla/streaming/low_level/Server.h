@@ -68,6 +68,10 @@ namespace low_level {
       _server.SetSynchronousMode(is_synchro);
     }
 
+    auto GetMetrics() const {
+      return _server.GetMetrics();
+    }
+
   private:
 
     void StartServer() {
@@ -19,7 +19,7 @@ ALSM::ALSM(
   BufferMap &buffer_map,
   TrackTraffic &track_traffic,
   std::vector<ActorId>& marked_for_removal,
-  const Parameters &parameters,
+  Parameters &parameters,
   const cc::World &world,
   const LocalMapPtr &local_map,
   SimulationState &simulation_state,
@@ -55,17 +55,20 @@ void ALSM::Update() {
   current_timestamp = world.GetSnapshot().GetTimestamp();
   ActorList world_actors = world.GetActors();
 
-  // Find destroyed actors and perform clean up.
+  // Find destroyed actors and perform clean up. Their parameters are only
+  // dropped here, unregistered vehicles keep them in case they come back.
   const ALSM::DestroyeddActors destroyed_actors = IdentifyDestroyedActors(world_actors);
 
   const ActorIdSet &destroyed_registered = destroyed_actors.first;
   for (const auto &deletion_id: destroyed_registered) {
     RemoveActor(deletion_id, true);
+    parameters.RemoveVehicle(deletion_id);
   }
 
   const ActorIdSet &destroyed_unregistered = destroyed_actors.second;
   for (auto deletion_id : destroyed_unregistered) {
     RemoveActor(deletion_id, false);
+    parameters.RemoveVehicle(deletion_id);
   }
 
   // Invalidate hero actor if it is not alive anymore.
@@ -98,6 +101,7 @@ void ALSM::Update() {
       && hero_actors.find(max_idle_time.first) == hero_actors.end()) {
     registered_vehicles.Destroy(max_idle_time.first);
     RemoveActor(max_idle_time.first, true);
+    parameters.RemoveVehicle(max_idle_time.first);
     elapsed_last_actor_destruction = current_timestamp.elapsed_seconds;
   }
 
@@ -106,6 +110,7 @@ void ALSM::Update() {
     for (const ActorId& actor_id: marked_for_removal) {
       registered_vehicles.Destroy(actor_id);
       RemoveActor(actor_id, true);
+      parameters.RemoveVehicle(actor_id);
     }
     marked_for_removal.clear();
   }
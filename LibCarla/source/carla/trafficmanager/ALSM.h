@@ -52,7 +52,7 @@ private:
   TrackTraffic &track_traffic;
   // Array of vehicles marked by stages for removal.
   std::vector<ActorId>& marked_for_removal;
-  const Parameters &parameters;
+  Parameters &parameters;
   const cc::World &world;
   const LocalMapPtr &local_map;
   SimulationState &simulation_state;
@@ -96,7 +96,7 @@ public:
        BufferMap &buffer_map,
        TrackTraffic &track_traffic,
        std::vector<ActorId>& marked_for_removal,
-       const Parameters &parameters,
+       Parameters &parameters,
        const cc::World &world,
        const LocalMapPtr &local_map,
        SimulationState &simulation_state,
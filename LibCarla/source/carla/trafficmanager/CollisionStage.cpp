@@ -46,6 +46,7 @@ void CollisionStage::Update(const unsigned long index) {
     ActorIdSet overlapping_actors = track_traffic.GetOverlappingVehicles(ego_actor_id);
     std::vector<ActorId> collision_candidate_ids;
     // Run through vehicles with overlapping paths and filter them;
+    const VehicleParameters &ego_parameters = parameters.GetVehicleParameters(ego_actor_id);
     const float distance_to_leading = parameters.GetDistanceToLeadingVehicle(ego_actor_id);
     float collision_radius_square = SQUARE(COLLISION_RADIUS_RATE * velocity + COLLISION_RADIUS_MIN);
     if (velocity < 2.0f) {
@@ -83,7 +84,7 @@ void CollisionStage::Update(const unsigned long index) {
       const ActorId other_actor_id = *iter;
       const ActorType other_actor_type = simulation_state.GetType(other_actor_id);
 
-      if (parameters.GetCollisionDetection(ego_actor_id, other_actor_id)
+      if (ego_parameters.ignore_collision.find(other_actor_id) == ego_parameters.ignore_collision.end()
           && buffer_map.find(ego_actor_id) != buffer_map.end()
           && simulation_state.ContainsActor(other_actor_id)) {
         std::pair<bool, float> negotiation_result = NegotiateCollision(ego_actor_id,
@@ -91,9 +92,9 @@ void CollisionStage::Update(const unsigned long index) {
                                                                        look_ahead_index);
         if (negotiation_result.first) {
           if ((other_actor_type == ActorType::Vehicle
-               && parameters.GetPercentageIgnoreVehicles(ego_actor_id) <= random_devices.at(ego_actor_id).next())
+               && ego_parameters.perc_ignore_vehicles <= random_devices.at(ego_actor_id).next())
               || (other_actor_type == ActorType::Pedestrian
-                  && parameters.GetPercentageIgnoreWalkers(ego_actor_id) <= random_devices.at(ego_actor_id).next())) {
+                  && ego_parameters.perc_ignore_walkers <= random_devices.at(ego_actor_id).next())) {
             collision_hazard = true;
             obstacle_id = other_actor_id;
             available_distance_margin = negotiation_result.second;
@@ -40,6 +40,19 @@ struct LocalizationData {
 };
 using LocalizationFrame = std::vector<LocalizationData>;
 
+/// Counters of the per-vehicle plan cache of the localization stage.
+struct PlanCacheStats {
+  /// Junction entrance detection.
+  uint64_t junction_hits = 0u;
+  uint64_t junction_misses = 0u;
+  uint64_t invalidations = 0u;
+
+  double GetJunctionHitRate() const {
+    const uint64_t total = junction_hits + junction_misses;
+    return total > 0u ? static_cast<double>(junction_hits) / static_cast<double>(total) : 0.0;
+  }
+};
+
 struct CollisionHazardData {
   float available_distance_margin;
   ActorId hazard_actor_id;
@@ -62,8 +62,11 @@ void LocalizationStage::Update(const unsigned long index) {
     for (uint64_t j = 0u; j < number_of_pops; ++j) {
       PopWaypoint(actor_id, track_traffic, waypoint_buffer);
     }
+    InvalidatePlan(actor_id);
   }
 
+  PlanCacheEntry &plan = plan_cache[actor_id];
+
   bool is_at_junction_entrance = false;
   if (!waypoint_buffer.empty()) {
     // Purge passed waypoints.
@@ -76,17 +79,17 @@ void LocalizationStage::Update(const unsigned long index) {
     }
 
     if (!waypoint_buffer.empty()) {
-      // Determine if the vehicle is at the entrance of a junction.
-      SimpleWaypointPtr look_ahead_point = GetTargetWaypoint(waypoint_buffer, JUNCTION_LOOK_AHEAD).first;
-      SimpleWaypointPtr front_waypoint = waypoint_buffer.front();
-      bool front_waypoint_junction = front_waypoint->CheckJunction();
-      is_at_junction_entrance = !front_waypoint_junction && look_ahead_point->CheckJunction();
-      if (!is_at_junction_entrance) {
-        std::vector<SimpleWaypointPtr> last_passed_waypoints = front_waypoint->GetPreviousWaypoint();
-        if (last_passed_waypoints.size() == 1) {
-          is_at_junction_entrance = !last_passed_waypoints.front()->CheckJunction() && front_waypoint_junction;
-        }
+      // Determine if the vehicle is at the entrance of a junction, only
+      // recomputed when the ends of the buffer change.
+      if (plan.junction_front == waypoint_buffer.front() && plan.junction_back == waypoint_buffer.back()) {
+        ++plan_cache_counters.junction_hits;
+      } else {
+        ++plan_cache_counters.junction_misses;
+        plan.junction_front = waypoint_buffer.front();
+        plan.junction_back = waypoint_buffer.back();
+        plan.is_at_junction_entrance = IsAtJunctionEntrance(waypoint_buffer);
       }
+      is_at_junction_entrance = plan.is_at_junction_entrance;
       if (is_at_junction_entrance
           // Exception for roundabout in Town03.
           && local_map->GetMapName() == "Carla/Maps/Town03"
@@ -170,6 +173,7 @@ void LocalizationStage::Update(const unsigned long index) {
         PopWaypoint(actor_id, track_traffic, waypoint_buffer);
       }
       PushWaypoint(actor_id, track_traffic, waypoint_buffer, change_over_point);
+      InvalidatePlan(actor_id);
     }
   }
 
@@ -317,11 +321,47 @@ void LocalizationStage::ExtendAndFindSafeSpace(const ActorId actor_id,
 void LocalizationStage::RemoveActor(ActorId actor_id) {
     last_lane_change_swpt.erase(actor_id);
     vehicles_at_junction.erase(actor_id);
+    vehicles_at_junction_entrance.erase(actor_id);
+    plan_cache.erase(actor_id);
 }
 
 void LocalizationStage::Reset() {
   last_lane_change_swpt.clear();
   vehicles_at_junction.clear();
+  vehicles_at_junction_entrance.clear();
+  plan_cache.clear();
+}
+
+void LocalizationStage::InvalidatePlan(const ActorId actor_id) {
+  auto it = plan_cache.find(actor_id);
+  if (it != plan_cache.end()) {
+    it->second = PlanCacheEntry();
+    ++plan_cache_counters.invalidations;
+  }
+  // The junction end points refer to the old buffer.
+  vehicles_at_junction_entrance.erase(actor_id);
+}
+
+PlanCacheStats LocalizationStage::GetPlanCacheStats() const {
+  PlanCacheStats stats;
+  stats.junction_hits = plan_cache_counters.junction_hits;
+  stats.junction_misses = plan_cache_counters.junction_misses;
+  stats.invalidations = plan_cache_counters.invalidations;
+  return stats;
+}
+
+bool LocalizationStage::IsAtJunctionEntrance(const Buffer &waypoint_buffer) {
+  SimpleWaypointPtr look_ahead_point = GetTargetWaypoint(waypoint_buffer, JUNCTION_LOOK_AHEAD).first;
+  SimpleWaypointPtr front_waypoint = waypoint_buffer.front();
+  bool front_waypoint_junction = front_waypoint->CheckJunction();
+  bool is_at_junction_entrance = !front_waypoint_junction && look_ahead_point->CheckJunction();
+  if (!is_at_junction_entrance) {
+    std::vector<SimpleWaypointPtr> last_passed_waypoints = front_waypoint->GetPreviousWaypoint();
+    if (last_passed_waypoints.size() == 1) {
+      is_at_junction_entrance = !last_passed_waypoints.front()->CheckJunction() && front_waypoint_junction;
+    }
+  }
+  return is_at_junction_entrance;
 }
 
 SimpleWaypointPtr LocalizationStage::AssignLaneChange(const ActorId actor_id,
@@ -452,6 +492,7 @@ void LocalizationStage::ImportPath(Path &imported_path, Buffer &waypoint_buffer,
       for (uint64_t j = 0u; j < number_of_pops - 1; ++j) {
         PopWaypoint(actor_id, track_traffic, waypoint_buffer, false);
       }
+      InvalidatePlan(actor_id);
       // We have successfully imported the path. Remove it from the list of paths to be imported.
       parameters.RemoveUploadPath(actor_id, false);
     }
@@ -529,6 +570,7 @@ void LocalizationStage::ImportRoute(Route &imported_actions, Buffer &waypoint_bu
       for (uint64_t j = 0u; j < number_of_pops - 1; ++j) {
         PopWaypoint(actor_id, track_traffic, waypoint_buffer, false);
       }
+      InvalidatePlan(actor_id);
       // We have successfully imported the route. Remove it from the list of routes to be imported.
       parameters.RemoveImportedRoute(actor_id, false);
     }
@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 
 #include "carla/trafficmanager/DataStructures.h"
@@ -46,6 +47,33 @@ private:
   std::unordered_map<ActorId, SimpleWaypointPair> vehicles_at_junction_entrance;
   RandomGeneratorMap &random_devices;
 
+  /// Plan computed for a vehicle in previous ticks, each part is reused while
+  /// the buffer end points it was computed for stay the same.
+  struct PlanCacheEntry {
+    SimpleWaypointPtr junction_front;
+    SimpleWaypointPtr junction_back;
+    bool is_at_junction_entrance = false;
+  };
+  std::unordered_map<ActorId, PlanCacheEntry> plan_cache;
+  /// Counters readable from other threads while the stage is running.
+  struct PlanCacheCounters {
+    std::atomic<uint64_t> junction_hits{0u};
+    std::atomic<uint64_t> junction_misses{0u};
+    std::atomic<uint64_t> invalidations{0u};
+    PlanCacheCounters() = default;
+    PlanCacheCounters(const PlanCacheCounters &other)
+      : junction_hits(other.junction_hits.load()),
+        junction_misses(other.junction_misses.load()),
+        invalidations(other.invalidations.load()) {}
+  };
+  PlanCacheCounters plan_cache_counters;
+
+  /// Drops the cached plan of a vehicle, used when its buffer is rebuilt by a
+  /// lane change, a route import or a large deviation.
+  void InvalidatePlan(const ActorId actor_id);
+
+  bool IsAtJunctionEntrance(const Buffer &waypoint_buffer);
+
   SimpleWaypointPtr AssignLaneChange(const ActorId actor_id,
                                      const cg::Location vehicle_location,
                                      const float vehicle_speed,
@@ -86,6 +114,8 @@ public:
 
   ActionBuffer ComputeActionBuffer(const ActorId& actor_id);
 
+  PlanCacheStats GetPlanCacheStats() const;
+
 };
 
 } // namespace traffic_manager
@@ -0,0 +1,56 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/MsgPack.h"
+#include "carla/rpc/ActorId.h"
+
+#include <cstdint>
+
+namespace carla {
+namespace traffic_manager {
+
+/// Behaviour parameters of a vehicle that can be changed with a
+/// ParameterUpdate.
+enum class VehicleParameter : uint8_t {
+  PercentageSpeedDifference,
+  UpdateVehicleLights,
+  ForceLaneChange,
+  AutoLaneChange,
+  DistanceToLeadingVehicle,
+  PercentageIgnoreWalkers,
+  PercentageIgnoreVehicles,
+  PercentageRunningLight,
+  PercentageRunningSign,
+  KeepRightPercentage,
+  RandomLeftLaneChangePercentage,
+  RandomRightLaneChangePercentage
+};
+
+/// New value of a parameter of a vehicle. Boolean parameters are set to true
+/// if the value is not zero. Used to send the parameters of many vehicles to
+/// a traffic manager in a single message.
+struct ParameterUpdate {
+
+  ParameterUpdate() = default;
+
+  ParameterUpdate(ActorId id, VehicleParameter type, float new_value)
+    : actor(id),
+      parameter(type),
+      value(new_value) {}
+
+  ActorId actor = 0u;
+  VehicleParameter parameter = VehicleParameter::PercentageSpeedDifference;
+  float value = 0.0f;
+
+  MSGPACK_DEFINE_ARRAY(actor, parameter, value);
+};
+
+} // namespace traffic_manager
+} // namespace carla
+
+MSGPACK_ADD_ENUM(carla::traffic_manager::VehicleParameter);
@@ -10,7 +10,8 @@
 namespace carla {
 namespace traffic_manager {
 
-Parameters::Parameters() {
+Parameters::Parameters()
+  : snapshot(std::make_shared<ParametersSnapshot>()) {
 
   /// Set default synchronous mode time out.
   synchronous_time_out = std::chrono::duration<int, std::milli>(10);
@@ -18,8 +19,110 @@ Parameters::Parameters() {
 
 Parameters::~Parameters() {}
 
+void Parameters::UpdateSnapshot() {
+  if (staging_dirty.load()) {
+    std::lock_guard<std::mutex> lock(staging_mutex);
+    auto next = std::make_shared<ParametersSnapshot>();
+    next->global_percentage_difference_from_limit = staging_global_percentage_difference_from_limit;
+    next->distance_margin = staging_distance_margin;
+    // Only the pointers are copied, the entries are shared until modified.
+    next->vehicles.insert(staging_vehicles.begin(), staging_vehicles.end());
+    snapshot = std::move(next);
+    staging_copied.clear();
+    staging_dirty.store(false);
+  }
+}
+
+VehicleParameters &Parameters::GetStagingVehicle(const ActorId actor_id) {
+  auto &entry = staging_vehicles[actor_id];
+  if (entry == nullptr) {
+    entry = std::make_shared<VehicleParameters>();
+    staging_copied.insert(actor_id);
+  } else if (staging_copied.insert(actor_id).second) {
+    // Published in the current snapshot, copy it before modifying it.
+    entry = std::make_shared<VehicleParameters>(*entry);
+  }
+  return *entry;
+}
+
+void Parameters::RemoveVehicle(const ActorId actor_id) {
+  {
+    std::lock_guard<std::mutex> lock(staging_mutex);
+    if (staging_vehicles.erase(actor_id) > 0u) {
+      staging_copied.erase(actor_id);
+      staging_dirty.store(true);
+    }
+  }
+  force_lane_change.RemoveEntry(actor_id);
+  upload_path.RemoveEntry(actor_id);
+  custom_path.RemoveEntry(actor_id);
+  upload_route.RemoveEntry(actor_id);
+  custom_route.RemoveEntry(actor_id);
+}
+
 //////////////////////////////////// SETTERS //////////////////////////////////
 
+void Parameters::ApplyUpdates(const std::vector<ParameterUpdate> &updates) {
+  std::lock_guard<std::mutex> lock(staging_mutex);
+  bool changed = false;
+  for (const ParameterUpdate &update : updates) {
+    changed = StageUpdate(update) || changed;
+  }
+  if (changed) {
+    staging_dirty.store(true);
+  }
+}
+
+bool Parameters::StageUpdate(const ParameterUpdate &update) {
+  const float value = update.value;
+  const bool flag = value != 0.0f;
+  if (update.parameter == VehicleParameter::ForceLaneChange) {
+    // Consumed by the localization stage, not part of the snapshot.
+    const ChangeLaneInfo lane_change_info = {true, flag};
+    force_lane_change.AddEntry(std::make_pair(update.actor, lane_change_info));
+    return false;
+  }
+  VehicleParameters &vehicle = GetStagingVehicle(update.actor);
+  switch (update.parameter) {
+    case VehicleParameter::PercentageSpeedDifference:
+      vehicle.percentage_speed_difference = std::min(100.0f, value);
+      break;
+    case VehicleParameter::UpdateVehicleLights:
+      vehicle.update_vehicle_lights = flag;
+      break;
+    case VehicleParameter::AutoLaneChange:
+      vehicle.auto_lane_change = flag;
+      break;
+    case VehicleParameter::DistanceToLeadingVehicle:
+      vehicle.distance_to_leading_vehicle = std::max(0.0f, value);
+      break;
+    case VehicleParameter::PercentageIgnoreWalkers:
+      vehicle.perc_ignore_walkers = cg::Math::Clamp(value, 0.0f, 100.0f);
+      break;
+    case VehicleParameter::PercentageIgnoreVehicles:
+      vehicle.perc_ignore_vehicles = cg::Math::Clamp(value, 0.0f, 100.0f);
+      break;
+    case VehicleParameter::PercentageRunningLight:
+      vehicle.perc_run_traffic_light = cg::Math::Clamp(value, 0.0f, 100.0f);
+      break;
+    case VehicleParameter::PercentageRunningSign:
+      vehicle.perc_run_traffic_sign = cg::Math::Clamp(value, 0.0f, 100.0f);
+      break;
+    case VehicleParameter::KeepRightPercentage:
+      vehicle.perc_keep_right = value;
+      break;
+    case VehicleParameter::RandomLeftLaneChangePercentage:
+      vehicle.perc_random_left = value;
+      break;
+    case VehicleParameter::RandomRightLaneChangePercentage:
+      vehicle.perc_random_right = value;
+      break;
+    default:
+      break;
+  }
+  return true;
+}
+
 void Parameters::SetHybridPhysicsMode(const bool mode_switch) {
 
   hybrid_physics_mode.store(mode_switch);
@@ -41,85 +144,53 @@ void Parameters::SetBoundariesRespawnDormantVehicles(const float lower_bound, co
 }
 
 void Parameters::SetPercentageSpeedDifference(const ActorPtr &actor, const float percentage) {
-
-  float new_percentage = std::min(100.0f, percentage);
-  percentage_difference_from_speed_limit.AddEntry({actor->GetId(), new_percentage});
+  ApplyUpdates({ParameterUpdate{actor->GetId(), VehicleParameter::PercentageSpeedDifference, percentage}});
 }
 
 void Parameters::SetGlobalPercentageSpeedDifference(const float percentage) {
   float new_percentage = std::min(100.0f, percentage);
-  global_percentage_difference_from_limit = new_percentage;
+  std::lock_guard<std::mutex> lock(staging_mutex);
+  staging_global_percentage_difference_from_limit = new_percentage;
+  staging_dirty.store(true);
 }
 
 void Parameters::SetCollisionDetection(const ActorPtr &reference_actor, const ActorPtr &other_actor, const bool detect_collision) {
-  const ActorId reference_id = reference_actor->GetId();
   const ActorId other_id = other_actor->GetId();
-
-  if (detect_collision) {
-    if (ignore_collision.Contains(reference_id)) {
-      std::shared_ptr<AtomicActorSet> actor_set = ignore_collision.GetValue(reference_id);
-      if (actor_set->Contains(other_id)) {
-        actor_set->Remove({other_id});
-      }
-    }
-  } else {
-    if (ignore_collision.Contains(reference_id)) {
-      std::shared_ptr<AtomicActorSet> actor_set = ignore_collision.GetValue(reference_id);
-      if (!actor_set->Contains(other_id)) {
-        actor_set->Insert({other_actor});
-      }
+  StageVehicle(reference_actor->GetId(), [=](VehicleParameters &vehicle) {
+    if (detect_collision) {
+      vehicle.ignore_collision.erase(other_id);
     } else {
-      std::shared_ptr<AtomicActorSet> actor_set = std::make_shared<AtomicActorSet>();
-      actor_set->Insert({other_actor});
-      auto entry = std::make_pair(reference_id, actor_set);
-      ignore_collision.AddEntry(entry);
+      vehicle.ignore_collision.insert(other_id);
     }
-  }
+  });
 }
 
 void Parameters::SetForceLaneChange(const ActorPtr &actor, const bool direction) {
-
-  const ChangeLaneInfo lane_change_info = {true, direction};
-  const auto entry = std::make_pair(actor->GetId(), lane_change_info);
-  force_lane_change.AddEntry(entry);
+  ApplyUpdates({ParameterUpdate{actor->GetId(), VehicleParameter::ForceLaneChange, direction ? 1.0f : 0.0f}});
 }
 
 void Parameters::SetKeepRightPercentage(const ActorPtr &actor, const float percentage) {
-
-  const auto entry = std::make_pair(actor->GetId(), percentage);
-  perc_keep_right.AddEntry(entry);
+  ApplyUpdates({ParameterUpdate{actor->GetId(), VehicleParameter::KeepRightPercentage, percentage}});
 }
 
 void Parameters::SetRandomLeftLaneChangePercentage(const ActorPtr &actor, const float percentage) {
-
-  const auto entry = std::make_pair(actor->GetId(), percentage);
-  perc_random_left.AddEntry(entry);
+  ApplyUpdates({ParameterUpdate{actor->GetId(), VehicleParameter::RandomLeftLaneChangePercentage, percentage}});
 }
 
 void Parameters::SetRandomRightLaneChangePercentage(const ActorPtr &actor, const float percentage) {
-
-  const auto entry = std::make_pair(actor->GetId(), percentage);
-  perc_random_right.AddEntry(entry);
-
+  ApplyUpdates({ParameterUpdate{actor->GetId(), VehicleParameter::RandomRightLaneChangePercentage, percentage}});
 }
 
 void Parameters::SetUpdateVehicleLights(const ActorPtr &actor, const bool do_update) {
-
-  const auto entry = std::make_pair(actor->GetId(), do_update);
-  auto_update_vehicle_lights.AddEntry(entry);
+  ApplyUpdates({ParameterUpdate{actor->GetId(), VehicleParameter::UpdateVehicleLights, do_update ? 1.0f : 0.0f}});
 }
 
 void Parameters::SetAutoLaneChange(const ActorPtr &actor, const bool enable) {
-
-  const auto entry = std::make_pair(actor->GetId(), enable);
-  auto_lane_change.AddEntry(entry);
+  ApplyUpdates({ParameterUpdate{actor->GetId(), VehicleParameter::AutoLaneChange, enable ? 1.0f : 0.0f}});
 }
 
 void Parameters::SetDistanceToLeadingVehicle(const ActorPtr &actor, const float distance) {
-
-  float new_distance = std::max(0.0f, distance);
-  const auto entry = std::make_pair(actor->GetId(), new_distance);
-  distance_to_leading_vehicle.AddEntry(entry);
+  ApplyUpdates({ParameterUpdate{actor->GetId(), VehicleParameter::DistanceToLeadingVehicle, distance}});
 }
 
 void Parameters::SetSynchronousMode(const bool mode_switch) {
@@ -132,35 +203,25 @@ void Parameters::SetSynchronousModeTimeOutInMiliSecond(const double time) {
 
 void Parameters::SetGlobalDistanceToLeadingVehicle(const float dist) {
 
-  distance_margin.store(dist);
+  std::lock_guard<std::mutex> lock(staging_mutex);
+  staging_distance_margin = dist;
+  staging_dirty.store(true);
 }
 
 void Parameters::SetPercentageRunningLight(const ActorPtr &actor, const float perc) {
-
-  float new_perc = cg::Math::Clamp(perc, 0.0f, 100.0f);
-  const auto entry = std::make_pair(actor->GetId(), new_perc);
-  perc_run_traffic_light.AddEntry(entry);
+  ApplyUpdates({ParameterUpdate{actor->GetId(), VehicleParameter::PercentageRunningLight, perc}});
 }
 
 void Parameters::SetPercentageRunningSign(const ActorPtr &actor, const float perc) {
-
-  float new_perc = cg::Math::Clamp(perc, 0.0f, 100.0f);
-  const auto entry = std::make_pair(actor->GetId(), new_perc);
-  perc_run_traffic_sign.AddEntry(entry);
+  ApplyUpdates({ParameterUpdate{actor->GetId(), VehicleParameter::PercentageRunningSign, perc}});
 }
 
 void Parameters::SetPercentageIgnoreVehicles(const ActorPtr &actor, const float perc) {
-
-  float new_perc = cg::Math::Clamp(perc, 0.0f, 100.0f);
-  const auto entry = std::make_pair(actor->GetId(), new_perc);
-  perc_ignore_vehicles.AddEntry(entry);
+  ApplyUpdates({ParameterUpdate{actor->GetId(), VehicleParameter::PercentageIgnoreVehicles, perc}});
 }
 
 void Parameters::SetPercentageIgnoreWalkers(const ActorPtr &actor, const float perc) {
-
-  float new_perc = cg::Math::Clamp(perc,0.0f,100.0f);
-  const auto entry = std::make_pair(actor->GetId(), new_perc);
-  perc_ignore_walkers.AddEntry(entry);
+  ApplyUpdates({ParameterUpdate{actor->GetId(), VehicleParameter::PercentageIgnoreWalkers, perc}});
 }
 
 void Parameters::SetHybridPhysicsRadius(const float radius) {
@@ -231,25 +292,17 @@ double Parameters::GetSynchronousModeTimeOutInMiliSecond() const {
 
 float Parameters::GetVehicleTargetVelocity(const ActorId &actor_id, const float speed_limit) const {
 
-  float percentage_difference = global_percentage_difference_from_limit;
-
-  if (percentage_difference_from_speed_limit.Contains(actor_id)) {
-    percentage_difference = percentage_difference_from_speed_limit.GetValue(actor_id);
-  }
+  const auto &vehicle = GetVehicleParameters(actor_id);
+  const float percentage_difference = vehicle.percentage_speed_difference.value_or(
+      snapshot->global_percentage_difference_from_limit);
 
   return speed_limit * (1.0f - percentage_difference / 100.0f);
 }
 
 bool Parameters::GetCollisionDetection(const ActorId &reference_actor_id, const ActorId &other_actor_id) const {
 
-  bool avoid_collision = true;
-
-  if (ignore_collision.Contains(reference_actor_id) &&
-    ignore_collision.GetValue(reference_actor_id)->Contains(other_actor_id)) {
-    avoid_collision = false;
-  }
-
-  return avoid_collision;
+  const auto &ignored = GetVehicleParameters(reference_actor_id).ignore_collision;
+  return ignored.find(other_actor_id) == ignored.end();
 }
 
 ChangeLaneInfo Parameters::GetForceLaneChange(const ActorId &actor_id) {
@@ -265,114 +318,55 @@ ChangeLaneInfo Parameters::GetForceLaneChange(const ActorId &actor_id) {
   return change_lane_info;
 }
 
-float Parameters::GetKeepRightPercentage(const ActorId &actor_id) {
-
-  float percentage = -1.0f;
-
-  if (perc_keep_right.Contains(actor_id)) {
-    percentage = perc_keep_right.GetValue(actor_id);
-  }
+float Parameters::GetKeepRightPercentage(const ActorId &actor_id) const {
 
-  return percentage;
+  return GetVehicleParameters(actor_id).perc_keep_right;
 }
 
-float Parameters::GetRandomLeftLaneChangePercentage(const ActorId &actor_id) {
-
-  float percentage = -1.0f;
+float Parameters::GetRandomLeftLaneChangePercentage(const ActorId &actor_id) const {
 
-  if (perc_random_left.Contains(actor_id)) {
-    percentage = perc_random_left.GetValue(actor_id);
-  }
-
-  return percentage;
+  return GetVehicleParameters(actor_id).perc_random_left;
 }
 
-float Parameters::GetRandomRightLaneChangePercentage(const ActorId &actor_id) {
-
-  float percentage = -1.0f;
+float Parameters::GetRandomRightLaneChangePercentage(const ActorId &actor_id) const {
 
-  if (perc_random_right.Contains(actor_id)) {
-    percentage = perc_random_right.GetValue(actor_id);
-  }
-
-  return percentage;
+  return GetVehicleParameters(actor_id).perc_random_right;
 }
 
 bool Parameters::GetAutoLaneChange(const ActorId &actor_id) const {
 
-  bool auto_lane_change_policy = true;
-
-  if (auto_lane_change.Contains(actor_id)) {
-    auto_lane_change_policy = auto_lane_change.GetValue(actor_id);
-  }
-
-  return auto_lane_change_policy;
+  return GetVehicleParameters(actor_id).auto_lane_change;
 }
 
 float Parameters::GetDistanceToLeadingVehicle(const ActorId &actor_id) const {
 
-  float specific_distance_margin = 0.0f;
-  if (distance_to_leading_vehicle.Contains(actor_id)) {
-    specific_distance_margin = distance_to_leading_vehicle.GetValue(actor_id);
-  } else {
-    specific_distance_margin = distance_margin;
-  }
-
-  return specific_distance_margin;
+  const auto &vehicle = GetVehicleParameters(actor_id);
+  return vehicle.distance_to_leading_vehicle.value_or(snapshot->distance_margin);
 }
 
 float Parameters::GetPercentageRunningLight(const ActorId &actor_id) const {
 
-  float percentage = 0.0f;
-
-  if (perc_run_traffic_light.Contains(actor_id)) {
-    percentage = perc_run_traffic_light.GetValue(actor_id);
-  }
-
-  return percentage;
+  return GetVehicleParameters(actor_id).perc_run_traffic_light;
 }
 
 float Parameters::GetPercentageRunningSign(const ActorId &actor_id) const {
 
-  float percentage = 0.0f;
-
-  if (perc_run_traffic_sign.Contains(actor_id)) {
-    percentage = perc_run_traffic_sign.GetValue(actor_id);
-  }
-
-  return percentage;
+  return GetVehicleParameters(actor_id).perc_run_traffic_sign;
 }
 
 float Parameters::GetPercentageIgnoreWalkers(const ActorId &actor_id) const {
 
-  float percentage = 0.0f;
-
-  if (perc_ignore_walkers.Contains(actor_id)) {
-    percentage = perc_ignore_walkers.GetValue(actor_id);
-  }
-
-  return percentage;
+  return GetVehicleParameters(actor_id).perc_ignore_walkers;
 }
 
 bool Parameters::GetUpdateVehicleLights(const ActorId &actor_id) const {
-  bool do_update = false;
 
-  if (auto_update_vehicle_lights.Contains(actor_id)) {
-    do_update = auto_update_vehicle_lights.GetValue(actor_id);
-  }
-
-  return do_update;
+  return GetVehicleParameters(actor_id).update_vehicle_lights;
 }
 
 float Parameters::GetPercentageIgnoreVehicles(const ActorId &actor_id) const {
 
-  float percentage = 0.0f;
-
-  if (perc_ignore_vehicles.Contains(actor_id)) {
-    percentage = perc_ignore_vehicles.GetValue(actor_id);
-  }
-
-  return percentage;
+  return GetVehicleParameters(actor_id).perc_ignore_vehicles;
 }
 
 bool Parameters::GetHybridPhysicsMode() const {
@@ -8,8 +8,13 @@
 
 #include <atomic>
 #include <chrono>
+#include <memory>
+#include <mutex>
 #include <random>
 #include <unordered_map>
+#include <unordered_set>
+
+#include <boost/optional.hpp>
 
 #include "carla/client/Actor.h"
 #include "carla/client/Vehicle.h"
@@ -18,6 +23,7 @@
 
 #include "carla/trafficmanager/AtomicActorSet.h"
 #include "carla/trafficmanager/AtomicMap.h"
+#include "carla/trafficmanager/ParameterUpdate.h"
 
 namespace carla {
 namespace traffic_manager {
@@ -34,41 +40,67 @@ struct ChangeLaneInfo {
   bool direction = false;
 };
 
+/// Behaviour parameters of a single vehicle.
+struct VehicleParameters {
+  /// % difference from the speed limit, the global one if not set.
+  boost::optional<float> percentage_speed_difference;
+  /// Distance to the leading vehicle, the global one if not set.
+  boost::optional<float> distance_to_leading_vehicle;
+  /// Actors to be ignored during collision detection.
+  std::unordered_set<ActorId> ignore_collision;
+  bool auto_lane_change = true;
+  bool update_vehicle_lights = false;
+  float perc_run_traffic_light = 0.0f;
+  float perc_run_traffic_sign = 0.0f;
+  float perc_ignore_walkers = 0.0f;
+  float perc_ignore_vehicles = 0.0f;
+  /// Lane change percentages, negative if not set.
+  float perc_keep_right = -1.0f;
+  float perc_random_left = -1.0f;
+  float perc_random_right = -1.0f;
+};
+
+/// Immutable view of the behaviour parameters of every vehicle, published
+/// once per tick.
+struct ParametersSnapshot {
+  /// Global target velocity limit % difference.
+  float global_percentage_difference_from_limit = 0.0f;
+  /// Global distance to leading vehicle.
+  float distance_margin = 2.0f;
+  /// Vehicles with at least one parameter set, the rest use the defaults.
+  /// Entries are shared with the previous snapshots while they do not change.
+  std::unordered_map<ActorId, std::shared_ptr<const VehicleParameters>> vehicles;
+
+  const VehicleParameters &GetVehicle(const ActorId actor_id) const {
+    static const VehicleParameters defaults;
+    auto it = vehicles.find(actor_id);
+    return it != vehicles.end() ? *it->second : defaults;
+  }
+};
+
 class Parameters {
 
 private:
-  /// Target velocity map for individual vehicles.
-  AtomicMap<ActorId, float> percentage_difference_from_speed_limit;
-  /// Global target velocity limit % difference.
-  float global_percentage_difference_from_limit = 0;
-  /// Map containing a set of actors to be ignored during collision detection.
-  AtomicMap<ActorId, std::shared_ptr<AtomicActorSet>> ignore_collision;
-  /// Map containing distance to leading vehicle command.
-  AtomicMap<ActorId, float> distance_to_leading_vehicle;
+  /// Global behaviour parameters modified by the setters, published to the
+  /// stages by UpdateSnapshot.
+  float staging_global_percentage_difference_from_limit = 0.0f;
+  float staging_distance_margin = 2.0f;
+  /// Vehicle parameters modified by the setters. An entry published in a
+  /// snapshot is copied before its first modification, the rest are shared.
+  std::unordered_map<ActorId, std::shared_ptr<VehicleParameters>> staging_vehicles;
+  /// Vehicles whose entry was copied since the last snapshot.
+  std::unordered_set<ActorId> staging_copied;
+  /// Protects the staging parameters.
+  mutable std::mutex staging_mutex;
+  /// Whether the staging parameters changed since the last snapshot.
+  std::atomic<bool> staging_dirty{false};
+  /// Parameters read by the stages during the current tick. Only replaced by
+  /// UpdateSnapshot at the start of a tick, so it is read without locking.
+  std::shared_ptr<const ParametersSnapshot> snapshot;
   /// Map containing force lane change commands.
   AtomicMap<ActorId, ChangeLaneInfo> force_lane_change;
-  /// Map containing auto lane change commands.
-  AtomicMap<ActorId, bool> auto_lane_change;
-  /// Map containing % of running a traffic light.
-  AtomicMap<ActorId, float> perc_run_traffic_light;
-  /// Map containing % of running a traffic sign.
-  AtomicMap<ActorId, float> perc_run_traffic_sign;
-  /// Map containing % of ignoring walkers.
-  AtomicMap<ActorId, float> perc_ignore_walkers;
-  /// Map containing % of ignoring vehicles.
-  AtomicMap<ActorId, float> perc_ignore_vehicles;
-  /// Map containing % of keep right rule.
-  AtomicMap<ActorId, float> perc_keep_right;
-  /// Map containing % of random left lane change.
-  AtomicMap<ActorId, float> perc_random_left;
-  /// Map containing % of random right lane change.
-  AtomicMap<ActorId, float> perc_random_right;
-  /// Map containing the automatic vehicle lights update flag
-  AtomicMap<ActorId, bool> auto_update_vehicle_lights;
   /// Synchronous mode switch.
   std::atomic<bool> synchronous_mode{false};
-  /// Distance margin
-  std::atomic<float> distance_margin{2.0};
   /// Hybrid physics mode switch.
   std::atomic<bool> hybrid_physics_mode{false};
   /// Automatic respawn mode switch.
@@ -94,12 +126,44 @@ private:
   /// Structure to hold all custom routes.
   AtomicMap<ActorId, Route> custom_route;
 
+  /// Modify the staging parameters of @a actor_id under lock.
+  template <typename FunctorT>
+  void StageVehicle(const ActorId actor_id, FunctorT &&functor) {
+    std::lock_guard<std::mutex> lock(staging_mutex);
+    functor(GetStagingVehicle(actor_id));
+    staging_dirty.store(true);
+  }
+
+  /// Staging parameters of @a actor_id, not shared with any snapshot.
+  /// staging_mutex must be locked.
+  VehicleParameters &GetStagingVehicle(const ActorId actor_id);
+
+  /// Apply @a update to the staging parameters, staging_mutex must be locked.
+  /// Returns whether the staging parameters changed.
+  bool StageUpdate(const ParameterUpdate &update);
+
 public:
   Parameters();
   ~Parameters();
 
+  /// Publish the parameters set since the last call, to be read by the stages
+  /// during this tick. Must be called before running the stages, from the
+  /// thread running them.
+  void UpdateSnapshot();
+
+  /// Behaviour parameters of a vehicle in the current snapshot.
+  const VehicleParameters &GetVehicleParameters(const ActorId &actor_id) const {
+    return snapshot->GetVehicle(actor_id);
+  }
+
+  /// Forget the parameters of a vehicle that left the simulation.
+  void RemoveVehicle(const ActorId actor_id);
+
   ////////////////////////////////// SETTERS /////////////////////////////////////
 
+  /// Apply every update in @a updates, in order, under a single lock.
+  void ApplyUpdates(const std::vector<ParameterUpdate> &updates);
+
   /// Set a vehicle's % decrease in velocity with respect to the speed limit.
   /// If less than 0, it's a % increase.
   void SetPercentageSpeedDifference(const ActorPtr &actor, const float percentage);
@@ -209,13 +273,13 @@ public:
   ChangeLaneInfo GetForceLaneChange(const ActorId &actor_id);
 
   /// Method to query percentage probability of keep right rule for a vehicle.
-  float GetKeepRightPercentage(const ActorId &actor_id);
+  float GetKeepRightPercentage(const ActorId &actor_id) const;
 
   /// Method to query percentage probability of a random right lane change for a vehicle.
-  float GetRandomLeftLaneChangePercentage(const ActorId &actor_id);
+  float GetRandomLeftLaneChangePercentage(const ActorId &actor_id) const;
 
   /// Method to query percentage probability of a random left lane change for a vehicle.
-  float GetRandomRightLaneChangePercentage(const ActorId &actor_id);
+  float GetRandomRightLaneChangePercentage(const ActorId &actor_id) const;
 
   /// Method to query auto lane change rule for a vehicle.
   bool GetAutoLaneChange(const ActorId &actor_id) const;
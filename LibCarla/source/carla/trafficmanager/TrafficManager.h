@@ -186,6 +186,15 @@ public:
     }
   }
 
+  /// Apply the parameter changes of many vehicles at once. For a remote
+  /// traffic manager they are sent in a single message.
+  void ApplyParameterUpdates(const std::vector<ParameterUpdate> &updates) {
+    TrafficManagerBase* tm_ptr = GetTM(_port);
+    if(tm_ptr != nullptr){
+      tm_ptr->ApplyParameterUpdates(updates);
+    }
+  }
+
   /// Set the automatic management of the vehicle lights
   void SetUpdateVehicleLights(const ActorPtr &actor, const bool do_update){
     TrafficManagerBase* tm_ptr = GetTM(_port);
@@ -349,6 +358,15 @@ public:
     return action_buffer;
   }
 
+  /// Method to get the hit and miss counters of the localization plan cache.
+  PlanCacheStats GetPlanCacheStats() {
+    TrafficManagerBase* tm_ptr = GetTM(_port);
+    if (tm_ptr != nullptr) {
+      return tm_ptr->GetPlanCacheStats();
+    }
+    return PlanCacheStats();
+  }
+
 private:
 
   void CreateTrafficManagerServer(
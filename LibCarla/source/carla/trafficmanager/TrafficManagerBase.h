@@ -8,6 +8,8 @@
 
 #include <memory>
 #include "carla/client/Actor.h"
+#include "carla/trafficmanager/DataStructures.h"
+#include "carla/trafficmanager/ParameterUpdate.h"
 #include "carla/trafficmanager/SimpleWaypoint.h"
 
 namespace carla {
@@ -58,6 +60,9 @@ public:
   /// If less than 0, it's a % increase.
   virtual void SetGlobalPercentageSpeedDifference(float const percentage) = 0;
 
+  /// Apply the parameter changes of many vehicles at once.
+  virtual void ApplyParameterUpdates(const std::vector<ParameterUpdate> &updates) = 0;
+
   /// Method to set the automatic management of the vehicle lights
   virtual void SetUpdateVehicleLights(const ActorPtr &actor, const bool do_update) = 0;
 
@@ -156,6 +161,9 @@ public:
   /// Method to get the vehicle's action buffer.
   virtual ActionBuffer GetActionBuffer(const ActorId &actor_id) = 0;
 
+  /// Method to get the hit and miss counters of the localization plan cache.
+  virtual PlanCacheStats GetPlanCacheStats() = 0;
+
   virtual void ShutDown() = 0;
 
 protected:
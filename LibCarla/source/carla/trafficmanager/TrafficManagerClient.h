@@ -6,10 +6,20 @@
 
 #pragma once
 
+#include "carla/Logging.h"
 #include "carla/trafficmanager/Constants.h"
+#include "carla/trafficmanager/DataStructures.h"
+#include "carla/trafficmanager/ParameterUpdate.h"
 #include "carla/rpc/Actor.h"
 
 #include <rpc/client.h>
+#include <rpc/config.h>
+
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <tuple>
+#include <vector>
 
 namespace carla {
 namespace traffic_manager {
@@ -22,11 +32,12 @@ class TrafficManagerClient {
 
 public:
 
-  TrafficManagerClient(const TrafficManagerClient &) = default;
-  TrafficManagerClient(TrafficManagerClient &&) = default;
+  /// Owns the RPC client and the pending responses, not copyable.
+  TrafficManagerClient(const TrafficManagerClient &) = delete;
+  TrafficManagerClient(TrafficManagerClient &&) = delete;
 
-  TrafficManagerClient &operator=(const TrafficManagerClient &) = default;
-  TrafficManagerClient &operator=(TrafficManagerClient &&) = default;
+  TrafficManagerClient &operator=(const TrafficManagerClient &) = delete;
+  TrafficManagerClient &operator=(TrafficManagerClient &&) = delete;
 
   /// Parametric constructor to initialize the parameters.
   TrafficManagerClient(
@@ -74,11 +85,14 @@ public:
     _client->call("unregister_vehicle", std::move(actor_list));
   }
 
-  /// Method to set a vehicle's % decrease in velocity with respect to the speed limit.
-  /// If less than 0, it's a % increase.
-  void SetPercentageSpeedDifference(const carla::rpc::Actor &_actor, const float percentage) {
+  /// Send the parameter changes of many vehicles in a single message. Does
+  /// not wait for the response, the server applies the messages of the
+  /// connection in order. Errors are logged on the next call. Thread-safe.
+  void ApplyParameterUpdates(const std::vector<ParameterUpdate> &updates) {
     DEBUG_ASSERT(_client != nullptr);
-    _client->call("set_percentage_speed_difference", std::move(_actor), percentage);
+    std::lock_guard<std::mutex> lock(_pending_mutex);
+    CheckPendingParameterUpdates();
+    _pending_parameter_updates.emplace_back(_client->async_call("apply_parameter_updates", updates));
   }
 
   /// Method to set a global % decrease in velocity with respect to the speed limit.
@@ -88,62 +102,12 @@ public:
     _client->call("set_global_percentage_speed_difference", percentage);
   }
 
-  /// Method to set the automatic management of the vehicle lights
-  void SetUpdateVehicleLights(const carla::rpc::Actor &_actor, const bool do_update) {
-    DEBUG_ASSERT(_client != nullptr);
-    _client->call("update_vehicle_lights", std::move(_actor), do_update);
-  }
-
   /// Method to set collision detection rules between vehicles.
   void SetCollisionDetection(const carla::rpc::Actor &reference_actor, const carla::rpc::Actor &other_actor, const bool detect_collision) {
     DEBUG_ASSERT(_client != nullptr);
     _client->call("set_collision_detection", reference_actor, other_actor, detect_collision);
   }
 
-  /// Method to force lane change on a vehicle.
-  /// Direction flag can be set to true for left and false for right.
-  void SetForceLaneChange(const carla::rpc::Actor &actor, const bool direction) {
-    DEBUG_ASSERT(_client != nullptr);
-    _client->call("set_force_lane_change", actor, direction);
-  }
-
-  /// Enable/disable automatic lane change on a vehicle.
-  void SetAutoLaneChange(const carla::rpc::Actor &actor, const bool enable) {
-    DEBUG_ASSERT(_client != nullptr);
-    _client->call("set_auto_lane_change", actor, enable);
-  }
-
-  /// Method to specify how much distance a vehicle should maintain to
-  /// the leading vehicle.
-  void SetDistanceToLeadingVehicle(const carla::rpc::Actor &actor, const float distance) {
-    DEBUG_ASSERT(_client != nullptr);
-    _client->call("set_distance_to_leading_vehicle", actor, distance);
-  }
-
-  /// Method to specify the % chance of ignoring collisions with any walker.
-  void SetPercentageIgnoreWalkers(const carla::rpc::Actor &actor, const float percentage) {
-    DEBUG_ASSERT(_client != nullptr);
-    _client->call("set_percentage_ignore_walkers", actor, percentage);
-  }
-
-  /// Method to specify the % chance of ignoring collisions with any vehicle.
-  void SetPercentageIgnoreVehicles(const carla::rpc::Actor &actor, const float percentage) {
-    DEBUG_ASSERT(_client != nullptr);
-    _client->call("set_percentage_ignore_vehicles", actor, percentage);
-  }
-
-  /// Method to specify the % chance of running a traffic sign.
-  void SetPercentageRunningLight(const carla::rpc::Actor &actor, const float percentage) {
-    DEBUG_ASSERT(_client != nullptr);
-    _client->call("set_percentage_running_light", actor, percentage);
-  }
-
-  /// Method to specify the % chance of running any traffic sign.
-  void SetPercentageRunningSign(const carla::rpc::Actor &actor, const float percentage) {
-    DEBUG_ASSERT(_client != nullptr);
-    _client->call("set_percentage_running_sign", actor, percentage);
-  }
-
   /// Method to switch traffic manager into synchronous execution.
   void SetSynchronousMode(const bool mode) {
     DEBUG_ASSERT(_client != nullptr);
@@ -175,24 +139,6 @@ public:
     _client->call("set_global_distance_to_leading_vehicle",distance);
   }
 
-  /// Method to set % to keep on the right lane.
-  void SetKeepRightPercentage(const carla::rpc::Actor &actor, const float percentage) {
-    DEBUG_ASSERT(_client != nullptr);
-    _client->call("keep_right_rule_percentage", actor, percentage);
-  }
-
-  /// Method to set % to randomly do a left lane change.
-  void SetRandomLeftLaneChangePercentage(const carla::rpc::Actor &actor, const float percentage) {
-    DEBUG_ASSERT(_client != nullptr);
-    _client->call("random_left_lanechange_percentage", actor, percentage);
-  }
-
-  /// Method to set % to randomly do a right lane change.
-  void SetRandomRightLaneChangePercentage(const carla::rpc::Actor &actor, const float percentage) {
-    DEBUG_ASSERT(_client != nullptr);
-    _client->call("random_right_lanechange_percentage", actor, percentage);
-  }
-
   /// Method to set hybrid physics mode.
   void SetHybridPhysicsMode(const bool mode_switch) {
     DEBUG_ASSERT(_client != nullptr);
@@ -285,6 +231,17 @@ public:
     return ActionBuffer();
   }
 
+  /// Method to get the hit and miss counters of the localization plan cache.
+  PlanCacheStats GetPlanCacheStats() {
+    DEBUG_ASSERT(_client != nullptr);
+    const auto counters = _client->call("get_plan_cache_stats").as<std::tuple<uint64_t, uint64_t, uint64_t>>();
+    PlanCacheStats stats;
+    stats.junction_hits = std::get<0>(counters);
+    stats.junction_misses = std::get<1>(counters);
+    stats.invalidations = std::get<2>(counters);
+    return stats;
+  }
+
   void ShutDown() {
     DEBUG_ASSERT(_client != nullptr);
     _client->call("shut_down");
@@ -292,9 +249,33 @@ public:
 
 private:
 
+  /// Log the errors of the parameter updates already answered by the server.
+  /// Requires _pending_mutex.
+  void CheckPendingParameterUpdates() {
+    auto it = _pending_parameter_updates.begin();
+    while (it != _pending_parameter_updates.end()) {
+      if (it->wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        ++it;
+        continue;
+      }
+      try {
+        it->get();
+      } catch (const std::exception &e) {
+        log_error("traffic manager: failed to apply parameter updates:", e.what());
+      }
+      it = _pending_parameter_updates.erase(it);
+    }
+  }
+
   /// RPC client.
   ::rpc::client *_client = nullptr;
 
+  /// Responses of the parameter updates not checked yet, setters may be
+  /// called from any thread.
+  std::vector<std::future<RPCLIB_MSGPACK::object_handle>> _pending_parameter_updates;
+
+  std::mutex _pending_mutex;
+
   /// Server port and host.
   std::string tmhost;
   uint16_t    tmport;
@@ -7,6 +7,7 @@
 #include <algorithm>
 
 #include "carla/Logging.h"
+#include "carla/profiler/Tracer.h"
 
 #include "carla/client/detail/Simulator.h"
 
@@ -140,6 +141,8 @@ void TrafficManagerLocal::Start() {
 
 void TrafficManagerLocal::Run() {
 
+  profiler::Tracer::SetThreadName("traffic manager");
+
   localization_frame.reserve(INITIAL_SIZE);
   collision_frame.reserve(INITIAL_SIZE);
   tl_frame.reserve(INITIAL_SIZE);
@@ -180,10 +183,16 @@ void TrafficManagerLocal::Run() {
       last_frame = timestamp.frame;
     }
 
+    CARLA_TRACE_SCOPE(traffic_manager, cycle);
+
     std::unique_lock<std::mutex> registration_lock(registration_mutex);
     // Updating simulation state, actor life cycle and performing necessary cleanup.
-    alsm.Update();
-
+    {
+      CARLA_TRACE_SCOPE(traffic_manager, alsm);
+      alsm.Update();
+    }
+    // Publishing the parameters set since the last cycle to the stages.
+    parameters.UpdateSnapshot();
 
     // Re-allocating inter-stage communication frames based on changed number of registered vehicles.
     int current_registered_vehicles_state = registered_vehicles.GetState();
@@ -225,35 +234,62 @@ void TrafficManagerLocal::Run() {
     control_frame.resize(number_of_vehicles);
 
     // Run core operation stages.
-    for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
-      localization_stage.Update(index);
+    {
+      CARLA_TRACE_SCOPE(traffic_manager, localization_stage);
+      for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
+        localization_stage.Update(index);
+      }
     }
-    for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
-      collision_stage.Update(index);
+    {
+      CARLA_TRACE_SCOPE(traffic_manager, collision_stage);
+      for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
+        collision_stage.Update(index);
+      }
+      collision_stage.ClearCycleCache();
     }
-    collision_stage.ClearCycleCache();
-    vehicle_light_stage.UpdateWorldInfo();
-    for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
-      traffic_light_stage.Update(index);
-      motion_plan_stage.Update(index);
-      vehicle_light_stage.Update(index);
+    {
+      CARLA_TRACE_SCOPE(traffic_manager, motion_plan_stage);
+      vehicle_light_stage.UpdateWorldInfo();
+      for (unsigned long index = 0u; index < vehicle_id_list.size(); ++index) {
+        traffic_light_stage.Update(index);
+        motion_plan_stage.Update(index);
+        vehicle_light_stage.Update(index);
+      }
     }
 
     registration_lock.unlock();
 
     // Sending the current cycle's batch command to the simulator.
     if (synchronous_mode) {
-      episode_proxy.Lock()->ApplyBatchSync(control_frame, false);
+      SendControlFrame();
       step_end.store(true);
       step_end_trigger.notify_one();
     } else {
       if (control_frame.size() > 0){
-        episode_proxy.Lock()->ApplyBatchSync(control_frame, false);
+        SendControlFrame();
       }
     }
   }
 }
 
+void TrafficManagerLocal::SendControlFrame() {
+  CARLA_TRACE_SCOPE(traffic_manager, send_control_frame);
+  // Vehicle controls are packed into contiguous arrays, the remaining
+  // commands (e.g. light states) are sent along with them.
+  vehicle_control_batch.clear();
+  vehicle_control_batch.reserve(control_frame.size());
+  residual_commands.clear();
+  for (const carla::rpc::Command &command : control_frame) {
+    const auto *control = boost::get<carla::rpc::Command::ApplyVehicleControl>(&command.command);
+    if (control != nullptr) {
+      vehicle_control_batch.Add(control->actor, control->control);
+    } else {
+      residual_commands.emplace_back(command);
+    }
+  }
+  episode_proxy.Lock()->ApplyVehicleControlBatch(vehicle_control_batch, residual_commands);
+}
+
 bool TrafficManagerLocal::SynchronousTick() {
   if (parameters.GetSynchronousMode()) {
     step_begin.store(true);
@@ -299,6 +335,8 @@ void TrafficManagerLocal::Stop() {
   collision_frame.clear();
   tl_frame.clear();
   control_frame.clear();
+  vehicle_control_batch.clear();
+  residual_commands.clear();
 
   run_traffic_manger.store(true);
   step_begin.store(false);
@@ -350,6 +388,10 @@ void TrafficManagerLocal::SetGlobalPercentageSpeedDifference(const float percent
   parameters.SetGlobalPercentageSpeedDifference(percentage);
 }
 
+void TrafficManagerLocal::ApplyParameterUpdates(const std::vector<ParameterUpdate> &updates) {
+  parameters.ApplyUpdates(updates);
+}
+
 /// Method to set the automatic management of the vehicle lights
 void TrafficManagerLocal::SetUpdateVehicleLights(const ActorPtr &actor, const bool do_update) {
   parameters.SetUpdateVehicleLights(actor, do_update);
@@ -459,6 +501,10 @@ ActionBuffer TrafficManagerLocal::GetActionBuffer(const ActorId &actor_id) {
   return localization_stage.ComputeActionBuffer(actor_id);
 }
 
+PlanCacheStats TrafficManagerLocal::GetPlanCacheStats() {
+  return localization_stage.GetPlanCacheStats();
+}
+
 bool TrafficManagerLocal::CheckAllFrozen(TLGroup tl_to_freeze) {
   for (auto &elem : tl_to_freeze) {
     if (!elem->IsFrozen() || elem->GetState() != TLS::Red) {
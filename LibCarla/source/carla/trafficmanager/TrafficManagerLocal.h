@@ -17,6 +17,7 @@
 #include "carla/client/World.h"
 #include "carla/Memory.h"
 #include "carla/rpc/Command.h"
+#include "carla/rpc/VehicleControlBatch.h"
 
 #include "carla/trafficmanager/AtomicActorSet.h"
 #include "carla/trafficmanager/InMemoryMap.h"
@@ -86,6 +87,10 @@ private:
   TLFrame tl_frame;
   /// Array to hold output data of motion planning.
   ControlFrame control_frame;
+  /// Vehicle controls of the control frame, packed to be sent to the simulator.
+  carla::rpc::VehicleControlBatch vehicle_control_batch;
+  /// Commands of the control frame other than vehicle controls.
+  ControlFrame residual_commands;
   /// Variable to keep track of currently reserved array space for frames.
   uint64_t current_reserved_capacity {0u};
   /// Various stages representing core operations of traffic manager.
@@ -118,6 +123,9 @@ private:
   /// Mutex to prevent vehicle registration during frame array re-allocation.
   std::mutex registration_mutex;
 
+  /// Method to send the control frame of the current cycle to the simulator.
+  void SendControlFrame();
+
   /// Method to check if all traffic lights are frozen in a group.
   bool CheckAllFrozen(TLGroup tl_to_freeze);
 
@@ -166,6 +174,9 @@ public:
   /// If less than 0, it's a % increase.
   void SetGlobalPercentageSpeedDifference(float const percentage);
 
+  /// Apply the parameter changes of many vehicles at once.
+  void ApplyParameterUpdates(const std::vector<ParameterUpdate> &updates);
+
   /// Method to set the automatic management of the vehicle lights
   void SetUpdateVehicleLights(const ActorPtr &actor, const bool do_update);
 
@@ -268,6 +279,9 @@ public:
   /// Method to get the vehicle's action buffer.
   ActionBuffer GetActionBuffer(const ActorId &actor_id);
 
+  /// Method to get the hit and miss counters of the localization plan cache.
+  PlanCacheStats GetPlanCacheStats();
+
   void ShutDown() {};
 };
 
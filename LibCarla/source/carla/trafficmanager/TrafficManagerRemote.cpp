@@ -106,9 +106,13 @@ void TrafficManagerRemote::UnregisterVehicles(const std::vector<ActorPtr> &_acto
 }
 
 void TrafficManagerRemote::SetPercentageSpeedDifference(const ActorPtr &_actor, const float percentage) {
-  carla::rpc::Actor actor(_actor->Serialize());
+  client.ApplyParameterUpdates({ParameterUpdate{_actor->GetId(), VehicleParameter::PercentageSpeedDifference, percentage}});
+}
 
-  client.SetPercentageSpeedDifference(actor, percentage);
+void TrafficManagerRemote::ApplyParameterUpdates(const std::vector<ParameterUpdate> &updates) {
+  if (!updates.empty()) {
+    client.ApplyParameterUpdates(updates);
+  }
 }
 
 void TrafficManagerRemote::SetGlobalPercentageSpeedDifference(const float percentage) {
@@ -116,9 +120,7 @@ void TrafficManagerRemote::SetGlobalPercentageSpeedDifference(const float percen
 }
 
 void TrafficManagerRemote::SetUpdateVehicleLights(const ActorPtr &_actor, const bool do_update) {
-  carla::rpc::Actor actor(_actor->Serialize());
-
-  client.SetUpdateVehicleLights(actor, do_update);
+  client.ApplyParameterUpdates({ParameterUpdate{_actor->GetId(), VehicleParameter::UpdateVehicleLights, do_update ? 1.0f : 0.0f}});
 }
 
 void TrafficManagerRemote::SetCollisionDetection(const ActorPtr &_reference_actor, const ActorPtr &_other_actor, const bool detect_collision) {
@@ -129,21 +131,15 @@ void TrafficManagerRemote::SetCollisionDetection(const ActorPtr &_reference_acto
 }
 
 void TrafficManagerRemote::SetForceLaneChange(const ActorPtr &_actor, const bool direction) {
-  carla::rpc::Actor actor(_actor->Serialize());
-
-  client.SetForceLaneChange(actor, direction);
+  client.ApplyParameterUpdates({ParameterUpdate{_actor->GetId(), VehicleParameter::ForceLaneChange, direction ? 1.0f : 0.0f}});
 }
 
 void TrafficManagerRemote::SetAutoLaneChange(const ActorPtr &_actor, const bool enable) {
-  carla::rpc::Actor actor(_actor->Serialize());
-
-  client.SetAutoLaneChange(actor, enable);
+  client.ApplyParameterUpdates({ParameterUpdate{_actor->GetId(), VehicleParameter::AutoLaneChange, enable ? 1.0f : 0.0f}});
 }
 
 void TrafficManagerRemote::SetDistanceToLeadingVehicle(const ActorPtr &_actor, const float distance) {
-  carla::rpc::Actor actor(_actor->Serialize());
-
-  client.SetDistanceToLeadingVehicle(actor, distance);
+  client.ApplyParameterUpdates({ParameterUpdate{_actor->GetId(), VehicleParameter::DistanceToLeadingVehicle, distance}});
 }
 
 void TrafficManagerRemote::SetGlobalDistanceToLeadingVehicle(const float distance) {
@@ -152,45 +148,31 @@ void TrafficManagerRemote::SetGlobalDistanceToLeadingVehicle(const float distanc
 
 
 void TrafficManagerRemote::SetPercentageIgnoreWalkers(const ActorPtr &_actor, const float percentage) {
-  carla::rpc::Actor actor(_actor->Serialize());
-
-  client.SetPercentageIgnoreWalkers(actor, percentage);
+  client.ApplyParameterUpdates({ParameterUpdate{_actor->GetId(), VehicleParameter::PercentageIgnoreWalkers, percentage}});
 }
 
 void TrafficManagerRemote::SetPercentageIgnoreVehicles(const ActorPtr &_actor, const float percentage) {
-  carla::rpc::Actor actor(_actor->Serialize());
-
-  client.SetPercentageIgnoreVehicles(actor, percentage);
+  client.ApplyParameterUpdates({ParameterUpdate{_actor->GetId(), VehicleParameter::PercentageIgnoreVehicles, percentage}});
 }
 
 void TrafficManagerRemote::SetPercentageRunningLight(const ActorPtr &_actor, const float percentage) {
-  carla::rpc::Actor actor(_actor->Serialize());
-
-  client.SetPercentageRunningLight(actor, percentage);
+  client.ApplyParameterUpdates({ParameterUpdate{_actor->GetId(), VehicleParameter::PercentageRunningLight, percentage}});
 }
 
 void TrafficManagerRemote::SetPercentageRunningSign(const ActorPtr &_actor, const float percentage) {
-  carla::rpc::Actor actor(_actor->Serialize());
-
-  client.SetPercentageRunningSign(actor, percentage);
+  client.ApplyParameterUpdates({ParameterUpdate{_actor->GetId(), VehicleParameter::PercentageRunningSign, percentage}});
 }
 
 void TrafficManagerRemote::SetKeepRightPercentage(const ActorPtr &_actor, const float percentage) {
-  carla::rpc::Actor actor(_actor->Serialize());
-
-  client.SetKeepRightPercentage(actor, percentage);
+  client.ApplyParameterUpdates({ParameterUpdate{_actor->GetId(), VehicleParameter::KeepRightPercentage, percentage}});
 }
 
 void TrafficManagerRemote::SetRandomLeftLaneChangePercentage(const ActorPtr &_actor, const float percentage) {
-  carla::rpc::Actor actor(_actor->Serialize());
-
-  client.SetRandomLeftLaneChangePercentage(actor, percentage);
+  client.ApplyParameterUpdates({ParameterUpdate{_actor->GetId(), VehicleParameter::RandomLeftLaneChangePercentage, percentage}});
 }
 
 void TrafficManagerRemote::SetRandomRightLaneChangePercentage(const ActorPtr &_actor, const float percentage) {
-  carla::rpc::Actor actor(_actor->Serialize());
-
-  client.SetRandomRightLaneChangePercentage(actor, percentage);
+  client.ApplyParameterUpdates({ParameterUpdate{_actor->GetId(), VehicleParameter::RandomRightLaneChangePercentage, percentage}});
 }
 
 void TrafficManagerRemote::SetHybridPhysicsMode(const bool mode_switch) {
@@ -265,6 +247,10 @@ ActionBuffer TrafficManagerRemote::GetActionBuffer(const ActorId &actor_id) {
   return client.GetActionBuffer(actor_id);
 }
 
+PlanCacheStats TrafficManagerRemote::GetPlanCacheStats() {
+  return client.GetPlanCacheStats();
+}
+
 bool TrafficManagerRemote::SynchronousTick() {
   return false;
 }
@@ -61,6 +61,10 @@ public:
   /// If less than 0, it's a % increase.
   void SetGlobalPercentageSpeedDifference(float const percentage);
 
+  /// Apply the parameter changes of many vehicles at once, sent in a single
+  /// message without waiting for the remote traffic manager.
+  void ApplyParameterUpdates(const std::vector<ParameterUpdate> &updates);
+
   /// Method to set the automatic management of the vehicle lights
   void SetUpdateVehicleLights(const ActorPtr &actor, const bool do_update);
 
@@ -152,6 +156,9 @@ public:
   /// Method to get the vehicle's action buffer.
   ActionBuffer GetActionBuffer(const ActorId &actor_id);
 
+  /// Method to get the hit and miss counters of the localization plan cache.
+  PlanCacheStats GetPlanCacheStats();
+
   /// Method to provide synchronous tick
   bool SynchronousTick();
 
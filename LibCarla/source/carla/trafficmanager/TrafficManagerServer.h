@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <tuple>
 #include <vector>
 
 #include "carla/Exception.h"
@@ -99,6 +100,11 @@ public:
         tm->SetUpdateVehicleLights(carla::client::detail::ActorVariant(actor).Get(tm->GetEpisodeProxy()), do_update);
       });
 
+      /// Method to apply the parameter changes of many vehicles at once.
+      server->bind("apply_parameter_updates", [=](const std::vector<ParameterUpdate> &updates) {
+        tm->ApplyParameterUpdates(updates);
+      });
+
       /// Method to set a global % decrease in velocity with respect to the speed limit.
       /// If less than 0, it's a % increase.
       server->bind("set_global_percentage_speed_difference", [=](const float percentage) {
@@ -235,6 +241,12 @@ public:
         tm->GetActionBuffer(actor_id);
       });
 
+      /// Method to get the hit and miss counters of the localization plan cache.
+      server->bind("get_plan_cache_stats", [=]() -> std::tuple<uint64_t, uint64_t, uint64_t> {
+        const PlanCacheStats stats = tm->GetPlanCacheStats();
+        return std::make_tuple(stats.junction_hits, stats.junction_misses, stats.invalidations);
+      });
+
       server->bind("shut_down", [=]() {
         tm->Release();
       });
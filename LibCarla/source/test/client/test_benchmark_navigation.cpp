@@ -0,0 +1,110 @@
+// Copyright (c) 2019 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#ifndef LIBCARLA_TEST_CONTENT_FOLDER
+#  error Please define LIBCARLA_TEST_CONTENT_FOLDER.
+#endif
+
+#include <carla/FileSystem.h>
+#include <carla/StopWatch.h>
+#include <carla/nav/Navigation.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+using namespace carla::nav;
+
+static const std::string NAV_FOLDER = LIBCARLA_TEST_CONTENT_FOLDER "/Nav/";
+
+static std::vector<std::string> get_available_nav_files() {
+  try {
+    return carla::FileSystem::ListFolder(NAV_FOLDER, "*.bin");
+  } catch (const std::exception &) {
+    return {};
+  }
+}
+
+static std::vector<uint8_t> load_nav_file(const std::string &filename) {
+  std::ifstream file(NAV_FOLDER + filename, std::ios::binary);
+  return std::vector<uint8_t>{
+      std::istreambuf_iterator<char>(file),
+      std::istreambuf_iterator<char>()};
+}
+
+static void benchmark_crowd(
+    const std::string &filename,
+    const size_t number_of_walkers,
+    const size_t route_workers) {
+  constexpr auto number_of_ticks = 400u;
+  constexpr double delta_seconds = 0.05;
+
+  Navigation nav;
+  ASSERT_TRUE(nav.Load(load_nav_file(filename)));
+  nav.SetMaxRouteWorkers(route_workers);
+  nav.SetSeed(42u);
+  nav.SetPedestriansCrossFactor(0.1f);
+
+  for (auto i = 0u; i < number_of_walkers; ++i) {
+    carla::geom::Location from;
+    carla::geom::Location to;
+    ASSERT_TRUE(nav.GetRandomLocation(from));
+    ASSERT_TRUE(nav.GetRandomLocation(to));
+    const carla::ActorId id = i + 1u;
+    nav.AddWalker(id, from);
+    nav.SetWalkerTarget(id, to);
+  }
+
+  size_t total_us = 0u;
+  size_t max_us = 0u;
+  for (auto i = 0u; i < number_of_ticks; ++i) {
+    carla::StopWatch stop_watch;
+    nav.UpdateCrowd(delta_seconds);
+    stop_watch.Stop();
+    const auto elapsed = stop_watch.GetElapsedTime<std::chrono::microseconds>();
+    total_us += elapsed;
+    max_us = std::max(max_us, elapsed);
+  }
+
+  carla::logging::log(
+      filename, ':',
+      number_of_walkers, "walkers,",
+      route_workers, "route workers,",
+      total_us / number_of_ticks, "us/tick average,",
+      max_us, "us/tick max.");
+}
+
+static void benchmark_crowd(const size_t number_of_walkers) {
+  const auto files = get_available_nav_files();
+  if (files.empty()) {
+    carla::log_warning("no navigation files found in", NAV_FOLDER, "skipping benchmark.");
+    return;
+  }
+  // same seed with sequential and parallel routes, the walkers follow the
+  // same paths so the difference is only the time spent in the re-targeting.
+  for (auto &file : files) {
+    benchmark_crowd(file, number_of_walkers, 1u);
+    benchmark_crowd(file, number_of_walkers, 4u);
+  }
+}
+
+TEST(benchmark_navigation, crowd_50_walkers) {
+  benchmark_crowd(50u);
+}
+
+TEST(benchmark_navigation, crowd_100_walkers) {
+  benchmark_crowd(100u);
+}
+
+TEST(benchmark_navigation, crowd_250_walkers) {
+  benchmark_crowd(250u);
+}
+
+TEST(benchmark_navigation, crowd_500_walkers) {
+  benchmark_crowd(500u);
+}
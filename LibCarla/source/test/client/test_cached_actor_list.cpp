@@ -0,0 +1,117 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/ThreadGroup.h>
+#include <carla/client/detail/CachedActorList.h>
+
+#include <atomic>
+#include <unordered_set>
+
+using carla::client::detail::CachedActorList;
+using carla::rpc::Actor;
+using carla::rpc::ActorId;
+
+static std::vector<Actor> MakeActors(const std::vector<ActorId> &ids) {
+  std::vector<Actor> result;
+  for (auto id : ids) {
+    Actor actor;
+    actor.id = id;
+    result.emplace_back(actor);
+  }
+  return result;
+}
+
+TEST(cached_actor_list, fetch_missing_ids_once) {
+  CachedActorList list;
+  list.InsertRange(MakeActors({1u, 2u}));
+  auto calls = 0u;
+  auto fetch = [&](const std::vector<ActorId> &ids) {
+    ++calls;
+    EXPECT_EQ(ids, (std::vector<ActorId>{5u, 3u}));
+    return MakeActors({3u, 5u});
+  };
+  const std::vector<ActorId> ids = {5u, 1u, 3u, 2u};
+  auto actors = list.GetActorsById(ids, fetch);
+  ASSERT_EQ(calls, 1u);
+  ASSERT_EQ(actors.size(), ids.size());
+  for (auto i = 0u; i < ids.size(); ++i) {
+    ASSERT_EQ(actors[i].id, ids[i]);
+  }
+  ASSERT_TRUE(list.GetMissingIds(ids).empty());
+  list.GetActorsById(ids, fetch);
+  ASSERT_EQ(calls, 1u);
+}
+
+TEST(cached_actor_list, evict_dead_actors) {
+  CachedActorList list;
+  list.InsertRange(MakeActors({1u, 2u, 3u}));
+  std::unordered_set<ActorId> alive = {1u, 3u};
+  auto is_alive = [&](ActorId id) { return alive.count(id) > 0u; };
+
+  // actors inserted before the first generation are not evicted by it.
+  list.Evict(1u, is_alive);
+  ASSERT_EQ(list.size(), 3u);
+  list.Evict(2u, is_alive);
+  ASSERT_EQ(list.size(), 2u);
+  ASSERT_FALSE(list.GetActorById(2u).has_value());
+
+  // spawned while generation 3 was in flight.
+  list.Insert(MakeActors({4u}).front());
+  list.Evict(3u, is_alive);
+  ASSERT_TRUE(list.GetActorById(4u).has_value());
+  list.Evict(4u, is_alive);
+  ASSERT_FALSE(list.GetActorById(4u).has_value());
+  ASSERT_EQ(list.size(), 2u);
+}
+
+TEST(cached_actor_list, evict_after_episode_change) {
+  CachedActorList list;
+  std::unordered_set<ActorId> alive = {1u};
+  auto is_alive = [&](ActorId id) { return alive.count(id) > 0u; };
+  list.InsertRange(MakeActors({1u, 2u}));
+  list.Evict(1000u, is_alive);
+  list.Evict(1001u, is_alive);
+  ASSERT_EQ(list.size(), 1u);
+
+  // the new episode starts counting frames from the beginning.
+  list.Clear();
+  ASSERT_EQ(list.size(), 0u);
+  list.InsertRange(MakeActors({3u, 4u}));
+  alive = {3u};
+  list.Evict(5u, is_alive);
+  list.Evict(6u, is_alive);
+  ASSERT_EQ(list.size(), 1u);
+  ASSERT_TRUE(list.GetActorById(3u).has_value());
+  ASSERT_FALSE(list.GetActorById(4u).has_value());
+}
+
+TEST(cached_actor_list, concurrent_readers) {
+  constexpr ActorId number_of_actors = 200u;
+  CachedActorList list;
+  std::atomic_bool done{false};
+  carla::ThreadGroup readers;
+  readers.CreateThreads(4u, [&]() {
+    while (!done) {
+      for (ActorId id = 1u; id <= number_of_actors; ++id) {
+        auto actor = list.GetActorById(id);
+        if (actor.has_value()) {
+          ASSERT_EQ(actor->id, id);
+        }
+      }
+    }
+  });
+  for (uint64_t generation = 1u; generation <= 200u; ++generation) {
+    // every generation the actor with id == generation spawns and the
+    // previous one dies.
+    list.Insert(MakeActors({static_cast<ActorId>(generation)}).front());
+    list.Evict(generation, [=](ActorId id) { return id == generation; });
+  }
+  done = true;
+  readers.JoinAll();
+  ASSERT_LE(list.size(), 2u);
+}
@@ -0,0 +1,150 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/sensor/DVSSimulator.h>
+#include <carla/sensor/data/DVSEventAccumulator.h>
+
+#include <thread>
+#include <vector>
+
+using carla::sensor::DVSSimulator;
+using carla::sensor::data::Color;
+using carla::sensor::data::DVSEvent;
+using carla::sensor::data::DVSEventAccumulator;
+
+static std::vector<DVSEvent> MakeEvents() {
+  return {
+    DVSEvent{0u, 0u, 100, true},
+    DVSEvent{2u, 1u, 150, false},
+    DVSEvent{2u, 1u, 200, false},
+    DVSEvent{1u, 0u, 300, true}};
+}
+
+TEST(dvs_events, copy_fields) {
+  const auto events = MakeEvents();
+  std::vector<uint16_t> x(events.size());
+  std::vector<uint16_t> y(events.size());
+  std::vector<int64_t> t(events.size());
+  std::vector<int16_t> pol(events.size());
+  DVSEventAccumulator::CopyFields(events, x.data(), y.data(), t.data(), pol.data());
+  ASSERT_EQ(x, (std::vector<uint16_t>{0u, 2u, 2u, 1u}));
+  ASSERT_EQ(y, (std::vector<uint16_t>{0u, 1u, 1u, 0u}));
+  ASSERT_EQ(t, (std::vector<int64_t>{100, 150, 200, 300}));
+  ASSERT_EQ(pol, (std::vector<int16_t>{1, -1, -1, 1}));
+}
+
+TEST(dvs_events, event_frame) {
+  const auto events = MakeEvents();
+  std::vector<int32_t> frame(3u * 2u, 42);
+  DVSEventAccumulator::AccumulateFrame(events, 3u, 2u, frame.data());
+  ASSERT_EQ(frame, (std::vector<int32_t>{1, 1, 0, 0, 0, -2}));
+  DVSEventAccumulator::AccumulateFrame(events, 3u, 2u, 150, 300, frame.data());
+  ASSERT_EQ(frame, (std::vector<int32_t>{0, 0, 0, 0, 0, -2}));
+}
+
+TEST(dvs_events, voxel_grid) {
+  const auto events = MakeEvents();
+  constexpr size_t bins = 3u;
+  std::vector<float> grid(bins * 3u * 2u, 42.0f);
+  DVSEventAccumulator::AccumulateVoxelGrid(events, 3u, 2u, bins, grid.data());
+  // time span [100, 300] is mapped to [0, 2].
+  auto at = [&](size_t bin, size_t x, size_t y) { return grid[bin * 6u + 3u * y + x]; };
+  ASSERT_FLOAT_EQ(at(0u, 0u, 0u), 1.0f);
+  ASSERT_FLOAT_EQ(at(2u, 1u, 0u), 1.0f);
+  ASSERT_FLOAT_EQ(at(0u, 2u, 1u), -0.5f);
+  ASSERT_FLOAT_EQ(at(1u, 2u, 1u), -1.5f);
+  ASSERT_FLOAT_EQ(at(2u, 2u, 1u), 0.0f);
+  float total = 0.0f;
+  for (auto value : grid) {
+    total += value;
+  }
+  ASSERT_FLOAT_EQ(total, 0.0f);
+}
+
+static std::vector<Color> MakeGrayImage(size_t size, uint8_t value) {
+  Color color;
+  color.r = color.g = color.b = value;
+  return std::vector<Color>(size, color);
+}
+
+TEST(dvs_events, simulator_thresholds) {
+  DVSSimulator::Config config;
+  config.use_log = false;
+  config.positive_threshold = 10.0f;
+  config.negative_threshold = 20.0f;
+  DVSSimulator simulator(config);
+  auto dark = MakeGrayImage(4u * 3u, 100u);
+  auto bright = MakeGrayImage(4u * 3u, 135u);
+  bright[5u] = dark[5u];
+
+  // the first frame only sets the reference.
+  ASSERT_TRUE(simulator.Simulate(dark.data(), 4u, 3u, 1000).empty());
+
+  auto events = simulator.Simulate(bright.data(), 4u, 3u, 2000);
+  ASSERT_EQ(events.size(), 3u * 11u);
+  for (auto i = 1u; i < events.size(); ++i) {
+    ASSERT_LE(events[i - 1u].t, events[i].t);
+  }
+  for (const auto &event : events) {
+    ASSERT_TRUE(event.pol);
+    ASSERT_FALSE((event.x == 1u) && (event.y == 1u));
+    ASSERT_GT(event.t, 1000);
+    ASSERT_LE(event.t, 2000);
+  }
+
+  events = simulator.Simulate(dark.data(), 4u, 3u, 3000);
+  ASSERT_EQ(events.size(), 11u);
+  for (const auto &event : events) {
+    ASSERT_FALSE(event.pol);
+  }
+}
+
+TEST(dvs_events, simulator_deterministic) {
+  constexpr size_t width = 32u;
+  constexpr size_t height = 4u * DVSSimulator::RowsPerBlock + 3u;
+  DVSSimulator::Config config;
+  config.sigma_positive_threshold = 0.1f;
+  config.sigma_negative_threshold = 0.1f;
+  config.seed = 42u;
+
+  std::vector<std::vector<Color>> frames;
+  for (auto f = 0u; f < 4u; ++f) {
+    std::vector<Color> frame(width * height);
+    for (auto i = 0u; i < frame.size(); ++i) {
+      frame[i].r = frame[i].g = frame[i].b = static_cast<uint8_t>((i * 7u + f * 50u * (i % 3u)) % 256u);
+    }
+    frames.emplace_back(std::move(frame));
+  }
+
+  auto run = [&](auto &&parallel_for) {
+    DVSSimulator simulator(config);
+    std::vector<DVSEvent> result;
+    for (auto f = 0u; f < frames.size(); ++f) {
+      auto events = simulator.Simulate(frames[f].data(), width, height, 1000 * f, parallel_for);
+      result.insert(result.end(), events.begin(), events.end());
+    }
+    return result;
+  };
+
+  auto serial = run([](size_t count, auto &&body) {
+    for (auto i = 0u; i < count; ++i) {
+      body(i);
+    }
+  });
+  auto threaded = run([](size_t count, auto &&body) {
+    std::vector<std::thread> threads;
+    for (auto i = 0u; i < count; ++i) {
+      threads.emplace_back([&body, count, i]() { body(count - i - 1u); });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  });
+  ASSERT_FALSE(serial.empty());
+  ASSERT_EQ(serial, threaded);
+}
@@ -0,0 +1,128 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/ThreadGroup.h>
+#include <carla/client/detail/FrameBarrier.h>
+
+#include <ctime>
+
+using namespace std::chrono_literals;
+using carla::client::detail::FrameBarrier;
+
+TEST(frame_barrier, wait_and_timeout) {
+  FrameBarrier barrier;
+  ASSERT_TRUE(barrier.WaitFor(0u, 0ms));
+  ASSERT_FALSE(barrier.WaitFor(1u, 10ms));
+
+  barrier.Publish(5u);
+  ASSERT_TRUE(barrier.WaitFor(3u, 0ms));
+  ASSERT_TRUE(barrier.WaitFor(5u, 0ms));
+  ASSERT_FALSE(barrier.WaitFor(6u, 10ms));
+
+  // older frames do not move the barrier back.
+  barrier.Publish(2u);
+  ASSERT_EQ(barrier.GetLastFrame(), 5u);
+}
+
+TEST(frame_barrier, reset_on_new_episode) {
+  FrameBarrier barrier;
+  barrier.Publish(100u);
+  ASSERT_TRUE(barrier.WaitFor(100u, 0ms));
+
+  // a new episode starts counting frames from a lower number.
+  barrier.Reset(3u);
+  ASSERT_EQ(barrier.GetLastFrame(), 3u);
+  ASSERT_FALSE(barrier.WaitFor(4u, 10ms));
+  barrier.Publish(4u);
+  ASSERT_TRUE(barrier.WaitFor(4u, 0ms));
+  ASSERT_FALSE(barrier.WaitFor(5u, 10ms));
+}
+
+TEST(frame_barrier, wakes_up_all_waiters) {
+  FrameBarrier barrier;
+  carla::ThreadGroup threads;
+  std::atomic_size_t count{0u};
+  constexpr size_t number_of_threads = 8u;
+  threads.CreateThreads(number_of_threads, [&]() {
+    ASSERT_TRUE(barrier.WaitFor(10u, 1s));
+    ++count;
+  });
+  std::this_thread::sleep_for(20ms);
+  for (auto frame = 1u; frame < 10u; ++frame) {
+    barrier.Publish(frame);
+  }
+  ASSERT_EQ(count, 0u);
+  barrier.Publish(10u);
+  threads.JoinAll();
+  ASSERT_EQ(count, number_of_threads);
+}
+
+/// Emulates a client ticking a synchronous simulator. The "server" publishes
+/// the next frame a fixed time after each tick cue, the client waits for it
+/// either spinning (as SynchronizeFrame used to) or on the frame barrier.
+template <typename WaitT>
+static void benchmark_tick(const char *name, WaitT &&wait) {
+  constexpr auto number_of_ticks = 200u;
+  constexpr auto frame_time = 2ms;
+
+  std::atomic<uint64_t> cue{0u};
+  std::atomic_bool done{false};
+  std::atomic<int64_t> published_at{0};
+  FrameBarrier barrier;
+  carla::ThreadGroup server;
+  server.CreateThread([&]() {
+    uint64_t frame = 0u;
+    while (!done) {
+      if (cue.load() > frame) {
+        std::this_thread::sleep_for(frame_time);
+        ++frame;
+        published_at = std::chrono::steady_clock::now().time_since_epoch().count();
+        barrier.Publish(frame);
+      } else {
+        std::this_thread::sleep_for(100us);
+      }
+    }
+  });
+
+  const auto cpu_start = std::clock();
+  const auto wall_start = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::duration total_latency{0};
+  std::chrono::steady_clock::duration max_latency{0};
+  for (auto frame = 1u; frame <= number_of_ticks; ++frame) {
+    cue = frame;
+    ASSERT_TRUE(wait(barrier, frame));
+    const auto latency =
+        std::chrono::steady_clock::now().time_since_epoch() -
+        std::chrono::steady_clock::duration(published_at.load());
+    total_latency += latency;
+    max_latency = std::max(max_latency, latency);
+  }
+  const auto cpu_time = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+  const auto wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+  done = true;
+  server.JoinAll();
+
+  using us = std::chrono::microseconds;
+  carla::logging::log(
+      name, ':',
+      static_cast<int>(100.0 * cpu_time / wall_time), "% cpu,",
+      std::chrono::duration_cast<us>(total_latency).count() / number_of_ticks, "us average wake up latency,",
+      std::chrono::duration_cast<us>(max_latency).count(), "us max.");
+}
+
+TEST(frame_barrier, benchmark_sync_tick) {
+  benchmark_tick("spin-yield", [](FrameBarrier &barrier, uint64_t frame) {
+    while (frame > barrier.GetLastFrame()) {
+      std::this_thread::yield();
+    }
+    return true;
+  });
+  benchmark_tick("frame barrier", [](FrameBarrier &barrier, uint64_t frame) {
+    return barrier.WaitFor(frame, 1s);
+  });
+}
@@ -0,0 +1,99 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/pointcloud/PointCloudAccumulator.h>
+#include <carla/sensor/data/SemanticLidarData.h>
+
+#include <vector>
+
+using carla::geom::Location;
+using carla::geom::Rotation;
+using carla::geom::Transform;
+using carla::pointcloud::PointCloudAccumulator;
+using carla::sensor::data::SemanticLidarDetection;
+
+static SemanticLidarDetection MakeDetection(float x, float y, float z, uint32_t tag) {
+  return SemanticLidarDetection{x, y, z, 1.0f, 0u, tag};
+}
+
+TEST(pointcloud, accumulator_transform) {
+  const Transform transform{Location{10.0f, 0.0f, 2.0f}, Rotation{0.0f, 90.0f, 0.0f}};
+  const std::vector<SemanticLidarDetection> points = {
+    MakeDetection(1.0f, 0.0f, 0.0f, 1u),
+    MakeDetection(0.0f, 2.0f, 1.0f, 2u)};
+  PointCloudAccumulator accumulator;
+  accumulator.Add(transform, points.begin(), points.end());
+  ASSERT_EQ(accumulator.GetNumberOfPoints(), 2u);
+
+  std::vector<float> xyz(6u);
+  std::vector<uint32_t> tags(2u);
+  accumulator.CopyPoints(xyz.data(), tags.data());
+  for (auto i = 0u; i < points.size(); ++i) {
+    auto expected = points[i].point;
+    transform.TransformPoint(expected);
+    ASSERT_NEAR(xyz[3u * i + 0u], expected.x, 1e-4f);
+    ASSERT_NEAR(xyz[3u * i + 1u], expected.y, 1e-4f);
+    ASSERT_NEAR(xyz[3u * i + 2u], expected.z, 1e-4f);
+  }
+  ASSERT_EQ(tags, (std::vector<uint32_t>{1u, 2u}));
+}
+
+TEST(pointcloud, accumulator_window) {
+  PointCloudAccumulator accumulator(2u);
+  for (auto i = 0u; i < 5u; ++i) {
+    const std::vector<SemanticLidarDetection> points(i + 1u, MakeDetection(0.0f, 0.0f, 0.0f, i));
+    accumulator.Add(Transform{}, points.begin(), points.end());
+  }
+  ASSERT_EQ(accumulator.GetNumberOfFrames(), 2u);
+  ASSERT_EQ(accumulator.GetNumberOfPoints(), 4u + 5u);
+  accumulator.SetWindowSize(1u);
+  ASSERT_EQ(accumulator.GetNumberOfPoints(), 5u);
+  accumulator.Clear();
+  ASSERT_EQ(accumulator.GetNumberOfPoints(), 0u);
+}
+
+TEST(pointcloud, accumulator_voxel_grid) {
+  const std::vector<SemanticLidarDetection> first = {
+    MakeDetection(0.1f, 0.1f, 0.1f, 7u),
+    MakeDetection(0.3f, 0.3f, 0.3f, 4u),
+    MakeDetection(-0.5f, 0.5f, 0.5f, 3u)};
+  const std::vector<SemanticLidarDetection> second = {
+    MakeDetection(0.5f, 0.5f, 0.5f, 4u),
+    MakeDetection(2.5f, 0.5f, 0.5f, 9u)};
+  PointCloudAccumulator accumulator;
+  accumulator.Add(Transform{}, first.begin(), first.end());
+  accumulator.Add(Transform{}, second.begin(), second.end());
+
+  const auto grid = accumulator.Downsample(1.0f);
+  ASSERT_EQ(grid.size(), 3u);
+  ASSERT_EQ(grid.points.size(), 9u);
+  // Voxels sorted by key, the x coordinate is the most significant.
+  ASSERT_EQ(grid.tags, (std::vector<uint32_t>{3u, 4u, 9u}));
+  ASSERT_EQ(grid.counts, (std::vector<uint32_t>{1u, 3u, 1u}));
+  ASSERT_NEAR(grid.points[3u], 0.3f, 1e-5f);
+  ASSERT_NEAR(grid.points[4u], 0.3f, 1e-5f);
+  ASSERT_NEAR(grid.points[5u], 0.3f, 1e-5f);
+  ASSERT_NEAR(grid.points[6u], 2.5f, 1e-5f);
+
+  ASSERT_THROW(accumulator.Downsample(0.0f), std::invalid_argument);
+}
+
+TEST(pointcloud, accumulator_voxel_grid_range) {
+  // At 1 cm voxels the grid spans about 10 km in each direction.
+  const std::vector<SemanticLidarDetection> near = {
+    MakeDetection(-10000.0f, 10000.0f, 0.0f, 1u)};
+  const std::vector<SemanticLidarDetection> far = {
+    MakeDetection(20000.0f, 0.0f, 0.0f, 2u)};
+  PointCloudAccumulator accumulator;
+  accumulator.Add(Transform{}, near.begin(), near.end());
+  ASSERT_EQ(accumulator.Downsample(0.01f).size(), 1u);
+  accumulator.Add(Transform{}, far.begin(), far.end());
+  ASSERT_THROW(accumulator.Downsample(0.01f), std::invalid_argument);
+  // Coarser voxels cover it.
+  ASSERT_EQ(accumulator.Downsample(1.0f).size(), 2u);
+}
@@ -0,0 +1,111 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/pointcloud/PointCloudIO.h>
+#include <carla/pointcloud/PointCloudWriter.h>
+#include <carla/sensor/data/LidarData.h>
+#include <carla/sensor/data/SemanticLidarData.h>
+
+#include <boost/filesystem.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <sstream>
+#include <vector>
+
+using carla::pointcloud::PointCloudFormat;
+using carla::pointcloud::PointCloudIO;
+using carla::pointcloud::PointCloudWriter;
+using carla::sensor::data::LidarDetection;
+using carla::sensor::data::SemanticLidarDetection;
+
+static const std::string EndHeader = "end_header\n";
+
+template <typename T>
+static std::vector<T> ReadBinaryPly(const std::string &ply) {
+  auto pos = ply.find(EndHeader);
+  EXPECT_NE(pos, std::string::npos);
+  pos += EndHeader.size();
+  EXPECT_EQ((ply.size() - pos) % sizeof(T), 0u);
+  std::vector<T> points((ply.size() - pos) / sizeof(T));
+  std::memcpy(points.data(), ply.data() + pos, points.size() * sizeof(T));
+  return points;
+}
+
+static std::vector<SemanticLidarDetection> MakeSemanticPoints() {
+  return {
+    SemanticLidarDetection{1.0f, 2.0f, 3.0f, 0.5f, 10u, 7u},
+    SemanticLidarDetection{-1.0f, 0.25f, 8.0f, 1.0f, 11u, 4u}};
+}
+
+static void ExpectEqual(
+    const std::vector<SemanticLidarDetection> &lhs,
+    const std::vector<SemanticLidarDetection> &rhs) {
+  ASSERT_EQ(lhs.size(), rhs.size());
+  for (auto i = 0u; i < lhs.size(); ++i) {
+    ASSERT_EQ(lhs[i].point, rhs[i].point);
+    ASSERT_EQ(lhs[i].cos_inc_angle, rhs[i].cos_inc_angle);
+    ASSERT_EQ(lhs[i].object_idx, rhs[i].object_idx);
+    ASSERT_EQ(lhs[i].object_tag, rhs[i].object_tag);
+  }
+}
+
+TEST(pointcloud, binary_ply) {
+  const auto points = MakeSemanticPoints();
+  std::ostringstream out;
+  PointCloudIO::DumpBinary(out, points.data(), points.data() + points.size());
+  const auto ply = out.str();
+  ASSERT_EQ(ply.find("ply\nformat binary_little_endian 1.0\nelement vertex 2\n"), 0u);
+  ASSERT_NE(ply.find("property uint32 ObjTag\nend_header\n"), std::string::npos);
+  ExpectEqual(ReadBinaryPly<SemanticLidarDetection>(ply), points);
+
+  // Non-contiguous points are written one by one.
+  const std::list<SemanticLidarDetection> list(points.begin(), points.end());
+  std::ostringstream list_out;
+  PointCloudIO::DumpBinary(list_out, list.begin(), list.end());
+  ASSERT_EQ(list_out.str(), ply);
+}
+
+TEST(pointcloud, empty_binary_ply) {
+  const std::vector<LidarDetection> points;
+  std::ostringstream out;
+  PointCloudIO::DumpBinary(out, points.begin(), points.end());
+  const auto ply = out.str();
+  ASSERT_NE(ply.find("element vertex 0\nproperty float32 x\n"), std::string::npos);
+  ASSERT_EQ(ply.substr(ply.size() - EndHeader.size()), EndHeader);
+}
+
+TEST(pointcloud, async_writer) {
+  namespace fs = boost::filesystem;
+  const auto folder = fs::temp_directory_path() / fs::unique_path();
+  const auto points = MakeSemanticPoints();
+  std::vector<std::string> paths;
+  {
+    PointCloudWriter writer(2u);
+    for (auto i = 0u; i < 8u; ++i) {
+      const auto path = (folder / std::to_string(i)).string();
+      paths.emplace_back(writer.Write(
+          path,
+          points.begin(),
+          points.end(),
+          PointCloudFormat::BinaryLittleEndian));
+      ASSERT_LE(writer.GetNumberOfPendingWrites(), 2u);
+    }
+    writer.Flush();
+    ASSERT_EQ(writer.GetNumberOfPendingWrites(), 0u);
+  }
+  for (const auto &path : paths) {
+    ASSERT_EQ(fs::path(path).extension(), ".ply");
+    std::ifstream file(path, std::ios::binary);
+    const std::string ply{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    ExpectEqual(ReadBinaryPly<SemanticLidarDetection>(ply), points);
+  }
+  fs::remove_all(folder);
+}
@@ -0,0 +1,406 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "OpenDrive.h"
+#include "Random.h"
+
+#include <carla/StopWatch.h>
+#include <carla/opendrive/OpenDriveParser.h>
+#include <carla/road/Map.h>
+#include <carla/road/RoutingGraph.h>
+#include <carla/road/element/RoadInfoMarkRecord.h>
+#include <carla/road/element/RoadInfoSpeed.h>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <queue>
+#include <sstream>
+#include <tuple>
+#include <vector>
+
+using namespace carla::road;
+using carla::opendrive::OpenDriveParser;
+
+static const auto INF = std::numeric_limits<double>::infinity();
+
+using LaneKey = std::tuple<RoadId, SectionId, LaneId>;
+
+static LaneKey key_of(const element::Waypoint &waypoint) {
+  return std::make_tuple(waypoint.road_id, waypoint.section_id, waypoint.lane_id);
+}
+
+/// Speed limit of @a lane at @a s in m/s.
+static double speed_limit(const Lane &lane, double s, double default_speed_limit) {
+  const element::RoadInfoSpeed *info = lane.GetInfo<element::RoadInfoSpeed>(s);
+  if (info == nullptr && lane.GetRoad() != nullptr) {
+    info = lane.GetRoad()->GetInfo<element::RoadInfoSpeed>(s);
+  }
+  return ((info != nullptr && info->GetSpeed() > 0.0) ? info->GetSpeed() : default_speed_limit) / 3.6;
+}
+
+/// Lane changes allowed at @a waypoint, same rules as
+/// client::Waypoint::GetLaneChange.
+static uint8_t allowed_lane_change(const Map &map, const element::Waypoint &waypoint) {
+  using LaneChange = element::LaneMarking::LaneChange;
+  const auto right = static_cast<uint8_t>(LaneChange::Right);
+  const auto left = static_cast<uint8_t>(LaneChange::Left);
+  auto get = [](const element::RoadInfoMarkRecord *marking) {
+    return marking != nullptr ?
+        static_cast<uint8_t>(marking->GetLaneChange()) :
+        static_cast<uint8_t>(LaneChange::Both);
+  };
+  auto swap = [&](uint8_t value) {
+    return static_cast<uint8_t>(((value & right) != 0u ? left : 0u) | ((value & left) != 0u ? right : 0u));
+  };
+  const auto marks = map.GetMarkRecord(waypoint);
+  auto c_right = get(marks.first);
+  auto c_left = get(marks.second);
+  if (waypoint.lane_id > 0) {
+    c_right = swap(c_right);
+  }
+  if (((waypoint.lane_id > 0) ? waypoint.lane_id - 1 : waypoint.lane_id + 1) > 0) {
+    c_left = swap(c_left);
+  }
+  return static_cast<uint8_t>((c_right & right) | (c_left & left));
+}
+
+/// Plain model of the lanes of a map, positions along a lane are the fraction
+/// of the lane driven, in [0, 1].
+struct LaneModel {
+
+  struct LaneData {
+    element::Waypoint entry;
+    double distance;
+    double length;
+    /// Cost of driving the whole lane.
+    double cost;
+    std::vector<LaneKey> successors;
+    /// Lanes reachable changing lanes and the cost of the lane change.
+    std::vector<std::pair<LaneKey, double>> lane_changes;
+  };
+
+  std::map<LaneKey, LaneData> lanes;
+
+  /// Lane changes are allowed outside junctions towards lanes going in the
+  /// same direction, only if @a parameters.lane_change_cost is finite.
+  LaneModel(const Map &map, RoutingGraph::Metric metric, const RoutingGraph::Parameters &parameters) {
+    const auto topology = map.GenerateTopology();
+    for (auto &&pair : topology) {
+      for (auto &&waypoint : {pair.first, pair.second}) {
+        const auto &lane = map.GetLane(waypoint);
+        const double speed = speed_limit(
+            lane,
+            lane.GetDistance() + 0.5 * lane.GetLength(),
+            parameters.default_speed_limit);
+        lanes.emplace(key_of(waypoint), LaneData{
+            waypoint,
+            lane.GetDistance(),
+            lane.GetLength(),
+            metric == RoutingGraph::Metric::Distance ? lane.GetLength() : lane.GetLength() / speed,
+            {},
+            {}});
+      }
+    }
+    for (auto &&pair : topology) {
+      lanes[key_of(pair.first)].successors.emplace_back(key_of(pair.second));
+    }
+    if (parameters.lane_change_cost == INF) {
+      return;
+    }
+    using LaneChange = element::LaneMarking::LaneChange;
+    for (auto &&item : lanes) {
+      auto &data = item.second;
+      if (map.IsJunction(data.entry.road_id)) {
+        continue;
+      }
+      auto middle = data.entry;
+      middle.s = data.distance + 0.5 * data.length;
+      const double cost = metric == RoutingGraph::Metric::Distance ?
+          parameters.lane_change_cost :
+          parameters.lane_change_cost * data.cost / data.length;
+      const auto allowed = allowed_lane_change(map, middle);
+      auto add = [&](boost::optional<element::Waypoint> neighbour, LaneChange direction) {
+        if (neighbour.has_value() &&
+            ((allowed & static_cast<uint8_t>(direction)) != 0u) &&
+            ((neighbour->lane_id > 0) == (data.entry.lane_id > 0)) &&
+            (lanes.find(key_of(*neighbour)) != lanes.end())) {
+          data.lane_changes.emplace_back(key_of(*neighbour), cost);
+        }
+      };
+      add(map.GetRight(middle), LaneChange::Right);
+      add(map.GetLeft(middle), LaneChange::Left);
+    }
+  }
+
+  double fraction(const element::Waypoint &waypoint) const {
+    const auto &data = lanes.at(key_of(waypoint));
+    const double driven = waypoint.lane_id > 0 ?
+        data.distance + data.length - waypoint.s :
+        waypoint.s - data.distance;
+    return std::min(1.0, std::max(0.0, driven / data.length));
+  }
+
+  element::Waypoint at(const LaneKey &key, double fraction) const {
+    const auto &data = lanes.at(key);
+    auto waypoint = data.entry;
+    if (fraction > 0.0) {
+      waypoint.s = data.entry.lane_id > 0 ?
+          data.distance + (1.0 - fraction) * data.length :
+          data.distance + fraction * data.length;
+    }
+    return waypoint;
+  }
+
+  const std::pair<LaneKey, double> *find_lane_change(const LaneKey &from, const LaneKey &to) const {
+    for (auto &&change : lanes.at(from).lane_changes) {
+      if (change.first == to) {
+        return &change;
+      }
+    }
+    return nullptr;
+  }
+
+  /// Plain Dijkstra over (lane, fraction) states, lanes can be changed at
+  /// the entry and the exit of the lanes, at the origin and at the
+  /// destination, which are the only candidates for an optimal lane change.
+  double shortest(const element::Waypoint &origin, const element::Waypoint &destination) const {
+    auto same_section = [](const LaneKey &lhs, const element::Waypoint &rhs) {
+      return (std::get<0>(lhs) == rhs.road_id) && (std::get<1>(lhs) == rhs.section_id);
+    };
+    const double origin_fraction = fraction(origin);
+    const double destination_fraction = fraction(destination);
+    std::map<LaneKey, std::vector<double>> fractions;
+    for (auto &&item : lanes) {
+      auto &list = fractions[item.first];
+      list = {0.0, 1.0};
+      if (same_section(item.first, origin)) {
+        list.emplace_back(origin_fraction);
+      }
+      if (same_section(item.first, destination)) {
+        list.emplace_back(destination_fraction);
+      }
+      std::sort(list.begin(), list.end());
+    }
+
+    using State = std::pair<LaneKey, double>;
+    using Item = std::pair<double, State>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+    std::map<State, double> distance;
+    auto relax = [&](const State &state, double value) {
+      auto it = distance.find(state);
+      if ((it == distance.end()) || (value < it->second)) {
+        distance[state] = value;
+        queue.emplace(value, state);
+      }
+    };
+    relax(State{key_of(origin), origin_fraction}, 0.0);
+    const State goal{key_of(destination), destination_fraction};
+    while (!queue.empty()) {
+      const auto item = queue.top();
+      queue.pop();
+      if (item.first > distance[item.second]) {
+        continue;
+      }
+      if (item.second == goal) {
+        return item.first;
+      }
+      const auto &key = item.second.first;
+      const double position = item.second.second;
+      const auto &data = lanes.at(key);
+      const auto &list = fractions.at(key);
+      auto next = std::upper_bound(list.begin(), list.end(), position);
+      if (next != list.end()) {
+        relax(State{key, *next}, item.first + (*next - position) * data.cost);
+      } else {
+        for (auto &&successor : data.successors) {
+          relax(State{successor, 0.0}, item.first);
+        }
+      }
+      for (auto &&change : data.lane_changes) {
+        relax(State{change.first, position}, item.first + change.second);
+      }
+    }
+    return INF;
+  }
+
+  /// Cost of following @a waypoints, every consecutive pair must be a move
+  /// along a lane, a lane change or a jump to the entry of a successor.
+  double follow(const std::vector<element::Waypoint> &waypoints) const {
+    double total = 0.0;
+    for (auto i = 1u; i < waypoints.size(); ++i) {
+      const auto from = key_of(waypoints[i - 1u]);
+      const auto to = key_of(waypoints[i]);
+      const double from_fraction = fraction(waypoints[i - 1u]);
+      const double to_fraction = fraction(waypoints[i]);
+      const auto *change = find_lane_change(from, to);
+      const auto &successors = lanes.at(from).successors;
+      if (from == to) {
+        EXPECT_GE(to_fraction, from_fraction - 1e-9);
+        total += (to_fraction - from_fraction) * lanes.at(from).cost;
+      } else if (change != nullptr) {
+        EXPECT_NEAR(to_fraction, from_fraction, 1e-9);
+        total += change->second;
+      } else if (std::find(successors.begin(), successors.end(), to) != successors.end()) {
+        EXPECT_NEAR(to_fraction, 0.0, 1e-9);
+        total += (1.0 - from_fraction) * lanes.at(from).cost;
+      } else {
+        ADD_FAILURE() << "invalid step " << i << " of the route";
+        return INF;
+      }
+    }
+    return total;
+  }
+};
+
+static void check_route(
+    const LaneModel &model,
+    const RoutingGraph &graph,
+    const element::Waypoint &origin,
+    const element::Waypoint &destination) {
+  const double expected = model.shortest(origin, destination);
+  const auto route = graph.ComputeRoute(origin, destination);
+  if (expected == INF) {
+    ASSERT_FALSE(route.has_value());
+    return;
+  }
+  ASSERT_TRUE(route.has_value());
+  ASSERT_NEAR(route->cost, expected, 1e-6 * std::max(1.0, expected));
+  ASSERT_GE(route->waypoints.size(), 2u);
+  ASSERT_EQ(route->waypoints.front(), origin);
+  ASSERT_EQ(route->waypoints.back(), destination);
+  ASSERT_NEAR(model.follow(route->waypoints), route->cost, 1e-6 * std::max(1.0, expected));
+}
+
+static void check_against_dijkstra(RoutingGraph::Metric metric, double lane_change_cost) {
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    carla::logging::log("Routing graph:", file);
+    auto map = OpenDriveParser::Load(util::OpenDrive::Load(file));
+    ASSERT_TRUE(map.has_value());
+
+    RoutingGraph::Parameters parameters;
+    parameters.lane_change_cost = lane_change_cost;
+    carla::StopWatch build_time;
+    const RoutingGraph graph(*map, metric, parameters);
+    build_time.Stop();
+    carla::logging::log(
+        graph.GetNumberOfNodes(), "nodes,",
+        graph.GetNumberOfArcs(), "arcs, built in",
+        build_time.GetElapsedTime(), "ms");
+
+    const LaneModel model(*map, metric, parameters);
+    std::vector<LaneKey> keys;
+    for (auto &&item : model.lanes) {
+      keys.emplace_back(item.first);
+    }
+    ASSERT_FALSE(keys.empty());
+    util::Random::Shuffle(keys);
+
+    size_t total_us = 0u;
+    size_t number_of_queries = 0u;
+    for (auto i = 0u; i < std::min<size_t>(20u, keys.size()); ++i) {
+      // entry to entry, and between random positions along the lanes.
+      const auto origin = model.at(keys[i], 0.0);
+      const auto middle = model.at(keys[i], util::Random::Uniform(0.0, 1.0));
+      for (auto j = 0u; j < std::min<size_t>(20u, keys.size()); ++j) {
+        const auto &key = keys[(i + j) % keys.size()];
+        for (auto &&pair : {
+            std::make_pair(origin, model.at(key, 0.0)),
+            std::make_pair(middle, model.at(key, util::Random::Uniform(0.0, 1.0)))}) {
+          carla::StopWatch stop_watch;
+          graph.ComputeRoute(pair.first, pair.second);
+          stop_watch.Stop();
+          total_us += stop_watch.GetElapsedTime<std::chrono::microseconds>();
+          ++number_of_queries;
+          check_route(model, graph, pair.first, pair.second);
+        }
+      }
+    }
+    carla::logging::log(number_of_queries, "queries,", total_us / number_of_queries, "us/query average");
+  }
+}
+
+TEST(routing, matches_dijkstra) {
+  // without lane changes the hierarchy must reproduce the successor graph.
+  check_against_dijkstra(RoutingGraph::Metric::Distance, INF);
+}
+
+TEST(routing, matches_dijkstra_with_lane_changes) {
+  check_against_dijkstra(RoutingGraph::Metric::Distance, 5.0);
+}
+
+TEST(routing, matches_dijkstra_time) {
+  check_against_dijkstra(RoutingGraph::Metric::Time, INF);
+}
+
+TEST(routing, matches_dijkstra_time_with_lane_changes) {
+  check_against_dijkstra(RoutingGraph::Metric::Time, 5.0);
+}
+
+TEST(routing, destination_behind_in_adjacent_lane) {
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    auto map = OpenDriveParser::Load(util::OpenDrive::Load(file));
+    ASSERT_TRUE(map.has_value());
+    for (auto metric : {RoutingGraph::Metric::Distance, RoutingGraph::Metric::Time}) {
+      const RoutingGraph::Parameters parameters;
+      const RoutingGraph graph(*map, metric, parameters);
+      const LaneModel model(*map, metric, parameters);
+      size_t checked = 0u;
+      for (auto &&item : model.lanes) {
+        for (auto &&change : item.second.lane_changes) {
+          // a lane change keeps the position, reaching a point slightly
+          // behind requires leaving the section and coming back.
+          const auto origin = model.at(item.first, 0.5);
+          for (auto &&destination : {model.at(change.first, 0.45), model.at(item.first, 0.45)}) {
+            check_route(model, graph, origin, destination);
+            const auto route = graph.ComputeRoute(origin, destination);
+            if (route.has_value()) {
+              ASSERT_GT(route->cost, 0.5 * item.second.cost);
+            }
+          }
+          // slightly ahead, a single lane change.
+          check_route(model, graph, origin, model.at(change.first, 0.55));
+          ++checked;
+        }
+      }
+      carla::logging::log(file, checked, "lane changes checked");
+    }
+  }
+}
+
+TEST(routing, save_and_load) {
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    auto map = OpenDriveParser::Load(util::OpenDrive::Load(file));
+    ASSERT_TRUE(map.has_value());
+    const RoutingGraph graph(*map, RoutingGraph::Metric::Time);
+
+    std::stringstream stream;
+    graph.Save(stream);
+    const auto loaded = RoutingGraph::Load(stream);
+    ASSERT_TRUE(loaded.IsCompatible(*map));
+    ASSERT_EQ(loaded.GetMetric(), RoutingGraph::Metric::Time);
+    ASSERT_EQ(loaded.GetNumberOfNodes(), graph.GetNumberOfNodes());
+    ASSERT_EQ(loaded.GetNumberOfArcs(), graph.GetNumberOfArcs());
+
+    auto topology = map->GenerateTopology();
+    util::Random::Shuffle(topology);
+    for (auto i = 0u; i < std::min<size_t>(50u, topology.size()); ++i) {
+      const auto origin = topology[i].first;
+      const auto destination = topology[(i + 1u) % topology.size()].second;
+      const auto expected = graph.ComputeRoute(origin, destination);
+      const auto actual = loaded.ComputeRoute(origin, destination);
+      ASSERT_EQ(expected.has_value(), actual.has_value());
+      if (expected.has_value()) {
+        ASSERT_DOUBLE_EQ(expected->cost, actual->cost);
+        ASSERT_EQ(expected->waypoints.size(), actual->waypoints.size());
+      }
+    }
+  }
+
+  std::stringstream garbage("not a routing graph");
+  ASSERT_THROW(RoutingGraph::Load(garbage), std::invalid_argument);
+}
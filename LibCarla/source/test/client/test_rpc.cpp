@@ -10,6 +10,7 @@
 #include <carla/ThreadGroup.h>
 #include <carla/rpc/Actor.h>
 #include <carla/rpc/Client.h>
+#include <carla/rpc/MultiCall.h>
 #include <carla/rpc/Response.h>
 #include <carla/rpc/Server.h>
 
@@ -62,3 +63,56 @@ TEST(rpc, server_bind_sync_run_on_game_thread) {
   std::cout << "game thread: run " << i << " slices.\n";
   ASSERT_TRUE(done);
 }
+
+TEST(rpc, multi_call) {
+  const uint16_t port = (TESTING_PORT != 0u ? TESTING_PORT : 2017u);
+
+  Server server(port);
+
+  auto count = 0;
+  server.BindSync("add", [&](int x, int y) -> Response<int> {
+    ++count;
+    return x + y;
+  });
+  server.BindSync("fail", []() -> Response<void> {
+    return ResponseError("failed");
+  });
+  server.BindAsync("echo", [](std::string str) -> Response<std::string> {
+    return str;
+  });
+
+  server.AsyncRun(1u);
+
+  std::atomic_bool done{false};
+
+  carla::ThreadGroup threads;
+  threads.CreateThread([&]() {
+    Client client("localhost", port);
+    MultiCallBatch batch;
+    std::vector<std::future<int>> sums;
+    for (auto i = 0; i < 100; ++i) {
+      sums.emplace_back(batch.Add<int>("add", i, 1));
+    }
+    auto failed = batch.Add<void>("fail");
+    auto not_found = batch.Add<int>("not_found");
+    auto echo = batch.Add<std::string>("echo", std::string("hello"));
+    batch.SetResults(client.call("multi_call", batch.GetRequests()).as<std::vector<MultiCallResult>>());
+    EXPECT_TRUE(batch.empty());
+    for (auto i = 0; i < 100; ++i) {
+      EXPECT_EQ(sums[i].get(), i + 1);
+    }
+    EXPECT_THROW(failed.get(), std::runtime_error);
+    EXPECT_THROW(not_found.get(), std::runtime_error);
+    EXPECT_EQ(echo.get(), "hello");
+    done = true;
+  });
+
+  for (auto i = 0u; i < 1'000'000u; ++i) {
+    server.SyncRunFor(2ms);
+    if (done) {
+      break;
+    }
+  }
+  ASSERT_TRUE(done);
+  ASSERT_EQ(count, 100);
+}
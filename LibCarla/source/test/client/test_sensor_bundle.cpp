@@ -0,0 +1,152 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/ThreadGroup.h>
+#include <carla/client/detail/FrameAligner.h>
+#include <carla/sensor/data/SensorBundleData.h>
+
+#include <mutex>
+
+using namespace std::chrono_literals;
+using carla::client::detail::FrameAligner;
+using carla::sensor::SensorData;
+using carla::sensor::data::SensorBundleData;
+
+class FakeSensorData : public SensorData {
+public:
+
+  explicit FakeSensorData(size_t frame)
+    : SensorData(frame, 0.0, carla::rpc::Transform{}) {}
+};
+
+static carla::SharedPtr<SensorData> MakeData(size_t frame) {
+  return carla::MakeShared<FakeSensorData>(frame);
+}
+
+struct Received {
+  std::mutex mutex;
+  std::vector<carla::SharedPtr<SensorBundleData>> bundles;
+
+  FrameAligner::CallbackFunctionType MakeCallback() {
+    return [this](carla::SharedPtr<SensorData> data) {
+      auto bundle = boost::static_pointer_cast<SensorBundleData>(data);
+      std::lock_guard<std::mutex> lock(mutex);
+      bundles.emplace_back(std::move(bundle));
+    };
+  }
+};
+
+TEST(sensor_bundle, complete_and_partial_frames) {
+  for (auto policy : {FrameAligner::PartialFramePolicy::Drop, FrameAligner::PartialFramePolicy::Deliver}) {
+    Received received;
+    FrameAligner::Parameters parameters;
+    parameters.partial_policy = policy;
+    FrameAligner aligner(3u, parameters, received.MakeCallback());
+
+    aligner.Push(0u, MakeData(1u));
+    aligner.Push(2u, MakeData(1u));
+    ASSERT_TRUE(received.bundles.empty());
+    aligner.Push(1u, MakeData(1u));
+    ASSERT_EQ(received.bundles.size(), 1u);
+    ASSERT_EQ(received.bundles[0u]->GetFrame(), 1u);
+    ASSERT_TRUE(received.bundles[0u]->IsComplete());
+
+    // stream 1 drops frame 2, it is resolved as soon as stream 1 sends frame 3.
+    aligner.Push(0u, MakeData(2u));
+    aligner.Push(2u, MakeData(2u));
+    aligner.Push(0u, MakeData(3u));
+    aligner.Push(2u, MakeData(3u));
+    ASSERT_EQ(received.bundles.size(), 1u);
+    aligner.Push(1u, MakeData(3u));
+
+    // measurements of a resolved frame are late.
+    aligner.Push(1u, MakeData(2u));
+
+    const auto stats = aligner.GetStats();
+    ASSERT_EQ(stats.complete, 2u);
+    ASSERT_EQ(stats.late, 1u);
+    if (policy == FrameAligner::PartialFramePolicy::Drop) {
+      ASSERT_EQ(received.bundles.size(), 2u);
+      ASSERT_EQ(stats.dropped, 1u);
+    } else {
+      ASSERT_EQ(received.bundles.size(), 3u);
+      ASSERT_EQ(stats.partial, 1u);
+      auto &partial = received.bundles[1u];
+      ASSERT_EQ(partial->GetFrame(), 2u);
+      ASSERT_FALSE(partial->IsComplete());
+      ASSERT_NE((*partial)[0u], nullptr);
+      ASSERT_EQ((*partial)[1u], nullptr);
+    }
+    ASSERT_EQ(received.bundles.back()->GetFrame(), 3u);
+  }
+}
+
+TEST(sensor_bundle, timeout) {
+  Received received;
+  FrameAligner::Parameters parameters;
+  parameters.timeout = 20ms;
+  parameters.partial_policy = FrameAligner::PartialFramePolicy::Deliver;
+  FrameAligner aligner(2u, parameters, received.MakeCallback());
+  aligner.Push(0u, MakeData(1u));
+  aligner.Flush();
+  ASSERT_TRUE(received.bundles.empty());
+  std::this_thread::sleep_for(30ms);
+  aligner.Flush();
+  ASSERT_EQ(received.bundles.size(), 1u);
+  ASSERT_FALSE(received.bundles[0u]->IsComplete());
+}
+
+TEST(sensor_bundle, concurrent_streams) {
+  constexpr auto number_of_streams = 7u;
+  constexpr uint64_t number_of_frames = 2001u;
+  Received received;
+  FrameAligner::Parameters parameters;
+  parameters.timeout = 10s;
+  FrameAligner aligner(number_of_streams, parameters, received.MakeCallback());
+
+  // the "server" only starts a frame once every stream is at most a few
+  // frames behind, as sensors streaming from the simulator.
+  std::atomic<uint64_t> server_frame{0u};
+  std::atomic<uint64_t> progress[number_of_streams] = {};
+  carla::ThreadGroup threads;
+  for (auto stream = 0u; stream < number_of_streams; ++stream) {
+    threads.CreateThread([&, stream]() {
+      for (uint64_t frame = 1u; frame <= number_of_frames; ++frame) {
+        while (server_frame < frame) {
+          std::this_thread::yield();
+        }
+        // stream 0 drops every tenth frame.
+        if ((stream != 0u) || (frame % 10u != 0u)) {
+          aligner.Push(stream, MakeData(frame));
+        }
+        progress[stream] = frame;
+      }
+    });
+  }
+  for (uint64_t frame = 1u; frame <= number_of_frames; ++frame) {
+    for (auto &&stream_progress : progress) {
+      while (stream_progress + 4u < frame) {
+        std::this_thread::yield();
+      }
+    }
+    server_frame = frame;
+  }
+  threads.JoinAll();
+  aligner.Flush();
+
+  const auto stats = aligner.GetStats();
+  ASSERT_EQ(stats.late, 0u);
+  ASSERT_EQ(stats.partial, 0u);
+  ASSERT_EQ(stats.dropped, number_of_frames / 10u);
+  ASSERT_EQ(stats.complete, number_of_frames - stats.dropped);
+  ASSERT_EQ(received.bundles.size(), stats.complete);
+  for (auto &&bundle : received.bundles) {
+    ASSERT_TRUE(bundle->IsComplete());
+    ASSERT_NE(bundle->GetFrame() % 10u, 0u);
+  }
+}
@@ -0,0 +1,80 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/ThreadGroup.h>
+#include <carla/client/SensorDataQueue.h>
+#include <carla/sensor/SensorData.h>
+
+using namespace std::chrono_literals;
+using carla::client::SensorDataQueue;
+
+class FakeSensorData : public carla::sensor::SensorData {
+public:
+
+  explicit FakeSensorData(size_t frame)
+    : SensorData(frame, 0.0, carla::rpc::Transform{}) {}
+};
+
+static carla::SharedPtr<carla::sensor::SensorData> MakeData(size_t frame) {
+  return carla::MakeShared<FakeSensorData>(frame);
+}
+
+TEST(sensor_data_queue, overflow_policies) {
+  auto oldest = carla::MakeShared<SensorDataQueue>(3u, SensorDataQueue::OverflowPolicy::DropOldest);
+  auto newest = carla::MakeShared<SensorDataQueue>(3u, SensorDataQueue::OverflowPolicy::DropNewest);
+  for (auto frame = 1u; frame <= 5u; ++frame) {
+    oldest->Push(MakeData(frame));
+    newest->Push(MakeData(frame));
+  }
+  ASSERT_EQ(oldest->GetSize(), 3u);
+  ASSERT_EQ(oldest->Pop(0ms)->GetFrame(), 3u);
+  ASSERT_EQ(newest->Pop(0ms)->GetFrame(), 1u);
+
+  const auto stats = oldest->GetStats();
+  ASSERT_EQ(stats.received, 5u);
+  ASSERT_EQ(stats.dropped, 2u);
+  ASSERT_EQ(stats.delivered, 1u);
+  ASSERT_EQ(stats.max_size_reached, 3u);
+
+  ASSERT_EQ(newest->PopBatch(0u, 0ms).size(), 2u);
+  ASSERT_EQ(newest->Pop(10ms), nullptr);
+  ASSERT_TRUE(newest->PopBatch(0u, 10ms).empty());
+}
+
+TEST(sensor_data_queue, pop_frame) {
+  auto queue = carla::MakeShared<SensorDataQueue>(10u);
+  for (auto frame : {1u, 2u, 4u, 5u}) {
+    queue->Push(MakeData(frame));
+  }
+  ASSERT_EQ(queue->PopFrame(2u, 0ms)->GetFrame(), 2u);
+  // frame 3 was missed, frame 4 stays in the queue.
+  ASSERT_EQ(queue->PopFrame(3u, 0ms), nullptr);
+  ASSERT_EQ(queue->GetSize(), 2u);
+  ASSERT_EQ(queue->PopFrame(5u, 0ms)->GetFrame(), 5u);
+  ASSERT_EQ(queue->GetStats().skipped, 2u);
+  ASSERT_EQ(queue->PopFrame(6u, 10ms), nullptr);
+}
+
+TEST(sensor_data_queue, producer_consumer) {
+  constexpr auto number_of_frames = 1000u;
+  auto queue = carla::MakeShared<SensorDataQueue>(number_of_frames);
+  auto callback = queue->MakeCallback();
+  carla::ThreadGroup threads;
+  threads.CreateThread([&]() {
+    for (auto frame = 1u; frame <= number_of_frames; ++frame) {
+      callback(MakeData(frame));
+    }
+  });
+  for (auto frame = 1u; frame <= number_of_frames; ++frame) {
+    auto data = queue->PopFrame(frame, 1s);
+    ASSERT_NE(data, nullptr);
+    ASSERT_EQ(data->GetFrame(), frame);
+  }
+  threads.JoinAll();
+  ASSERT_EQ(queue->GetStats().dropped, 0u);
+}
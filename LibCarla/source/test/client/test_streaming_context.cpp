@@ -0,0 +1,86 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/client/detail/StreamingContext.h>
+#include <carla/streaming/Server.h>
+
+#include <atomic>
+
+using namespace std::chrono_literals;
+using carla::client::detail::StreamingContext;
+
+TEST(streaming_context, shared_per_endpoint) {
+  auto context0 = StreamingContext::Get("localhost", TESTING_PORT, 2u);
+  auto context1 = StreamingContext::Get("localhost", TESTING_PORT, 4u);
+  auto context2 = StreamingContext::Get("localhost", TESTING_PORT + 1u, 2u);
+  ASSERT_EQ(context0, context1);
+  ASSERT_NE(context0, context2);
+  // the first client sets the threads.
+  ASSERT_EQ(context1->GetNumberOfWorkerThreads(), 2u);
+}
+
+TEST(streaming_context, single_connection_per_stream) {
+  using namespace util::buffer;
+  const std::string message = "Hello clients!";
+
+  carla::streaming::Server srv(TESTING_PORT);
+  srv.AsyncRun(2u);
+  auto stream = srv.MakeStream();
+
+  auto context = StreamingContext::Get("localhost", TESTING_PORT, 2u);
+  int subscriber0, subscriber1;
+  std::atomic_size_t received0{0u}, received1{0u};
+  context->Subscribe(&subscriber0, stream.token(), [&](carla::Buffer buffer) {
+    ASSERT_EQ(as_string(buffer), message);
+    ++received0;
+  });
+  context->Subscribe(&subscriber1, stream.token(), [&](carla::Buffer buffer) {
+    ASSERT_EQ(as_string(buffer), message);
+    ++received1;
+  });
+  ASSERT_EQ(context->GetNumberOfSubscribers(stream.token()), 2u);
+
+  for (auto i = 0u; (i < 1000u) && ((received0 < 10u) || (received1 < 10u)); ++i) {
+    std::this_thread::sleep_for(2ms);
+    stream << message;
+  }
+  ASSERT_GE(received0, 10u);
+  ASSERT_GE(received1, 10u);
+
+  // both subscribers share the same session on the server.
+  auto get_connections = [&]() {
+    for (auto &&metrics : srv.GetMetrics()) {
+      if (metrics.stream_id == carla::streaming::detail::token_type(stream.token()).get_stream_id()) {
+        return metrics.connections;
+      }
+    }
+    return std::uint64_t(0u);
+  };
+  ASSERT_EQ(get_connections(), 1u);
+
+  context->UnSubscribe(&subscriber0, stream.token());
+  ASSERT_EQ(context->GetNumberOfSubscribers(stream.token()), 1u);
+  std::this_thread::sleep_for(10ms);
+  const size_t before = received0;
+  for (auto i = 0u; i < 10u; ++i) {
+    std::this_thread::sleep_for(2ms);
+    stream << message;
+  }
+  ASSERT_EQ(received0, before);
+
+  ASSERT_EQ(get_connections(), 1u);
+
+  context->UnSubscribeAll(&subscriber1);
+  ASSERT_EQ(context->GetNumberOfSubscribers(stream.token()), 0u);
+  // the server notices the closed socket on the next write.
+  for (auto i = 0u; (i < 100u) && (get_connections() > 0u); ++i) {
+    std::this_thread::sleep_for(10ms);
+    stream << message;
+  }
+  ASSERT_EQ(get_connections(), 0u);
+}
@@ -0,0 +1,97 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/MsgPack.h>
+#include <carla/trafficmanager/ParameterUpdate.h>
+#include <carla/trafficmanager/Parameters.h>
+
+using carla::traffic_manager::ParameterUpdate;
+using carla::traffic_manager::Parameters;
+using carla::traffic_manager::VehicleParameter;
+
+TEST(traffic_manager_parameters, msgpack_parameter_update) {
+  using mp = carla::MsgPack;
+  const std::vector<ParameterUpdate> updates = {
+    {1u, VehicleParameter::PercentageSpeedDifference, -25.5f},
+    {2u, VehicleParameter::ForceLaneChange, 1.0f},
+    {3u, VehicleParameter::RandomRightLaneChangePercentage, 40.0f}};
+  const auto result = mp::UnPack<std::vector<ParameterUpdate>>(mp::Pack(updates));
+  ASSERT_EQ(result.size(), updates.size());
+  for (auto i = 0u; i < updates.size(); ++i) {
+    ASSERT_EQ(result[i].actor, updates[i].actor);
+    ASSERT_EQ(result[i].parameter, updates[i].parameter);
+    ASSERT_EQ(result[i].value, updates[i].value);
+  }
+}
+
+TEST(traffic_manager_parameters, apply_updates_clamps) {
+  constexpr carla::ActorId id = 42u;
+  Parameters parameters;
+  parameters.ApplyUpdates({
+    {id, VehicleParameter::PercentageSpeedDifference, 150.0f},
+    {id, VehicleParameter::DistanceToLeadingVehicle, -3.0f},
+    {id, VehicleParameter::PercentageIgnoreWalkers, 140.0f},
+    {id, VehicleParameter::PercentageIgnoreVehicles, -5.0f},
+    {id, VehicleParameter::PercentageRunningLight, 101.0f},
+    {id, VehicleParameter::PercentageRunningSign, 50.0f},
+    {id, VehicleParameter::AutoLaneChange, 0.0f},
+    {id, VehicleParameter::UpdateVehicleLights, 2.0f}});
+
+  // Not visible to the stages until the next snapshot.
+  ASSERT_EQ(parameters.GetPercentageIgnoreWalkers(id), 0.0f);
+  parameters.UpdateSnapshot();
+
+  // Same clamps as the individual setters.
+  ASSERT_EQ(parameters.GetVehicleTargetVelocity(id, 10.0f), 0.0f);
+  ASSERT_EQ(parameters.GetDistanceToLeadingVehicle(id), 0.0f);
+  ASSERT_EQ(parameters.GetPercentageIgnoreWalkers(id), 100.0f);
+  ASSERT_EQ(parameters.GetPercentageIgnoreVehicles(id), 0.0f);
+  ASSERT_EQ(parameters.GetPercentageRunningLight(id), 100.0f);
+  ASSERT_EQ(parameters.GetPercentageRunningSign(id), 50.0f);
+  ASSERT_FALSE(parameters.GetAutoLaneChange(id));
+  ASSERT_TRUE(parameters.GetUpdateVehicleLights(id));
+
+  // Other vehicles keep the defaults.
+  ASSERT_EQ(parameters.GetPercentageIgnoreWalkers(id + 1u), 0.0f);
+  ASSERT_TRUE(parameters.GetAutoLaneChange(id + 1u));
+}
+
+TEST(traffic_manager_parameters, apply_updates_in_order) {
+  constexpr carla::ActorId id = 7u;
+  Parameters parameters;
+  parameters.ApplyUpdates({
+    {id, VehicleParameter::KeepRightPercentage, 10.0f},
+    {id, VehicleParameter::KeepRightPercentage, 20.0f},
+    {id, VehicleParameter::ForceLaneChange, 0.0f},
+    {id, VehicleParameter::ForceLaneChange, 1.0f}});
+  parameters.ApplyUpdates({{id, VehicleParameter::RandomLeftLaneChangePercentage, 30.0f}});
+  parameters.UpdateSnapshot();
+  ASSERT_EQ(parameters.GetKeepRightPercentage(id), 20.0f);
+  ASSERT_EQ(parameters.GetRandomLeftLaneChangePercentage(id), 30.0f);
+  const auto lane_change = parameters.GetForceLaneChange(id);
+  ASSERT_TRUE(lane_change.change_lane);
+  ASSERT_TRUE(lane_change.direction);
+  // Consumed by the first read.
+  ASSERT_FALSE(parameters.GetForceLaneChange(id).change_lane);
+}
+
+TEST(traffic_manager_parameters, remove_vehicle) {
+  constexpr carla::ActorId id = 3u;
+  Parameters parameters;
+  parameters.ApplyUpdates({
+    {id, VehicleParameter::PercentageRunningLight, 80.0f},
+    {id, VehicleParameter::ForceLaneChange, 1.0f}});
+  parameters.UpdateSnapshot();
+  ASSERT_EQ(parameters.GetPercentageRunningLight(id), 80.0f);
+  parameters.RemoveVehicle(id);
+  // The current snapshot is kept until the next one.
+  ASSERT_EQ(parameters.GetPercentageRunningLight(id), 80.0f);
+  parameters.UpdateSnapshot();
+  ASSERT_EQ(parameters.GetPercentageRunningLight(id), 0.0f);
+  ASSERT_FALSE(parameters.GetForceLaneChange(id).change_lane);
+}
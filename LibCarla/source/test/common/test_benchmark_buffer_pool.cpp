@@ -0,0 +1,137 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/BufferPool.h>
+
+#if defined(__clang__)
+#  pragma clang diagnostic push
+#  pragma clang diagnostic ignored "-Wold-style-cast"
+#endif
+#include "moodycamel/ConcurrentQueue.h"
+#if defined(__clang__)
+#  pragma clang diagnostic pop
+#endif
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <random>
+
+/// Copy of the pool before size classes, a single queue where Pop takes any
+/// retained buffer. Buffers only return by themselves to a carla::BufferPool,
+/// so they are given back explicitly.
+class BaselineBufferPool {
+public:
+
+  carla::Buffer Pop() {
+    carla::Buffer item;
+    if (_queue.try_dequeue(item)) {
+      _retained_bytes -= item.capacity();
+    }
+    return item;
+  }
+
+  void Push(carla::Buffer &&buffer) {
+    _retained_bytes += buffer.capacity();
+    _queue.enqueue(std::move(buffer));
+  }
+
+  size_t GetRetainedBytes() const {
+    return _retained_bytes;
+  }
+
+private:
+
+  moodycamel::ConcurrentQueue<carla::Buffer> _queue;
+
+  size_t _retained_bytes = 0u;
+};
+
+struct PoolResult {
+  size_t allocations = 0u;
+  /// Capacity of the buffers in flight plus the retained by the pool.
+  size_t max_memory = 0u;
+  std::chrono::microseconds elapsed{0};
+};
+
+/// Messages of the sizes of a 200x200 and a 1920x1080 camera sharing a pool,
+/// mostly small ones, keeping some of them in flight as the streams do.
+/// @a give_back receives the buffers leaving the flight.
+template <typename PopF, typename GiveBackF, typename RetainedF>
+static PoolResult run_mixed_sizes(PopF pop, GiveBackF give_back, RetainedF get_retained_bytes) {
+  constexpr size_t number_of_messages = 500u;
+  constexpr size_t messages_in_flight = 16u;
+  const std::array<size_t, 2u> sizes = {200u * 200u * 4u, 1920u * 1080u * 4u};
+
+  std::mt19937 engine(42u);
+  std::bernoulli_distribution pick_big(0.1);
+  std::deque<carla::Buffer> in_flight;
+  PoolResult result;
+  const auto begin = std::chrono::steady_clock::now();
+  for (auto i = 0u; i < number_of_messages; ++i) {
+    const size_t size = sizes[pick_big(engine) ? 1u : 0u];
+    auto buffer = pop(size);
+    if (buffer.capacity() < size) {
+      ++result.allocations;
+    }
+    buffer.reset(size);
+    std::memset(buffer.data(), 0, buffer.size());
+    in_flight.emplace_back(std::move(buffer));
+    if (in_flight.size() > messages_in_flight) {
+      give_back(std::move(in_flight.front()));
+      in_flight.pop_front();
+    }
+    size_t memory = get_retained_bytes();
+    for (const auto &item : in_flight) {
+      memory += item.capacity();
+    }
+    result.max_memory = std::max(result.max_memory, memory);
+  }
+  result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - begin);
+  return result;
+}
+
+static void log_result(const char *name, const PoolResult &result) {
+  carla::logging::log(
+      name, result.allocations, "allocations,",
+      result.max_memory, "bytes in use,", result.elapsed.count(), "us");
+}
+
+TEST(benchmark_buffer_pool, mixed_sizes) {
+  BaselineBufferPool baseline_pool;
+  const auto baseline = run_mixed_sizes(
+      [&](size_t) { return baseline_pool.Pop(); },
+      [&](carla::Buffer buffer) { baseline_pool.Push(std::move(buffer)); },
+      [&]() { return baseline_pool.GetRetainedBytes(); });
+
+  // buffers popped from a carla::BufferPool return to it on destruction.
+  auto any_pool = std::make_shared<carla::BufferPool>();
+  const auto any = run_mixed_sizes(
+      [&](size_t) { return any_pool->Pop(); },
+      [](carla::Buffer) {},
+      [&]() { return any_pool->GetRetainedBytes(); });
+
+  auto hinted_pool = std::make_shared<carla::BufferPool>();
+  auto hinted = run_mixed_sizes(
+      [&](size_t size) { return hinted_pool->Pop(size); },
+      [](carla::Buffer) {},
+      [&]() { return hinted_pool->GetRetainedBytes(); });
+  // with size hint a miss allocates the buffer in Pop, so it is never too
+  // small for the message.
+  for (const auto &stats : hinted_pool->GetStats()) {
+    hinted.allocations += stats.misses;
+  }
+
+  log_result("Buffer pool, baseline:     ", baseline);
+  log_result("Buffer pool, no size hint: ", any);
+  log_result("Buffer pool, size hint:    ", hinted);
+  ASSERT_LE(hinted.allocations, baseline.allocations);
+  ASSERT_LT(hinted.max_memory, baseline.max_memory);
+}
@@ -134,3 +134,107 @@ TEST(buffer, buffer_pool) {
   // Now delete the pool to test the weak reference inside the buffers.
   pool.reset();
 }
+
+TEST(buffer, resize_keeps_data) {
+  const std::string str = "Hello buffer!";
+  Buffer buff;
+  buff.copy_from(str);
+  buff.resize(str.size() + 1024u);
+  ASSERT_EQ(buff.size(), str.size() + 1024u);
+  ASSERT_EQ(std::string(reinterpret_cast<const char *>(buff.data()), str.size()), str);
+  buff.resize(str.size());
+  ASSERT_EQ(as_string(buff), str);
+}
+
+TEST(buffer, buffer_pool_size_classes) {
+  using carla::BufferPool;
+  ASSERT_EQ(BufferPool::GetSizeClass(0u), 0u);
+  ASSERT_EQ(BufferPool::GetSizeClass(2047u), 0u);
+  ASSERT_EQ(BufferPool::GetSizeClass(2048u), 1u);
+  ASSERT_EQ(BufferPool::GetSizeClass(1000000u), 9u);
+  ASSERT_EQ(BufferPool::GetSizeClass(Buffer::max_size()), BufferPool::NumberOfSizeClasses - 2u);
+}
+
+TEST(buffer, buffer_pool_size_hint) {
+  auto pool = std::make_shared<carla::BufferPool>();
+  {
+    // New buffers get the capacity of their size class.
+    auto small = pool->Pop(100u);
+    ASSERT_EQ(small.capacity(), 1024u);
+    small.reset(100u);
+    auto big = pool->Pop(1000000u);
+    ASSERT_EQ(big.capacity(), 1048576u);
+    big.reset(1000000u);
+  }
+  ASSERT_EQ(pool->GetRetainedBytes(), 1024u + 1048576u);
+  {
+    // Too small for the hint.
+    ASSERT_EQ(pool->Pop(1500u).capacity(), 2048u);
+    auto small = pool->Pop(1000u);
+    ASSERT_EQ(small.capacity(), 1024u);
+    // Too big for the size class of the hint.
+    ASSERT_EQ(pool->Pop(100000u).capacity(), 131072u);
+    auto big = pool->Pop(600000u);
+    ASSERT_EQ(big.capacity(), 1048576u);
+    ASSERT_EQ(pool->GetRetainedBytes(), 2048u + 131072u);
+  }
+  const auto stats = pool->GetStats();
+  ASSERT_EQ(stats.size(), carla::BufferPool::NumberOfSizeClasses);
+  const auto &small_class = stats[carla::BufferPool::GetSizeClass(1000u)];
+  ASSERT_EQ(small_class.hits, 1u);
+  ASSERT_EQ(small_class.misses, 2u);
+  ASSERT_EQ(small_class.retained_buffers, 1u);
+  ASSERT_EQ(small_class.retained_bytes, 1024u);
+  const auto &big_class = stats[carla::BufferPool::GetSizeClass(600000u)];
+  ASSERT_EQ(big_class.hits, 1u);
+  ASSERT_EQ(big_class.misses, 1u);
+  ASSERT_EQ(stats[carla::BufferPool::GetSizeClass(1048576u)].retained_bytes, 1048576u);
+}
+
+TEST(buffer, buffer_pool_class_capacity) {
+  using carla::BufferPool;
+  ASSERT_EQ(BufferPool::GetClassCapacity(0u), size_t(BufferPool::MinClassCapacity));
+  ASSERT_EQ(BufferPool::GetClassCapacity(1024u), 1024u);
+  ASSERT_EQ(BufferPool::GetClassCapacity(1025u), 2048u);
+  ASSERT_EQ(BufferPool::GetClassCapacity(1920u * 1080u * 4u), 8388608u);
+  ASSERT_EQ(BufferPool::GetClassCapacity(Buffer::max_size()), size_t(Buffer::max_size()));
+}
+
+TEST(buffer, buffer_pool_smallest_first) {
+  auto pool = std::make_shared<carla::BufferPool>();
+  {
+    auto big = pool->Pop(100000u);
+    auto small = pool->Pop(100u);
+  }
+  // Without hint the smallest buffer is returned first.
+  ASSERT_EQ(pool->Pop().capacity(), 1024u);
+  auto small = pool->Pop();
+  ASSERT_EQ(small.capacity(), 1024u);
+  ASSERT_EQ(pool->Pop().capacity(), 131072u);
+}
+
+TEST(buffer, buffer_pool_retained_bytes) {
+  auto pool = std::make_shared<carla::BufferPool>();
+  pool->SetMaxRetainedBytes(5000u);
+  {
+    std::vector<Buffer> buffers;
+    for (auto i = 0u; i < 4u; ++i) {
+      buffers.emplace_back(pool->Pop(2000u));
+      buffers.back().reset(2000u);
+    }
+  }
+  ASSERT_EQ(pool->GetRetainedBytes(), 4096u);
+  const auto stats = pool->GetStats()[carla::BufferPool::GetSizeClass(2048u)];
+  ASSERT_EQ(stats.retained_buffers, 2u);
+  ASSERT_EQ(stats.trimmed, 2u);
+  pool->Trim(2048u);
+  ASSERT_EQ(pool->GetRetainedBytes(), 2048u);
+  pool->Trim();
+  ASSERT_EQ(pool->GetRetainedBytes(), 0u);
+  // Buffers popped without hint keep returning to the pool.
+  {
+    auto buff = pool->Pop();
+    buff.reset(100u);
+  }
+  ASSERT_EQ(pool->Pop().capacity(), 100u);
+}
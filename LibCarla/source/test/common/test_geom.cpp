@@ -10,7 +10,10 @@
 #include <carla/geom/Math.h>
 #include <carla/geom/BoundingBox.h>
 #include <carla/geom/Transform.h>
+#include <carla/geom/Mesh.h>
+#include <cstring>
 #include <limits>
+#include <sstream>
 
 namespace carla {
 namespace geom {
@@ -227,3 +230,70 @@ TEST(geom, nearest_point_arc) {
   ASSERT_NEAR(Math::DistanceArcToPoint(Vector3D(1,2,0),
       Vector3D(0,0,0), 1.57f, 0, 1).second, 1.0f, 0.01f);
 }
+
+static Mesh MakeQuadMesh() {
+  Mesh mesh;
+  mesh.AddTriangleStrip({
+      Vector3D(0.0f, 0.0f, 0.0f),
+      Vector3D(0.0f, 1.0f, 0.0f),
+      Vector3D(1.0f, 0.0f, 0.5f),
+      Vector3D(1.0f, 1.0f, 0.5f)});
+  return mesh;
+}
+
+TEST(geom, mesh_indexed_buffer_round_trip) {
+  const Mesh mesh = MakeQuadMesh();
+  std::vector<unsigned char> data(mesh.GetIndexedBufferSize());
+  ASSERT_EQ(mesh.WriteIndexedBuffer(data.data()), data.size());
+
+  std::ostringstream out;
+  mesh.WriteIndexedBuffer(out);
+  const std::string streamed = out.str();
+  ASSERT_EQ(streamed.size(), data.size());
+  ASSERT_EQ(std::memcmp(streamed.data(), data.data(), data.size()), 0);
+
+  const Mesh result = Mesh::ReadIndexedBuffer(data.data(), data.size());
+  ASSERT_EQ(result.GetVertices(), mesh.GetVertices());
+  ASSERT_EQ(result.GetIndexes(), mesh.GetIndexes());
+
+  ASSERT_THROW(Mesh::ReadIndexedBuffer(data.data(), data.size() - 1u), std::invalid_argument);
+}
+
+TEST(geom, mesh_binary_ply) {
+  const Mesh mesh = MakeQuadMesh();
+  std::ostringstream out;
+  mesh.WriteBinaryPLY(out);
+  const std::string ply = out.str();
+  const std::string end_header = "end_header\n";
+  const auto body = ply.find(end_header);
+  ASSERT_NE(body, std::string::npos);
+  ASSERT_NE(ply.find("format binary_little_endian 1.0"), std::string::npos);
+  const size_t expected_size =
+      3u * sizeof(float) * mesh.GetVerticesNum() +
+      (1u + 3u * sizeof(uint32_t)) * (mesh.GetIndexesNum() / 3u);
+  ASSERT_EQ(ply.size() - body - end_header.size(), expected_size);
+}
+
+TEST(geom, mesh_recast_geometry) {
+  const Mesh mesh = MakeQuadMesh();
+  const auto geometry = mesh.GenerateRecastGeometry();
+  ASSERT_EQ(geometry.GetVerticesNum(), 4u);
+  ASSERT_EQ(geometry.GetTrianglesNum(), 2u);
+  // "y" and "z" are switched.
+  const std::vector<float> vertices = {
+      0.0f, 0.0f, 0.0f,
+      0.0f, 0.0f, 1.0f,
+      1.0f, 0.5f, 0.0f,
+      1.0f, 0.5f, 1.0f};
+  ASSERT_EQ(geometry.vertices, vertices);
+  // Faces are 0-based and clockwise.
+  const std::vector<int> triangles = {0, 2, 1, 3, 1, 2};
+  ASSERT_EQ(geometry.triangles, triangles);
+  // Same output as the text exporter.
+  std::ostringstream out;
+  mesh.WriteOBJForRecast(out);
+  const std::string obj = out.str();
+  ASSERT_NE(obj.find("v 0.000000 0.000000 1.000000\n"), std::string::npos);
+  ASSERT_NE(obj.find("f 1 3 2\nf 4 2 3\n"), std::string::npos);
+  ASSERT_EQ(obj, mesh.GenerateOBJForRecast());
+}
@@ -0,0 +1,159 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/AsyncLogging.h>
+#include <carla/ThreadGroup.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace logging = carla::logging;
+
+namespace {
+
+  struct Point {
+    int x;
+    int y;
+  };
+
+  std::ostream &operator<<(std::ostream &out, const Point &point) {
+    return out << '(' << point.x << ", " << point.y << ')';
+  }
+
+  /// Logs to a binary file with the console output disabled, and returns
+  /// the decoded messages without their timestamp and thread.
+  class BinaryLog {
+  public:
+
+    explicit BinaryLog(
+        size_t queue_size = 256u,
+        std::chrono::milliseconds flush_interval = std::chrono::milliseconds(10)) {
+      logging::AsyncLoggingOptions options;
+      options.queue_size = queue_size;
+      options.flush_interval = flush_interval;
+      options.write_to_console = false;
+      options.binary_file = _path;
+      logging::StartAsyncLogging(options);
+    }
+
+    ~BinaryLog() {
+      logging::StopAsyncLogging();
+      std::remove(_path.c_str());
+    }
+
+    std::vector<std::string> Read() {
+      logging::StopAsyncLogging();
+      std::ifstream file(_path, std::ios::binary);
+      std::stringstream text;
+      logging::DecodeBinaryLog(file, text);
+      std::vector<std::string> lines;
+      for (std::string line; std::getline(text, line);) {
+        const auto pos = line.find("] ", line.find("] ") + 2u);
+        lines.emplace_back(line.substr(pos + 2u));
+      }
+      return lines;
+    }
+
+  private:
+
+    const std::string _path = "libcarla_test_logging.bin";
+  };
+
+  template <typename ... Args>
+  std::string Format(Args && ... args) {
+    std::ostringstream out;
+    logging::write_to_stream(out, std::forward<Args>(args) ...);
+    return out.str();
+  }
+
+} // namespace
+
+TEST(logging, async_same_output_as_sync) {
+  const std::string string = "string";
+  const char *c_string = "c string";
+  const Point point{1, -2};
+  const uint64_t big = 1ull << 40u;
+  BinaryLog log;
+  carla::log_warning("warning", 42, -7, 1.5f, 0.25, true, 'c', string, c_string, point, big);
+  carla::log_error("error");
+  logging::log("no", "prefix");
+  const auto lines = log.Read();
+  ASSERT_EQ(lines.size(), 3u);
+  ASSERT_EQ(lines[0u], Format("WARNING:", "warning", 42, -7, 1.5f, 0.25, true, 'c', string, c_string, point, big));
+  ASSERT_EQ(lines[1u], Format("ERROR:", "error"));
+  ASSERT_EQ(lines[2u], Format("no", "prefix"));
+}
+
+TEST(logging, async_long_message_is_truncated) {
+  BinaryLog log;
+  carla::log_warning("long", std::string(1000u, 'x'), 1);
+  const auto lines = log.Read();
+  ASSERT_EQ(lines.size(), 1u);
+  ASSERT_LT(lines[0u].size(), 256u);
+  ASSERT_EQ(lines[0u].substr(0u, 20u), "WARNING: long xxxxxx");
+  ASSERT_EQ(lines[0u].substr(lines[0u].size() - 6u), " [...]");
+}
+
+TEST(logging, async_multiple_threads) {
+  constexpr auto number_of_threads = 4u;
+  constexpr auto messages_per_thread = 50u;
+  const auto dropped = logging::GetNumberOfDroppedLogMessages();
+  BinaryLog log;
+  {
+    carla::ThreadGroup threads;
+    threads.CreateThreads(number_of_threads, []() {
+      for (auto i = 0u; i < messages_per_thread; ++i) {
+        carla::log_warning("message", i);
+        if (i % 10u == 0u) {
+          logging::FlushLog();
+        }
+      }
+    });
+  }
+  const auto lines = log.Read();
+  ASSERT_EQ(lines.size(), number_of_threads * messages_per_thread);
+  for (const auto &line : lines) {
+    ASSERT_EQ(line.find("WARNING: message "), 0u);
+  }
+  ASSERT_EQ(logging::GetNumberOfDroppedLogMessages(), dropped);
+}
+
+TEST(logging, async_drops_when_queue_is_full) {
+  const auto dropped = logging::GetNumberOfDroppedLogMessages();
+  // Do not flush in the background while the thread is logging.
+  BinaryLog log(4u, std::chrono::hours(1));
+  {
+    // A new thread, so its queue is created with the size above.
+    carla::ThreadGroup threads;
+    threads.CreateThread([]() {
+      for (auto i = 0u; i < 10u; ++i) {
+        carla::log_warning("message", i);
+      }
+    });
+  }
+  const auto lines = log.Read();
+  ASSERT_EQ(lines.size(), 4u);
+  ASSERT_EQ(lines[3u], "WARNING: message 3");
+  ASSERT_EQ(logging::GetNumberOfDroppedLogMessages() - dropped, 6u);
+}
+
+TEST(logging, runtime_log_level) {
+  BinaryLog log;
+  logging::SetLogLevel(LIBCARLA_LOG_LEVEL_ERROR);
+  carla::log_warning("discarded");
+  carla::log_error("kept");
+  logging::log("always kept");
+  logging::SetLogLevel(LIBCARLA_LOG_LEVEL_DEBUG);
+  const auto lines = log.Read();
+  ASSERT_EQ(lines.size(), 2u);
+  ASSERT_EQ(lines[0u], "ERROR: kept");
+  ASSERT_EQ(lines[1u], "always kept");
+}
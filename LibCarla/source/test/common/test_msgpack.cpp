@@ -6,9 +6,11 @@
 
 #include "test.h"
 
+#include <carla/BufferPool.h>
 #include <carla/MsgPackAdaptors.h>
 #include <carla/rpc/Actor.h>
 #include <carla/rpc/Response.h>
+#include <carla/rpc/VehicleControlBatch.h>
 
 #include <thread>
 
@@ -105,3 +107,38 @@ TEST(msgpack, optional) {
   ASSERT_TRUE(result.has_value());
   ASSERT_EQ(*result, 42.0f);
 }
+
+TEST(msgpack, vehicle_control_batch) {
+  using mp = carla::MsgPack;
+  VehicleControlBatch batch;
+  ASSERT_TRUE(mp::UnPack<VehicleControlBatch>(mp::Pack(batch)).empty());
+  for (auto i = 0u; i < 500u; ++i) {
+    batch.Add(i, VehicleControl{0.1f * i, -0.5f, 0.25f, i % 2u == 0u, i % 3u == 0u, i % 5u == 0u, int32_t(i % 7u)});
+  }
+  auto buffer = mp::Pack(batch);
+  ASSERT_LT(buffer.size(), batch.GetSerializedSize() + 8u);
+  auto result = mp::UnPack<VehicleControlBatch>(buffer);
+  ASSERT_EQ(result.size(), batch.size());
+  for (auto i = 0u; i < batch.size(); ++i) {
+    ASSERT_EQ(result.GetActor(i), batch.GetActor(i));
+    ASSERT_EQ(result.GetControl(i), batch.GetControl(i));
+  }
+}
+
+TEST(msgpack, pack_into_pooled_buffer) {
+  using mp = carla::MsgPack;
+  auto pool = std::make_shared<carla::BufferPool>();
+  const std::vector<int> small(10u, 1);
+  const std::vector<int> big(10000u, 2);
+  const unsigned char *memory = nullptr;
+  {
+    auto buffer = mp::Pack(big, pool->Pop());
+    ASSERT_EQ(mp::UnPack<std::vector<int>>(buffer), big);
+    memory = buffer.data();
+  }
+  // The memory of the previous message is reused.
+  auto buffer = mp::Pack(small, pool->Pop());
+  ASSERT_EQ(buffer.data(), memory);
+  ASSERT_EQ(buffer.size(), mp::Pack(small).size());
+  ASSERT_EQ(mp::UnPack<std::vector<int>>(buffer), small);
+}
@@ -0,0 +1,225 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/ThreadGroup.h>
+#include <carla/streaming/Metrics.h>
+#include <carla/streaming/detail/MetricsServer.h>
+#include <carla/streaming/detail/tcp/Client.h>
+#include <carla/streaming/detail/tcp/Server.h>
+#include <carla/streaming/low_level/Client.h>
+#include <carla/streaming/low_level/Server.h>
+
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+
+#include <atomic>
+
+using namespace std::chrono_literals;
+using carla::streaming::LatencyHistogram;
+
+namespace {
+
+  /// Stops the threads in case of exception/assert.
+  class io_context_running {
+  public:
+
+    boost::asio::io_context service;
+
+    io_context_running() : _work_to_do(service) {
+      _threads.CreateThreads(2u, [this]() { service.run(); });
+    }
+
+    ~io_context_running() {
+      service.stop();
+    }
+
+  private:
+
+    boost::asio::io_context::work _work_to_do;
+
+    carla::ThreadGroup _threads;
+  };
+
+} // namespace
+
+TEST(streaming_metrics, histogram_buckets) {
+  for (std::uint64_t value : {0ull, 1ull, 31ull, 32ull, 33ull, 1000ull, 123456789ull, 1ull << 39u}) {
+    const auto index = LatencyHistogram::GetBucketIndex(value);
+    ASSERT_LT(index, size_t(LatencyHistogram::NumberOfBuckets));
+    const auto upper = LatencyHistogram::GetBucketUpperBound(index);
+    ASSERT_GE(upper, value);
+    ASSERT_LE(upper - value, value / 32u);
+    if (index > 0u) {
+      ASSERT_LT(LatencyHistogram::GetBucketUpperBound(index - 1u), value);
+    }
+  }
+  // Larger values are clamped to the last bucket.
+  ASSERT_EQ(LatencyHistogram::GetBucketIndex(~std::uint64_t(0u)), LatencyHistogram::NumberOfBuckets - 1u);
+}
+
+TEST(streaming_metrics, histogram_percentiles) {
+  LatencyHistogram histogram;
+  ASSERT_EQ(histogram.GetSummary().count, 0u);
+  for (auto i = 1u; i <= 1000u; ++i) {
+    histogram.Record(std::chrono::microseconds(i));
+  }
+  const auto summary = histogram.GetSummary();
+  ASSERT_EQ(summary.count, 1000u);
+  ASSERT_EQ(summary.min, 1000u);
+  ASSERT_EQ(summary.max, 1000000u);
+  ASSERT_DOUBLE_EQ(summary.mean(), 500500.0);
+  auto expect_near = [](std::uint64_t value, double expected) {
+    ASSERT_NEAR(static_cast<double>(value), expected, expected / 32.0);
+  };
+  expect_near(summary.p50, 500000.0);
+  expect_near(summary.p90, 900000.0);
+  expect_near(summary.p99, 990000.0);
+  expect_near(summary.p999, 999000.0);
+  histogram.Reset();
+  ASSERT_EQ(histogram.GetSummary().count, 0u);
+}
+
+TEST(streaming_metrics, low_level_stream) {
+  using namespace carla::streaming;
+  using namespace carla::streaming::detail;
+
+  constexpr auto number_of_messages = 50u;
+  const std::string message_text = "Hello client!";
+
+  io_context_running io;
+  auto &io_context = io.service;
+
+  low_level::Server<tcp::Server> srv(io_context, TESTING_PORT);
+  srv.SetTimeout(1s);
+  auto stream = srv.MakeStream();
+
+  std::atomic_size_t message_count{0u};
+  low_level::Client<tcp::Client> c;
+  c.Subscribe(io_context, stream.token(), [&](auto) { ++message_count; });
+
+  for (auto i = 0u; i < number_of_messages; ++i) {
+    std::this_thread::sleep_for(2ms);
+    stream << message_text;
+  }
+  std::this_thread::sleep_for(20ms);
+
+  const auto message_size = sizeof(message_size_type) + message_text.size();
+
+  const auto client_metrics = c.GetMetrics();
+  ASSERT_EQ(client_metrics.size(), 1u);
+  ASSERT_EQ(client_metrics[0u].stream_id, token_type(stream.token()).get_stream_id());
+  ASSERT_EQ(client_metrics[0u].messages, message_count);
+  ASSERT_EQ(client_metrics[0u].bytes, message_count * message_size);
+  ASSERT_EQ(client_metrics[0u].queue_depth, 0u);
+  ASSERT_EQ(client_metrics[0u].latency.count, message_count);
+
+  const auto server_metrics = srv.GetMetrics();
+  ASSERT_EQ(server_metrics.size(), 1u);
+  const auto &metrics = server_metrics[0u];
+  ASSERT_EQ(metrics.stream_id, token_type(stream.token()).get_stream_id());
+  ASSERT_GE(metrics.messages, message_count);
+  ASSERT_EQ(metrics.bytes, metrics.messages * message_size);
+  ASSERT_EQ(metrics.queue_depth, 0u);
+  ASSERT_GE(metrics.max_queue_depth, 1u);
+  ASSERT_EQ(metrics.connections, 1u);
+  ASSERT_EQ(client_metrics[0u].connections, 0u);
+  ASSERT_EQ(metrics.latency.count, metrics.messages);
+  ASSERT_LE(metrics.latency.min, metrics.latency.p50);
+  ASSERT_LE(metrics.latency.p50, metrics.latency.max);
+
+  const auto text = WritePrometheusMetrics(server_metrics, "server");
+  const auto labels = "{side=\"server\",stream=\"" + std::to_string(metrics.stream_id) + "\"}";
+  ASSERT_NE(text.find("# TYPE carla_streaming_messages_total counter\n"), std::string::npos);
+  ASSERT_NE(text.find("carla_streaming_messages_total" + labels + " " + std::to_string(metrics.messages) + "\n"), std::string::npos);
+  ASSERT_NE(text.find("carla_streaming_latency_seconds_count" + labels), std::string::npos);
+
+  io_context.stop();
+}
+
+TEST(streaming_metrics, prometheus_endpoint) {
+  using namespace carla::streaming::detail;
+  using boost::asio::ip::tcp;
+
+  io_context_running io;
+  auto &io_context = io.service;
+
+  MetricsServer server(
+      io_context,
+      MetricsServer::endpoint(boost::asio::ip::address_v4::loopback(), TESTING_PORT),
+      []() { return std::string("carla_test 1\n"); });
+
+  auto request = [&](const std::string &text) {
+    tcp::socket socket(io_context);
+    socket.connect(server.GetLocalEndpoint());
+    boost::asio::write(socket, boost::asio::buffer(text));
+    std::string response;
+    boost::system::error_code ec;
+    char data[256u];
+    for (size_t size; (size = socket.read_some(boost::asio::buffer(data), ec)) > 0u || !ec;) {
+      response.append(data, size);
+    }
+    return response;
+  };
+
+  for (auto i = 0u; i < 3u; ++i) {
+    const auto response = request("GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    ASSERT_EQ(response.find("HTTP/1.1 200 OK\r\n"), 0u);
+    ASSERT_NE(response.find("Content-Length: 13\r\n"), std::string::npos);
+    ASSERT_EQ(response.substr(response.size() - 13u), "carla_test 1\n");
+  }
+  const auto response = request("POST /metrics HTTP/1.1\r\n\r\n");
+  ASSERT_EQ(response.find("HTTP/1.1 405 Method Not Allowed\r\n"), 0u);
+
+  io_context.stop();
+}
+
+TEST(streaming_metrics, prometheus_endpoint_timeout) {
+  using namespace carla::streaming::detail;
+  using boost::asio::ip::tcp;
+
+  io_context_running io;
+  auto &io_context = io.service;
+
+  MetricsServer server(
+      io_context,
+      MetricsServer::endpoint(boost::asio::ip::address_v4::loopback(), TESTING_PORT),
+      []() { return std::string("carla_test 1\n"); },
+      carla::time_duration::milliseconds(50u));
+
+  // An idle connection is closed without response.
+  tcp::socket socket(io_context);
+  socket.connect(server.GetLocalEndpoint());
+  const auto begin = std::chrono::steady_clock::now();
+  boost::system::error_code ec;
+  char data[16u];
+  ASSERT_EQ(socket.read_some(boost::asio::buffer(data), ec), 0u);
+  ASSERT_TRUE(ec);
+  ASSERT_LT(std::chrono::steady_clock::now() - begin, 1s);
+
+  io_context.stop();
+}
+
+TEST(streaming_metrics, prometheus_endpoint_port_in_use) {
+  using namespace carla::streaming::detail;
+  using boost::asio::ip::address_v4;
+
+  io_context_running io;
+  auto &io_context = io.service;
+  auto provider = []() { return std::string("carla_test 1\n"); };
+
+  MetricsServer server(io_context, MetricsServer::endpoint(address_v4::loopback(), TESTING_PORT), provider);
+  const auto taken = server.GetLocalEndpoint();
+  ASSERT_THROW(MetricsServer(io_context, taken, provider), boost::system::system_error);
+
+  boost::system::error_code ec;
+  MetricsServer other(io_context, taken, provider, ec);
+  ASSERT_TRUE(ec);
+  ASSERT_EQ(server.GetLocalEndpoint(), taken);
+
+  io_context.stop();
+}
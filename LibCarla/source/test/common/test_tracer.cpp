@@ -0,0 +1,73 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/ThreadGroup.h>
+#include <carla/profiler/Tracer.h>
+
+#include <string>
+
+using carla::profiler::Tracer;
+
+static size_t Count(const std::string &str, const std::string &sub) {
+  size_t count = 0u;
+  for (auto pos = str.find(sub); pos != std::string::npos; pos = str.find(sub, pos + 1u)) {
+    ++count;
+  }
+  return count;
+}
+
+TEST(tracer, disabled_records_nothing) {
+  Tracer::Enable();
+  Tracer::Disable();
+  {
+    CARLA_TRACE_SCOPE(test, disabled);
+  }
+  ASSERT_EQ(Tracer::GetNumberOfEvents(), 0u);
+}
+
+TEST(tracer, nested_scopes_and_frames) {
+  Tracer::Enable();
+  Tracer::SetThreadName("test \"thread\"");
+  CARLA_TRACE_FRAME(42u);
+  {
+    CARLA_TRACE_SCOPE(test, outer);
+    {
+      CARLA_TRACE_SCOPE(test, inner);
+    }
+  }
+  Tracer::Disable();
+  ASSERT_EQ(Tracer::GetNumberOfEvents(), 3u);
+  const auto json = Tracer::ExportChromeTrace();
+  ASSERT_EQ(json.find("{\"traceEvents\":["), 0u);
+  ASSERT_NE(json.find("\"args\":{\"name\":\"test \\\"thread\\\"\"}"), std::string::npos);
+  ASSERT_NE(json.find("{\"name\":\"frame\",\"cat\":\"frame\",\"ph\":\"i\""), std::string::npos);
+  ASSERT_NE(json.find("{\"name\":\"outer\",\"cat\":\"test\",\"ph\":\"X\""), std::string::npos);
+  ASSERT_NE(json.find("{\"name\":\"inner\",\"cat\":\"test\",\"ph\":\"X\""), std::string::npos);
+  ASSERT_EQ(Count(json, "\"args\":{\"frame\":42}"), 3u);
+  // The inner scope ends first.
+  ASSERT_LT(json.find("\"inner\""), json.find("\"outer\""));
+  Tracer::Clear();
+  ASSERT_EQ(Tracer::GetNumberOfEvents(), 0u);
+}
+
+TEST(tracer, ring_keeps_last_events) {
+  Tracer::Enable(4u);
+  carla::ThreadGroup threads;
+  threads.CreateThreads(2u, []() {
+    for (auto i = 0u; i < 10u; ++i) {
+      CARLA_TRACE_SCOPE(test, ring);
+    }
+  });
+  threads.JoinAll();
+  Tracer::Disable();
+  ASSERT_EQ(Tracer::GetNumberOfEvents(), 8u);
+  ASSERT_EQ(Count(Tracer::ExportChromeTrace(), "\"name\":\"ring\""), 8u);
+  Tracer::Enable();
+  Tracer::Disable();
+  ASSERT_EQ(Tracer::GetNumberOfEvents(), 0u);
+}
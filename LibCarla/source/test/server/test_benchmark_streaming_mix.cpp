@@ -0,0 +1,336 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/sensor/data/LidarData.h>
+#include <carla/sensor/s11n/EpisodeStateSerializer.h>
+#include <carla/sensor/s11n/SensorHeaderSerializer.h>
+#include <carla/streaming/Client.h>
+#include <carla/streaming/Metrics.h>
+#include <carla/streaming/Server.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+
+using namespace carla::streaming;
+using namespace std::chrono_literals;
+
+// Benchmarks the streaming layer with the mix of streams a DReyeVR session
+// produces, and reports the results of each stream as a JSON line. If the
+// environment variable LIBCARLA_BENCHMARK_OUTPUT is set, the lines are also
+// appended to the file it names, so the results can be tracked over time.
+
+namespace {
+
+  struct StreamProfile {
+    const char *name;
+    size_t message_size;
+    double frequency;
+  };
+
+  constexpr size_t SensorHeaderSize = sizeof(carla::sensor::s11n::SensorHeaderSerializer::Header);
+
+  constexpr size_t CameraSize(size_t width, size_t height) {
+    return SensorHeaderSize + 4u * width * height;
+  }
+
+  /// One ego vehicle: three cameras, a 64 channel lidar, the DReyeVR
+  /// ego sensor and the episode state with 200 actors.
+  const std::vector<StreamProfile> SensorMix = {
+    {"camera_1280x720", CameraSize(1280u, 720u), 20.0},
+    {"camera_800x600", CameraSize(800u, 600u), 30.0},
+    {"camera_200x200", CameraSize(200u, 200u), 90.0},
+    {"lidar_64", SensorHeaderSize + 56000u * sizeof(carla::sensor::data::LidarDetection), 10.0},
+    // About the size of a DReyeVR sample packed with msgpack.
+    {"dreyevr", SensorHeaderSize + 512u, 90.0},
+    {"episode_state",
+        sizeof(carla::sensor::s11n::EpisodeStateSerializer::Header) +
+        200u * sizeof(carla::sensor::data::ActorDynamicState), 90.0},
+  };
+
+  struct Scenario {
+    const char *name;
+    bool synchronous;
+    size_t subscribers;
+    /// The first subscriber spends this long in each callback. The client
+    /// stops reading meanwhile, so in asynchronous mode the server discards
+    /// the messages it cannot send.
+    std::chrono::milliseconds slow_consumer_delay;
+  };
+
+  constexpr auto SendDuration = 2s;
+
+  std::int64_t Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+
+  /// Process time of every thread. std::clock measures wall time on
+  /// Windows, so there this is an upper bound.
+  double CpuSeconds() {
+    return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+  }
+
+  /// A stream of the mix and what its subscribers received.
+  class StreamLoad : private carla::NonCopyable {
+  public:
+
+    StreamLoad(Server &server, const StreamProfile &profile, size_t subscribers)
+      : profile(profile),
+        stream(server.MakeStream()),
+        received(subscribers),
+        _prototype(profile.message_size, 42u) {}
+
+    /// Send at the frequency of the profile until @a end, the first bytes of
+    /// each message are the time it was sent.
+    void Send(std::chrono::steady_clock::time_point end) {
+      const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(1.0 / profile.frequency));
+      for (auto next = std::chrono::steady_clock::now(); next < end; next += period) {
+        std::this_thread::sleep_until(next);
+        auto buffer = stream.MakeBuffer(profile.message_size);
+        buffer.copy_from(_prototype);
+        const auto timestamp = Now();
+        std::memcpy(buffer.data(), &timestamp, sizeof(timestamp));
+        stream.Write(std::move(buffer));
+        ++sent;
+      }
+    }
+
+    void OnMessage(size_t subscriber, const carla::Buffer &message, bool slow) {
+      DEBUG_ASSERT_EQ(message.size(), profile.message_size);
+      std::int64_t timestamp;
+      std::memcpy(&timestamp, message.data(), sizeof(timestamp));
+      (slow ? slow_latency : latency).Record(std::chrono::nanoseconds(Now() - timestamp));
+      ++received[subscriber];
+    }
+
+    const StreamProfile profile;
+
+    Stream stream;
+
+    std::atomic_size_t sent{0u};
+
+    std::vector<std::atomic_size_t> received;
+
+    /// Latency of the subscribers that are not slow.
+    LatencyHistogram latency;
+
+    LatencyHistogram slow_latency;
+
+  private:
+
+    const std::vector<unsigned char> _prototype;
+  };
+
+  class MixedLoadBenchmark {
+  public:
+
+    explicit MixedLoadBenchmark(const Scenario &scenario)
+      : _scenario(scenario),
+        _server(TESTING_PORT) {
+      _server.SetSynchronousMode(scenario.synchronous);
+      for (const auto &profile : SensorMix) {
+        _loads.emplace_back(std::make_unique<StreamLoad>(_server, profile, scenario.subscribers));
+      }
+      for (auto i = 0u; i < scenario.subscribers; ++i) {
+        _clients.emplace_back(std::make_unique<Client>());
+        const bool slow = (i == 0u) && (scenario.slow_consumer_delay > 0ms);
+        const auto delay = scenario.slow_consumer_delay;
+        for (auto &load : _loads) {
+          auto *stream_load = load.get();
+          _clients.back()->Subscribe(stream_load->stream.token(), [=](carla::Buffer message) {
+            stream_load->OnMessage(i, message, slow);
+            if (slow) {
+              std::this_thread::sleep_for(delay);
+            }
+          });
+        }
+      }
+    }
+
+    void Run() {
+      // In synchronous mode a session blocks its thread until the previous
+      // message is sent, keep a thread free for the sends to complete.
+      _server.AsyncRun(_loads.size() * _scenario.subscribers + 1u);
+      for (auto &client : _clients) {
+        client->AsyncRun(_loads.size());
+      }
+      std::this_thread::sleep_for(1s); // let the clients connect.
+
+      const auto cpu_begin = CpuSeconds();
+      const auto begin = std::chrono::steady_clock::now();
+      {
+        carla::ThreadGroup senders;
+        const auto end = begin + SendDuration;
+        for (auto &load : _loads) {
+          senders.CreateThread([&load, end]() { load->Send(end); });
+        }
+      }
+      WaitForDelivery();
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+      const auto cpu_per_message = (CpuSeconds() - cpu_begin) / std::max<double>(1.0, TotalReceived());
+
+      const auto server_metrics = _server.GetMetrics();
+      for (auto &load : _loads) {
+        std::uint64_t dropped = 0u;
+        for (const auto &metrics : server_metrics) {
+          if (metrics.stream_id == detail::token_type(load->stream.token()).get_stream_id()) {
+            dropped = metrics.dropped;
+          }
+        }
+        Report(*load, dropped, elapsed.count(), cpu_per_message);
+      }
+    }
+
+  private:
+
+    size_t TotalReceived() const {
+      size_t total = 0u;
+      for (const auto &load : _loads) {
+        for (const auto &count : load->received) {
+          total += count;
+        }
+      }
+      return total;
+    }
+
+    /// Wait until every message sent is received or discarded, or until
+    /// no message arrives for a second.
+    void WaitForDelivery() const {
+      size_t expected = 0u;
+      for (const auto &load : _loads) {
+        expected += load->sent * _scenario.subscribers;
+      }
+      auto received = TotalReceived();
+      for (auto idle = 0ms; idle < 1s; idle += 50ms) {
+        std::uint64_t dropped = 0u;
+        for (const auto &metrics : _server.GetMetrics()) {
+          dropped += metrics.dropped;
+        }
+        if (received + dropped >= expected) {
+          return;
+        }
+        std::this_thread::sleep_for(50ms);
+        const auto now_received = TotalReceived();
+        if (now_received != received) {
+          received = now_received;
+          idle = 0ms;
+        }
+      }
+    }
+
+    void Report(const StreamLoad &load, std::uint64_t dropped, double elapsed, double cpu_per_message) const {
+      const bool has_slow = _scenario.slow_consumer_delay > 0ms;
+      size_t received = 0u;
+      for (auto i = has_slow ? 1u : 0u; i < _scenario.subscribers; ++i) {
+        received += load.received[i];
+      }
+      const auto sent = static_cast<size_t>(load.sent);
+      const auto deliveries = sent * _scenario.subscribers;
+      const auto latency = load.latency.GetSummary();
+      const auto slow_latency = load.slow_latency.GetSummary();
+      const auto to_us = [](std::uint64_t ns) { return 1e-3 * static_cast<double>(ns); };
+
+      std::ostringstream out;
+      out << std::fixed << std::setprecision(3)
+          << "{\"benchmark\":\"streaming_mix\""
+          << ",\"scenario\":\"" << _scenario.name << '"'
+          << ",\"mode\":\"" << (_scenario.synchronous ? "sync" : "async") << '"'
+          << ",\"subscribers\":" << _scenario.subscribers
+          << ",\"slow_consumer\":" << (has_slow ? "true" : "false")
+          << ",\"stream\":\"" << load.profile.name << '"'
+          << ",\"message_size\":" << load.profile.message_size
+          << ",\"frequency_hz\":" << load.profile.frequency
+          << ",\"sent\":" << sent
+          << ",\"received\":" << received
+          << ",\"slow_received\":" << (has_slow ? static_cast<size_t>(load.received[0u]) : 0u)
+          << ",\"dropped\":" << dropped
+          << ",\"drop_rate\":" << (deliveries > 0u ? static_cast<double>(dropped) / deliveries : 0.0)
+          << ",\"throughput_msg_s\":" << received / elapsed
+          << ",\"throughput_mb_s\":" << 1e-6 * static_cast<double>(received * load.profile.message_size) / elapsed
+          << ",\"latency_p50_us\":" << to_us(latency.p50)
+          << ",\"latency_p99_us\":" << to_us(latency.p99)
+          << ",\"latency_p999_us\":" << to_us(latency.p999)
+          << ",\"slow_latency_p99_us\":" << to_us(slow_latency.p99)
+          << ",\"cpu_us_per_message\":" << 1e6 * cpu_per_message
+          << '}';
+      const auto line = out.str();
+      carla::logging::log(line);
+      const char *path = std::getenv("LIBCARLA_BENCHMARK_OUTPUT");
+      if (path != nullptr) {
+        std::ofstream(path, std::ios::app) << line << '\n';
+      }
+
+      ASSERT_GT(sent, 0u);
+      ASSERT_LE(received + dropped, deliveries);
+      if (_scenario.synchronous) {
+        // The synchronous mode waits for the previous message instead of
+        // discarding it.
+        ASSERT_EQ(dropped, 0u);
+      }
+      const auto normal_subscribers = _scenario.subscribers - (has_slow ? 1u : 0u);
+      const auto threshold = static_cast<size_t>(0.9 * static_cast<double>(sent * normal_subscribers));
+#ifdef NDEBUG
+      ASSERT_GE(received, threshold);
+#else
+      if (received < threshold) {
+        carla::log_warning("threshold unmet:", load.profile.name, received, '/', threshold);
+      }
+#endif // NDEBUG
+    }
+
+    const Scenario _scenario;
+
+    // The loads keep the streams, they are destroyed after the server stops.
+
+    std::vector<std::unique_ptr<StreamLoad>> _loads;
+
+    Server _server;
+
+    std::vector<std::unique_ptr<Client>> _clients;
+  };
+
+  void benchmark_mix(const Scenario &scenario) {
+    MixedLoadBenchmark benchmark(scenario);
+    benchmark.Run();
+  }
+
+} // namespace
+
+TEST(benchmark_streaming_mix, async_1_subscriber) {
+  benchmark_mix({"async_1_subscriber", false, 1u, 0ms});
+}
+
+TEST(benchmark_streaming_mix, sync_1_subscriber) {
+  benchmark_mix({"sync_1_subscriber", true, 1u, 0ms});
+}
+
+TEST(benchmark_streaming_mix, async_2_subscribers) {
+  benchmark_mix({"async_2_subscribers", false, 2u, 0ms});
+}
+
+TEST(benchmark_streaming_mix, async_4_subscribers) {
+  benchmark_mix({"async_4_subscribers", false, 4u, 0ms});
+}
+
+TEST(benchmark_streaming_mix, sync_4_subscribers) {
+  benchmark_mix({"sync_4_subscribers", true, 4u, 0ms});
+}
+
+TEST(benchmark_streaming_mix, async_slow_consumer) {
+  benchmark_mix({"async_slow_consumer", false, 3u, 20ms});
+}
+
+TEST(benchmark_streaming_mix, sync_slow_consumer) {
+  benchmark_mix({"sync_slow_consumer", true, 3u, 20ms});
+}
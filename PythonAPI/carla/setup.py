@@ -53,7 +53,6 @@ def get_libcarla_extensions():
                 os.path.join(pwd, 'dependencies/lib/libDetourCrowd.a'),
                 os.path.join(pwd, 'dependencies/lib/libosm2odr.a'),
                 os.path.join(pwd, 'dependencies/lib/libxerces-c.a')]
-            extra_link_args += ['-lz']
             extra_compile_args = [
                 '-isystem', 'dependencies/include/system', '-fPIC', '-std=c++14',
                 '-Werror', '-Wall', '-Wextra', '-Wpedantic', '-Wno-self-assign-overloaded',
@@ -93,6 +92,9 @@ def get_libcarla_extensions():
             else:
                 extra_link_args += ['-lpng', '-ljpeg', '-ltiff']
                 extra_compile_args += ['-DLIBCARLA_IMAGE_WITH_PNG_SUPPORT=true']
+            # zlib is required by libpng, xerces and the compressed point cloud
+            # formats, keep it after all of them (also when PNG is disabled).
+            extra_link_args += ['-lz']
             # @todo Why would we need this?
             # include_dirs += ['/usr/lib/gcc/x86_64-linux-gnu/7/include']
             # library_dirs += ['/usr/lib/gcc/x86_64-linux-gnu/7']
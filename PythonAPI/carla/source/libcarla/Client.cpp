@@ -6,11 +6,16 @@
 
 #include "carla/PythonUtil.h"
 #include "carla/client/Client.h"
+#include "carla/client/RpcBatch.h"
 #include "carla/client/World.h"
 #include "carla/Logging.h"
 #include "carla/rpc/ActorId.h"
+#include "carla/streaming/Metrics.h"
 #include "carla/trafficmanager/TrafficManager.h"
 
+#include <chrono>
+#include <functional>
+#include <future>
 #include <thread>
 
 #include <boost/python/stl_iterator.hpp>
@@ -38,6 +43,22 @@ static auto GetRequiredFiles(const carla::client::Client &self, const std::strin
   return result;
 }
 
+static auto GetStreamingMetrics(const carla::client::Client &self) {
+  boost::python::list result;
+  for (const auto &metrics : self.GetStreamingMetrics()) {
+    result.append(metrics);
+  }
+  return result;
+}
+
+static std::string GetStreamingMetricsPrometheus(const carla::client::Client &self) {
+  return carla::streaming::WritePrometheusMetrics(self.GetStreamingMetrics(), "client");
+}
+
+static double NanosecondsToSeconds(uint64_t ns) {
+  return 1e-9 * static_cast<double>(ns);
+}
+
 static void ApplyBatchCommands(
     const carla::client::Client &self,
     const boost::python::object &commands,
@@ -165,6 +186,101 @@ static auto ApplyBatchCommandsSync(
   return result;
 }
 
+// Python side of a call queued in a carla::client::RpcBatch. The value is
+// converted to a Python object only when requested, with the GIL held.
+class RpcFuture {
+public:
+
+  template <typename T, typename ConverterT>
+  RpcFuture(
+      carla::SharedPtr<carla::client::RpcBatch> batch,
+      std::future<T> future,
+      ConverterT &&convert)
+    : _batch(std::move(batch)) {
+    auto shared = future.share();
+    _is_ready = [shared]() {
+      return shared.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    };
+    _get = [shared, convert=std::forward<ConverterT>(convert)]() {
+      return convert(shared.get());
+    };
+  }
+
+  RpcFuture(
+      carla::SharedPtr<carla::client::RpcBatch> batch,
+      std::future<void> future)
+    : _batch(std::move(batch)) {
+    auto shared = future.share();
+    _is_ready = [shared]() {
+      return shared.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    };
+    _get = [shared]() {
+      shared.get();
+      return boost::python::object();
+    };
+  }
+
+  bool IsReady() const {
+    return _is_ready();
+  }
+
+  /// Sends the batch if the call is still queued.
+  boost::python::object GetResult() const {
+    if (!IsReady()) {
+      carla::PythonUtil::ReleaseGIL unlock;
+      _batch->Send();
+    }
+    return _get();
+  }
+
+private:
+
+  carla::SharedPtr<carla::client::RpcBatch> _batch;
+
+  std::function<bool()> _is_ready;
+
+  std::function<boost::python::object()> _get;
+};
+
+template <typename T>
+static RpcFuture MakeRpcFuture(carla::SharedPtr<carla::client::RpcBatch> batch, std::future<T> future) {
+  return RpcFuture(std::move(batch), std::move(future), [](const T &value) {
+    return boost::python::object(value);
+  });
+}
+
+static RpcFuture MakeRpcFuture(carla::SharedPtr<carla::client::RpcBatch> batch, std::future<void> future) {
+  return RpcFuture(std::move(batch), std::move(future));
+}
+
+#define RPC_BATCH_CALL(fn) +[](carla::SharedPtr<carla::client::RpcBatch> self, carla::rpc::ActorId id) { \
+      auto future = self->fn(id); \
+      return MakeRpcFuture(std::move(self), std::move(future)); \
+    }
+
+#define RPC_BATCH_CALL_1(fn, T1) +[](carla::SharedPtr<carla::client::RpcBatch> self, carla::rpc::ActorId id, T1 t1) { \
+      auto future = self->fn(id, t1); \
+      return MakeRpcFuture(std::move(self), std::move(future)); \
+    }
+
+static void RpcBatchSend(carla::client::RpcBatch &self) {
+  carla::PythonUtil::ReleaseGIL unlock;
+  self.Send();
+}
+
+static bool RpcBatchExit(
+    carla::client::RpcBatch &self,
+    const boost::python::object &exc_type,
+    const boost::python::object &,
+    const boost::python::object &) {
+  if (exc_type.is_none()) {
+    RpcBatchSend(self);
+  } else {
+    self.Discard();
+  }
+  return false;
+}
+
 void export_client() {
   using namespace boost::python;
   namespace cc = carla::client;
@@ -181,6 +297,30 @@ void export_client() {
     .def_readwrite("enable_pedestrian_navigation", &rpc::OpendriveGenerationParameters::enable_pedestrian_navigation)
   ;
 
+  namespace cs = carla::streaming;
+
+  class_<cs::LatencySummary>("LatencySummary", no_init)
+    .def_readonly("count", &cs::LatencySummary::count)
+    .add_property("min", +[](const cs::LatencySummary &self) { return NanosecondsToSeconds(self.min); })
+    .add_property("max", +[](const cs::LatencySummary &self) { return NanosecondsToSeconds(self.max); })
+    .add_property("mean", +[](const cs::LatencySummary &self) { return 1e-9 * self.mean(); })
+    .add_property("p50", +[](const cs::LatencySummary &self) { return NanosecondsToSeconds(self.p50); })
+    .add_property("p90", +[](const cs::LatencySummary &self) { return NanosecondsToSeconds(self.p90); })
+    .add_property("p99", +[](const cs::LatencySummary &self) { return NanosecondsToSeconds(self.p99); })
+    .add_property("p999", +[](const cs::LatencySummary &self) { return NanosecondsToSeconds(self.p999); })
+  ;
+
+  class_<cs::StreamMetrics>("StreamMetrics", no_init)
+    .def_readonly("stream_id", &cs::StreamMetrics::stream_id)
+    .def_readonly("messages", &cs::StreamMetrics::messages)
+    .def_readonly("bytes", &cs::StreamMetrics::bytes)
+    .def_readonly("dropped", &cs::StreamMetrics::dropped)
+    .def_readonly("queue_depth", &cs::StreamMetrics::queue_depth)
+    .def_readonly("max_queue_depth", &cs::StreamMetrics::max_queue_depth)
+    .def_readonly("connections", &cs::StreamMetrics::connections)
+    .def_readonly("latency", &cs::StreamMetrics::latency)
+  ;
+
   class_<cc::Client>("Client",
       init<std::string, uint16_t, size_t>((arg("host"), arg("port"), arg("worker_threads")=0u)))
     .def("set_timeout", &::SetTimeout, (arg("seconds")))
@@ -208,5 +348,37 @@ void export_client() {
     .def("apply_batch", &ApplyBatchCommands, (arg("commands"), arg("do_tick")=false))
     .def("apply_batch_sync", &ApplyBatchCommandsSync, (arg("commands"), arg("do_tick")=false))
     .def("get_trafficmanager", CONST_CALL_WITHOUT_GIL_1(cc::Client, GetInstanceTM, uint16_t), (arg("port")=ctm::TM_DEFAULT_PORT))
+    .def("batch", &cc::Client::MakeRpcBatch)
+    .def("get_streaming_metrics", &GetStreamingMetrics)
+    .def("get_streaming_metrics_prometheus", &GetStreamingMetricsPrometheus)
+    .def("serve_streaming_metrics", &cc::Client::ServeStreamingMetrics, (arg("port")=0u))
+  ;
+
+  class_<RpcFuture>("RpcFuture", no_init)
+    .def("done", &RpcFuture::IsReady)
+    .def("result", &RpcFuture::GetResult)
+  ;
+
+  class_<cc::RpcBatch, boost::noncopyable, boost::shared_ptr<cc::RpcBatch>>("RpcBatch", no_init)
+    .def("__len__", &cc::RpcBatch::GetSize)
+    .def("__enter__", +[](object self) { return self; })
+    .def("__exit__", &RpcBatchExit, (arg("exc_type"), arg("exc_value"), arg("traceback")))
+    .def("send", &RpcBatchSend)
+    .def("discard", &cc::RpcBatch::Discard)
+    .def("get_physics_control", RPC_BATCH_CALL(GetVehiclePhysicsControl), (arg("actor_id")))
+    .def("get_light_state", +[](carla::SharedPtr<cc::RpcBatch> self, rpc::ActorId id) {
+      auto future = self->GetVehicleLightState(id);
+      return RpcFuture(std::move(self), std::move(future), [](const rpc::VehicleLightState &state) {
+        return object(state.GetLightStateEnum());
+      });
+    }, (arg("actor_id")))
+    .def("apply_physics_control", RPC_BATCH_CALL_1(ApplyPhysicsControl, const rpc::VehiclePhysicsControl &), (arg("actor_id"), arg("physics_control")))
+    .def("set_light_state", RPC_BATCH_CALL_1(SetVehicleLightState, rpc::VehicleLightState::LightState), (arg("actor_id"), arg("light_state")))
+    .def("set_location", RPC_BATCH_CALL_1(SetActorLocation, const carla::geom::Location &), (arg("actor_id"), arg("location")))
+    .def("set_transform", RPC_BATCH_CALL_1(SetActorTransform, const carla::geom::Transform &), (arg("actor_id"), arg("transform")))
+    .def("set_target_velocity", RPC_BATCH_CALL_1(SetActorTargetVelocity, const carla::geom::Vector3D &), (arg("actor_id"), arg("velocity")))
+    .def("set_target_angular_velocity", RPC_BATCH_CALL_1(SetActorTargetAngularVelocity, const carla::geom::Vector3D &), (arg("actor_id"), arg("angular_velocity")))
+    .def("set_simulate_physics", RPC_BATCH_CALL_1(SetActorSimulatePhysics, bool), (arg("actor_id"), arg("enabled")=true))
+    .def("set_enable_gravity", RPC_BATCH_CALL_1(SetActorEnableGravity, bool), (arg("actor_id"), arg("enabled")=true))
   ;
 }
@@ -0,0 +1,49 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include <carla/AsyncLogging.h>
+#include <carla/PythonUtil.h>
+
+static void StartAsyncLogging(
+    size_t queue_size,
+    double flush_interval_seconds,
+    bool write_to_console,
+    std::string binary_file) {
+  carla::logging::AsyncLoggingOptions options;
+  options.queue_size = queue_size;
+  options.flush_interval = std::chrono::milliseconds(static_cast<int64_t>(1e3 * flush_interval_seconds));
+  options.write_to_console = write_to_console;
+  options.binary_file = std::move(binary_file);
+  carla::PythonUtil::ReleaseGIL unlock;
+  carla::logging::StartAsyncLogging(options);
+}
+
+static void StopAsyncLogging() {
+  carla::PythonUtil::ReleaseGIL unlock;
+  carla::logging::StopAsyncLogging();
+}
+
+static void FlushLog() {
+  carla::PythonUtil::ReleaseGIL unlock;
+  carla::logging::FlushLog();
+}
+
+void export_logging() {
+  using namespace boost::python;
+  namespace cl = carla::logging;
+
+  def("start_async_logging", &StartAsyncLogging,
+      (arg("queue_size")=256u,
+       arg("flush_interval")=0.01,
+       arg("write_to_console")=true,
+       arg("binary_file")=std::string()));
+  def("stop_async_logging", &StopAsyncLogging);
+  def("is_async_logging_enabled", &cl::IsAsyncLoggingEnabled);
+  def("flush_log", &FlushLog);
+  def("get_number_of_dropped_log_messages", &cl::GetNumberOfDroppedLogMessages);
+  def("set_log_level", &cl::SetLogLevel, arg("level"));
+  def("get_log_level", &cl::GetLogLevel);
+}
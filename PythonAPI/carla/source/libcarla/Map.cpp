@@ -72,6 +72,36 @@ static auto GetLaneValidities(const carla::client::Landmark &self){
   return result;
 }
 
+static auto ComputeRoute(
+    const carla::client::Map &self,
+    const carla::client::Waypoint &origin,
+    const carla::client::Waypoint &destination,
+    carla::road::RoutingGraph::Metric metric) {
+  std::vector<carla::SharedPtr<carla::client::Waypoint>> route;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    route = self.ComputeRoute(origin, destination, metric);
+  }
+  boost::python::list result;
+  for (auto &&waypoint : route) {
+    result.append(waypoint);
+  }
+  return result;
+}
+
+static void SaveRoutingGraph(
+    const carla::client::Map &self,
+    const std::string &path,
+    carla::road::RoutingGraph::Metric metric) {
+  carla::PythonUtil::ReleaseGIL unlock;
+  self.SaveRoutingGraph(path, metric);
+}
+
+static bool LoadRoutingGraph(const carla::client::Map &self, const std::string &path) {
+  carla::PythonUtil::ReleaseGIL unlock;
+  return self.LoadRoutingGraph(path);
+}
+
 static carla::geom::GeoLocation ToGeolocation(
     const carla::client::Map &self,
     const carla::geom::Location &location) {
@@ -114,6 +144,11 @@ void export_map() {
     .value("Any", cr::Lane::LaneType::Any)
   ;
 
+  enum_<cr::RoutingGraph::Metric>("RouteMetric")
+    .value("Distance", cr::RoutingGraph::Metric::Distance)
+    .value("Time", cr::RoutingGraph::Metric::Time)
+  ;
+
   enum_<cre::LaneMarking::LaneChange>("LaneChange")
     .value("NONE", cre::LaneMarking::LaneChange::None)
     .value("Right", cre::LaneMarking::LaneChange::Right)
@@ -171,6 +206,9 @@ void export_map() {
     .def("get_all_landmarks_of_type", CALL_RETURNING_LIST_1(cc::Map, GetAllLandmarksOfType, std::string), (args("type")))
     .def("get_landmark_group", CALL_RETURNING_LIST_1(cc::Map, GetLandmarkGroup, cc::Landmark), args("landmark"))
     .def("cook_in_memory_map", &cc::Map::CookInMemoryMap, (arg("path")=""))
+    .def("compute_route", &ComputeRoute, (arg("origin"), arg("destination"), arg("metric")=cr::RoutingGraph::Metric::Distance))
+    .def("save_routing_graph", &SaveRoutingGraph, (arg("path"), arg("metric")=cr::RoutingGraph::Metric::Distance))
+    .def("load_routing_graph", &LoadRoutingGraph, (arg("path")))
     .def(self_ns::str(self_ns::self))
   ;
 
@@ -8,23 +8,135 @@
 #include <carla/client/ClientSideSensor.h>
 #include <carla/client/LaneInvasionSensor.h>
 #include <carla/client/Sensor.h>
+#include <carla/client/SensorBundle.h>
+#include <carla/client/SensorDataQueue.h>
 #include <carla/client/ServerSideSensor.h>
+#include <carla/sensor/SensorData.h>
 
-static void SubscribeToStream(carla::client::Sensor &self, boost::python::object callback) {
+template <typename T>
+static void SubscribeToStream(T &self, boost::python::object callback) {
   self.Listen(MakeCallback(std::move(callback)));
 }
 
+template <typename T>
+static auto SubscribeToQueue(
+    T &self,
+    size_t max_size,
+    carla::client::SensorDataQueue::OverflowPolicy policy) {
+  auto queue = carla::MakeShared<carla::client::SensorDataQueue>(max_size, policy);
+  self.Listen(queue->MakeCallback());
+  return queue;
+}
+
+static auto MakeSensorBundle(
+    const boost::python::object &sensors,
+    double timeout,
+    carla::client::SensorBundle::PartialFramePolicy partial_policy,
+    size_t max_pending_frames) {
+  std::vector<carla::SharedPtr<carla::client::Sensor>> list{
+      boost::python::stl_input_iterator<carla::SharedPtr<carla::client::Sensor>>(sensors),
+      boost::python::stl_input_iterator<carla::SharedPtr<carla::client::Sensor>>()};
+  carla::client::SensorBundle::Parameters parameters;
+  parameters.timeout = TimeDurationFromSeconds(timeout);
+  parameters.partial_policy = partial_policy;
+  parameters.max_pending_frames = max_pending_frames;
+  return boost::shared_ptr<carla::client::SensorBundle>(
+      new carla::client::SensorBundle(std::move(list), parameters));
+}
+
+static carla::SharedPtr<carla::sensor::SensorData> QueueGet(
+    carla::client::SensorDataQueue &self,
+    double timeout,
+    boost::python::object frame) {
+  const auto duration = TimeDurationFromSeconds(timeout);
+  if (frame.is_none()) {
+    carla::PythonUtil::ReleaseGIL unlock;
+    return self.Pop(duration);
+  }
+  const auto number = boost::python::extract<uint64_t>(frame)();
+  carla::PythonUtil::ReleaseGIL unlock;
+  return self.PopFrame(number, duration);
+}
+
+static boost::python::list QueueGetBatch(
+    carla::client::SensorDataQueue &self,
+    size_t max_items,
+    double timeout) {
+  std::vector<carla::SharedPtr<carla::sensor::SensorData>> batch;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    batch = self.PopBatch(max_items, TimeDurationFromSeconds(timeout));
+  }
+  boost::python::list result;
+  for (auto &&data : batch) {
+    result.append(data);
+  }
+  return result;
+}
+
 void export_sensor() {
   using namespace boost::python;
   namespace cc = carla::client;
 
+  enum_<cc::SensorDataQueue::OverflowPolicy>("SensorQueuePolicy")
+    .value("DropOldest", cc::SensorDataQueue::OverflowPolicy::DropOldest)
+    .value("DropNewest", cc::SensorDataQueue::OverflowPolicy::DropNewest)
+  ;
+
+  class_<cc::SensorDataQueue::Stats>("SensorDataQueueStats", no_init)
+    .def_readonly("received", &cc::SensorDataQueue::Stats::received)
+    .def_readonly("delivered", &cc::SensorDataQueue::Stats::delivered)
+    .def_readonly("dropped", &cc::SensorDataQueue::Stats::dropped)
+    .def_readonly("skipped", &cc::SensorDataQueue::Stats::skipped)
+    .def_readonly("max_size_reached", &cc::SensorDataQueue::Stats::max_size_reached)
+  ;
+
+  class_<cc::SensorDataQueue, boost::noncopyable, boost::shared_ptr<cc::SensorDataQueue>>("SensorDataQueue", no_init)
+    .add_property("maxsize", &cc::SensorDataQueue::GetMaxSize)
+    .add_property("policy", &cc::SensorDataQueue::GetOverflowPolicy)
+    .def("get", &QueueGet, (arg("timeout")=10.0, arg("frame")=boost::python::object()))
+    .def("get_batch", &QueueGetBatch, (arg("max_items")=0u, arg("timeout")=10.0))
+    .def("qsize", &cc::SensorDataQueue::GetSize)
+    .def("__len__", &cc::SensorDataQueue::GetSize)
+    .def("clear", &cc::SensorDataQueue::Clear)
+    .def("get_stats", &cc::SensorDataQueue::GetStats)
+  ;
+
   class_<cc::Sensor, bases<cc::Actor>, boost::noncopyable, boost::shared_ptr<cc::Sensor>>("Sensor", no_init)
     .add_property("is_listening", &cc::Sensor::IsListening)
-    .def("listen", &SubscribeToStream, (arg("callback")))
+    .def("listen", &SubscribeToStream<cc::Sensor>, (arg("callback")))
+    .def("listen_queue", &SubscribeToQueue<cc::Sensor>, (arg("maxsize")=16u, arg("policy")=cc::SensorDataQueue::OverflowPolicy::DropOldest))
     .def("stop", &cc::Sensor::Stop)
     .def(self_ns::str(self_ns::self))
   ;
 
+  enum_<cc::SensorBundle::PartialFramePolicy>("PartialFramePolicy")
+    .value("Drop", cc::SensorBundle::PartialFramePolicy::Drop)
+    .value("Deliver", cc::SensorBundle::PartialFramePolicy::Deliver)
+  ;
+
+  class_<cc::SensorBundle::Stats>("SensorBundleStats", no_init)
+    .def_readonly("complete", &cc::SensorBundle::Stats::complete)
+    .def_readonly("partial", &cc::SensorBundle::Stats::partial)
+    .def_readonly("dropped", &cc::SensorBundle::Stats::dropped)
+    .def_readonly("late", &cc::SensorBundle::Stats::late)
+  ;
+
+  class_<cc::SensorBundle, boost::noncopyable, boost::shared_ptr<cc::SensorBundle>>("SensorBundle", no_init)
+    .def("__init__", make_constructor(&MakeSensorBundle, default_call_policies(), (
+        arg("sensors"),
+        arg("timeout")=1.0,
+        arg("partial_policy")=cc::SensorBundle::PartialFramePolicy::Drop,
+        arg("max_pending_frames")=16u)))
+    .add_property("sensors", CALL_RETURNING_LIST(cc::SensorBundle, GetSensors))
+    .add_property("is_listening", &cc::SensorBundle::IsListening)
+    .def("listen", &SubscribeToStream<cc::SensorBundle>, (arg("callback")))
+    .def("listen_queue", &SubscribeToQueue<cc::SensorBundle>, (arg("maxsize")=16u, arg("policy")=cc::SensorDataQueue::OverflowPolicy::DropOldest))
+    .def("stop", &cc::SensorBundle::Stop)
+    .def("flush", &cc::SensorBundle::Flush)
+    .def("get_stats", &cc::SensorBundle::GetStats)
+  ;
+
   class_<cc::ServerSideSensor, bases<cc::Sensor>, boost::noncopyable, boost::shared_ptr<cc::ServerSideSensor>>
       ("ServerSideSensor", no_init)
     .def(self_ns::str(self_ns::self))
@@ -8,7 +8,9 @@
 #include <carla/image/ImageConverter.h>
 #include <carla/image/ImageIO.h>
 #include <carla/image/ImageView.h>
+#include <carla/pointcloud/PointCloudAccumulator.h>
 #include <carla/pointcloud/PointCloudIO.h>
+#include <carla/pointcloud/PointCloudWriter.h>
 #include <carla/sensor/SensorData.h>
 #include <carla/sensor/data/CollisionEvent.h>
 #include <carla/sensor/data/IMUMeasurement.h>
@@ -21,6 +23,7 @@
 #include <carla/sensor/data/RadarMeasurement.h>
 #include <carla/sensor/data/DVSEventArray.h>
 #include <carla/sensor/data/DReyeVREvent.h> // DReyeVR sensor event
+#include <carla/sensor/data/SensorBundleData.h>
 
 #include <carla/sensor/data/RadarData.h>
 
@@ -31,6 +34,7 @@
 #include <cmath>
 #include <vector>
 #include <algorithm>
+#include <limits>
 #include <thread>
 
 namespace carla {
@@ -92,6 +96,15 @@ namespace data {
     return out;
   }
 
+  std::ostream &operator<<(std::ostream &out, const SensorBundleData &meas) {
+    out << "SensorBundleData(frame=" << std::to_string(meas.GetFrame())
+        << ", timestamp=" << std::to_string(meas.GetTimestamp())
+        << ", size=" << std::to_string(meas.size())
+        << ", complete=" << (meas.IsComplete() ? "True" : "False")
+        << ')';
+    return out;
+  }
+
   std::ostream &operator<<(std::ostream &out, const GnssMeasurement &meas) {
     out << "GnssMeasurement(frame=" << std::to_string(meas.GetFrame())
         << ", timestamp=" << std::to_string(meas.GetTimestamp())
@@ -207,6 +220,104 @@ static auto GetRawDataAsBuffer(T &self) {
   return boost::python::object(boost::python::handle<>(ptr));
 }
 
+/// Allocate a Python bytearray able to hold @a count elements of type T.
+template <typename T>
+static boost::python::object MakeByteArray(size_t count) {
+  auto *ptr = PyByteArray_FromStringAndSize(nullptr, static_cast<Py_ssize_t>(sizeof(T) * count));
+  if (ptr == nullptr) {
+    boost::python::throw_error_already_set();
+  }
+  return boost::python::object(boost::python::handle<>(ptr));
+}
+
+template <typename T>
+static T *GetByteArrayData(const boost::python::object &array) {
+  return reinterpret_cast<T *>(PyByteArray_AS_STRING(array.ptr()));
+}
+
+static boost::python::object DVSToBuffers(const carla::sensor::data::DVSEventArray &self) {
+  auto x = MakeByteArray<std::uint16_t>(self.size());
+  auto y = MakeByteArray<std::uint16_t>(self.size());
+  auto t = MakeByteArray<std::int64_t>(self.size());
+  auto pol = MakeByteArray<std::int16_t>(self.size());
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    self.CopyFields(
+        GetByteArrayData<std::uint16_t>(x),
+        GetByteArrayData<std::uint16_t>(y),
+        GetByteArrayData<std::int64_t>(t),
+        GetByteArrayData<std::int16_t>(pol));
+  }
+  return boost::python::make_tuple(x, y, t, pol);
+}
+
+static boost::python::object DVSToEventFrame(
+    const carla::sensor::data::DVSEventArray &self,
+    boost::python::object t_begin,
+    boost::python::object t_end) {
+  const std::int64_t begin = t_begin.is_none() ?
+      std::numeric_limits<std::int64_t>::lowest() :
+      boost::python::extract<std::int64_t>(t_begin)();
+  const std::int64_t end = t_end.is_none() ?
+      std::numeric_limits<std::int64_t>::max() :
+      boost::python::extract<std::int64_t>(t_end)();
+  auto frame = MakeByteArray<std::int32_t>(self.GetWidth() * self.GetHeight());
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    self.ToEventFrame(begin, end, GetByteArrayData<std::int32_t>(frame));
+  }
+  return frame;
+}
+
+static boost::python::object DVSToVoxelGrid(const carla::sensor::data::DVSEventArray &self, size_t bins) {
+  auto grid = MakeByteArray<float>(bins * self.GetWidth() * self.GetHeight());
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    self.ToVoxelGrid(bins, GetByteArrayData<float>(grid));
+  }
+  return grid;
+}
+
+static void AccumulatePointCloud(
+    carla::pointcloud::PointCloudAccumulator &self,
+    const carla::sensor::data::SemanticLidarMeasurement &measurement) {
+  carla::PythonUtil::ReleaseGIL unlock;
+  self.Add(measurement.GetSensorTransform(), measurement.begin(), measurement.end());
+}
+
+static boost::python::object AccumulatedPointsToBuffers(const carla::pointcloud::PointCloudAccumulator &self) {
+  // Copy into vectors first, the number of points may change until the
+  // accumulator is locked.
+  std::vector<float> xyz;
+  std::vector<std::uint32_t> tags;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    self.CopyPoints(xyz, tags);
+  }
+  auto xyz_array = MakeByteArray<float>(xyz.size());
+  auto tags_array = MakeByteArray<std::uint32_t>(tags.size());
+  std::copy(xyz.begin(), xyz.end(), GetByteArrayData<float>(xyz_array));
+  std::copy(tags.begin(), tags.end(), GetByteArrayData<std::uint32_t>(tags_array));
+  return boost::python::make_tuple(xyz_array, tags_array);
+}
+
+static boost::python::object DownsamplePointCloud(
+    const carla::pointcloud::PointCloudAccumulator &self,
+    float voxel_size) {
+  carla::pointcloud::PointCloudAccumulator::VoxelGrid grid;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    grid = self.Downsample(voxel_size);
+  }
+  auto points = MakeByteArray<float>(grid.points.size());
+  auto tags = MakeByteArray<std::uint32_t>(grid.tags.size());
+  auto counts = MakeByteArray<std::uint32_t>(grid.counts.size());
+  std::copy(grid.points.begin(), grid.points.end(), GetByteArrayData<float>(points));
+  std::copy(grid.tags.begin(), grid.tags.end(), GetByteArrayData<std::uint32_t>(tags));
+  std::copy(grid.counts.begin(), grid.counts.end(), GetByteArrayData<std::uint32_t>(counts));
+  return boost::python::make_tuple(points, tags, counts);
+}
+
 template <typename T>
 static void ConvertImage(T &self, EColorConverter cc) {
   carla::PythonUtil::ReleaseGIL unlock;
@@ -368,10 +479,36 @@ static std::string SaveImageToDisk(T &self, std::string path, EColorConverter cc
   }
 }
 
+/// Shared by every lidar sensor, writes the files in order in its own thread.
+static carla::pointcloud::PointCloudWriter &GetPointCloudWriter() {
+  static carla::pointcloud::PointCloudWriter writer;
+  return writer;
+}
+
+static void FlushPointCloudWriter() {
+  carla::PythonUtil::ReleaseGIL unlock;
+  GetPointCloudWriter().Flush();
+}
+
+static size_t GetNumberOfPendingPointCloudWrites() {
+  return GetPointCloudWriter().GetNumberOfPendingWrites();
+}
+
 template <typename T>
-static std::string SavePointCloudToDisk(T &self, std::string path) {
+static std::string SavePointCloudToDisk(
+    T &self,
+    std::string path,
+    carla::pointcloud::PointCloudFormat format,
+    bool blocking) {
+  if (blocking) {
+    carla::PythonUtil::ReleaseGIL unlock;
+    return carla::pointcloud::PointCloudIO::SaveToDisk(std::move(path), self.begin(), self.end(), format);
+  }
+  // The points are copied while holding the GIL, the measurement can be
+  // released as soon as this returns.
+  std::vector<typename T::value_type> points(self.begin(), self.end());
   carla::PythonUtil::ReleaseGIL unlock;
-  return carla::pointcloud::PointCloudIO::SaveToDisk(std::move(path), self.begin(), self.end());
+  return GetPointCloudWriter().Write(std::move(path), std::move(points), format);
 }
 
 void export_sensor_data() {
@@ -405,6 +542,19 @@ void export_sensor_data() {
     .value("CityScapesPalette", EColorConverter::CityScapesPalette)
   ;
 
+  enum_<carla::pointcloud::PointCloudFormat>("PointCloudFormat")
+    .value("Ascii", carla::pointcloud::PointCloudFormat::Ascii)
+    .value("BinaryLittleEndian", carla::pointcloud::PointCloudFormat::BinaryLittleEndian)
+    .value("Compressed", carla::pointcloud::PointCloudFormat::Compressed)
+  ;
+
+  class_<carla::pointcloud::PointCloudWriter, boost::noncopyable>("PointCloudWriter", no_init)
+    .def("flush", &FlushPointCloudWriter)
+      .staticmethod("flush")
+    .def("get_number_of_pending_writes", &GetNumberOfPendingPointCloudWrites)
+      .staticmethod("get_number_of_pending_writes")
+  ;
+
   class_<csd::Image, bases<cs::SensorData>, boost::noncopyable, boost::shared_ptr<csd::Image>>("Image", no_init)
     .add_property("width", &csd::Image::GetWidth)
     .add_property("height", &csd::Image::GetHeight)
@@ -445,7 +595,7 @@ void export_sensor_data() {
     .add_property("channels", &csd::LidarMeasurement::GetChannelCount)
     .add_property("raw_data", &GetRawDataAsBuffer<csd::LidarMeasurement>)
     .def("get_point_count", &csd::LidarMeasurement::GetPointCount, (arg("channel")))
-    .def("save_to_disk", &SavePointCloudToDisk<csd::LidarMeasurement>, (arg("path")))
+    .def("save_to_disk", &SavePointCloudToDisk<csd::LidarMeasurement>, (arg("path"), arg("format")=carla::pointcloud::PointCloudFormat::Ascii, arg("blocking")=true))
     .def("__len__", &csd::LidarMeasurement::size)
     .def("__iter__", iterator<csd::LidarMeasurement>())
     .def("__getitem__", +[](const csd::LidarMeasurement &self, size_t pos) -> csd::LidarDetection {
@@ -462,7 +612,7 @@ void export_sensor_data() {
     .add_property("channels", &csd::SemanticLidarMeasurement::GetChannelCount)
     .add_property("raw_data", &GetRawDataAsBuffer<csd::SemanticLidarMeasurement>)
     .def("get_point_count", &csd::SemanticLidarMeasurement::GetPointCount, (arg("channel")))
-    .def("save_to_disk", &SavePointCloudToDisk<csd::SemanticLidarMeasurement>, (arg("path")))
+    .def("save_to_disk", &SavePointCloudToDisk<csd::SemanticLidarMeasurement>, (arg("path"), arg("format")=carla::pointcloud::PointCloudFormat::Ascii, arg("blocking")=true))
     .def("__len__", &csd::SemanticLidarMeasurement::size)
     .def("__iter__", iterator<csd::SemanticLidarMeasurement>())
     .def("__getitem__", +[](const csd::SemanticLidarMeasurement &self, size_t pos) -> csd::SemanticLidarDetection {
@@ -474,6 +624,19 @@ void export_sensor_data() {
     .def(self_ns::str(self_ns::self))
   ;
 
+  class_<carla::pointcloud::PointCloudAccumulator, boost::noncopyable, boost::shared_ptr<carla::pointcloud::PointCloudAccumulator>>("PointCloudAccumulator",
+      init<size_t>((arg("window_size")=10u)))
+    .add_property("window_size",
+        &carla::pointcloud::PointCloudAccumulator::GetWindowSize,
+        &carla::pointcloud::PointCloudAccumulator::SetWindowSize)
+    .add_property("frame_count", &carla::pointcloud::PointCloudAccumulator::GetNumberOfFrames)
+    .def("add", &AccumulatePointCloud, (arg("measurement")))
+    .def("clear", &carla::pointcloud::PointCloudAccumulator::Clear)
+    .def("to_buffers", &AccumulatedPointsToBuffers)
+    .def("downsample", &DownsamplePointCloud, (arg("voxel_size")))
+    .def("__len__", &carla::pointcloud::PointCloudAccumulator::GetNumberOfPoints)
+  ;
+
   class_<csd::CollisionEvent, bases<cs::SensorData>, boost::noncopyable, boost::shared_ptr<csd::CollisionEvent>>("CollisionEvent", no_init)
     .add_property("actor", &csd::CollisionEvent::GetActor)
     .add_property("other_actor", &csd::CollisionEvent::GetOtherActor)
@@ -494,6 +657,16 @@ void export_sensor_data() {
     .def(self_ns::str(self_ns::self))
   ;
 
+  class_<csd::SensorBundleData, bases<cs::SensorData>, boost::noncopyable, boost::shared_ptr<csd::SensorBundleData>>("SensorBundleData", no_init)
+    .add_property("is_complete", &csd::SensorBundleData::IsComplete)
+    .def("__len__", &csd::SensorBundleData::size)
+    .def("__iter__", iterator<csd::SensorBundleData>())
+    .def("__getitem__", +[](const csd::SensorBundleData &self, size_t pos) -> carla::SharedPtr<cs::SensorData> {
+      return self.at(pos);
+    })
+    .def(self_ns::str(self_ns::self))
+  ;
+
   class_<csd::GnssMeasurement, bases<cs::SensorData>, boost::noncopyable, boost::shared_ptr<csd::GnssMeasurement>>("GnssMeasurement", no_init)
     .add_property("latitude", &csd::GnssMeasurement::GetLatitude)
     .add_property("longitude", &csd::GnssMeasurement::GetLongitude)
@@ -571,6 +744,9 @@ void export_sensor_data() {
     .def("to_array_y", CALL_RETURNING_LIST(csd::DVSEventArray, ToArrayY))
     .def("to_array_t", CALL_RETURNING_LIST(csd::DVSEventArray, ToArrayT))
     .def("to_array_pol", CALL_RETURNING_LIST(csd::DVSEventArray, ToArrayPol))
+    .def("to_buffers", &DVSToBuffers)
+    .def("to_event_frame", &DVSToEventFrame, (arg("t_begin")=object(), arg("t_end")=object()))
+    .def("to_voxel_grid", &DVSToVoxelGrid, (arg("bins")))
     .def(self_ns::str(self_ns::self))
   ;
 
@@ -0,0 +1,42 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include <carla/PythonUtil.h>
+#include <carla/profiler/Tracer.h>
+
+static std::string ExportChromeTrace() {
+  carla::PythonUtil::ReleaseGIL unlock;
+  return carla::profiler::Tracer::ExportChromeTrace();
+}
+
+static std::string SaveChromeTrace(std::string path) {
+  carla::PythonUtil::ReleaseGIL unlock;
+  return carla::profiler::Tracer::SaveChromeTrace(std::move(path));
+}
+
+void export_tracer() {
+  using namespace boost::python;
+  using carla::profiler::Tracer;
+
+  class_<Tracer>("Tracer", no_init)
+    .def("enable", &Tracer::Enable, (arg("events_per_thread")=Tracer::DefaultEventsPerThread))
+      .staticmethod("enable")
+    .def("disable", &Tracer::Disable)
+      .staticmethod("disable")
+    .def("is_enabled", &Tracer::IsEnabled)
+      .staticmethod("is_enabled")
+    .def("clear", &Tracer::Clear)
+      .staticmethod("clear")
+    .def("mark_frame", &Tracer::MarkFrame, arg("frame"))
+      .staticmethod("mark_frame")
+    .def("get_number_of_events", &Tracer::GetNumberOfEvents)
+      .staticmethod("get_number_of_events")
+    .def("export_chrome_trace", &ExportChromeTrace)
+      .staticmethod("export_chrome_trace")
+    .def("save_chrome_trace", &SaveChromeTrace, arg("path"))
+      .staticmethod("save_chrome_trace")
+  ;
+}
@@ -78,17 +78,53 @@ boost::python::list InterGetActionBuffer(carla::traffic_manager::TrafficManager&
   return l;
 }
 
+void InterApplyParameterUpdates(carla::traffic_manager::TrafficManager& self, boost::python::list input) {
+  namespace ctm = carla::traffic_manager;
+  std::vector<ctm::ParameterUpdate> updates;
+  updates.reserve(len(input));
+  for (int i = 0; i < len(input); ++i) {
+    boost::python::object item = input[i];
+    updates.emplace_back(
+        boost::python::extract<ActorId>(item[0]),
+        boost::python::extract<ctm::VehicleParameter>(item[1]),
+        boost::python::extract<float>(item[2]));
+  }
+  self.ApplyParameterUpdates(updates);
+}
 
 void export_trafficmanager() {
   namespace cc = carla::client;
   namespace ctm = carla::traffic_manager;
   using namespace boost::python;
 
+  class_<ctm::PlanCacheStats>("TrafficManagerPlanCacheStats", no_init)
+    .def_readonly("junction_hits", &ctm::PlanCacheStats::junction_hits)
+    .def_readonly("junction_misses", &ctm::PlanCacheStats::junction_misses)
+    .def_readonly("invalidations", &ctm::PlanCacheStats::invalidations)
+    .add_property("junction_hit_rate", &ctm::PlanCacheStats::GetJunctionHitRate)
+  ;
+
+  enum_<ctm::VehicleParameter>("TrafficManagerParameter")
+    .value("PercentageSpeedDifference", ctm::VehicleParameter::PercentageSpeedDifference)
+    .value("UpdateVehicleLights", ctm::VehicleParameter::UpdateVehicleLights)
+    .value("ForceLaneChange", ctm::VehicleParameter::ForceLaneChange)
+    .value("AutoLaneChange", ctm::VehicleParameter::AutoLaneChange)
+    .value("DistanceToLeadingVehicle", ctm::VehicleParameter::DistanceToLeadingVehicle)
+    .value("PercentageIgnoreWalkers", ctm::VehicleParameter::PercentageIgnoreWalkers)
+    .value("PercentageIgnoreVehicles", ctm::VehicleParameter::PercentageIgnoreVehicles)
+    .value("PercentageRunningLight", ctm::VehicleParameter::PercentageRunningLight)
+    .value("PercentageRunningSign", ctm::VehicleParameter::PercentageRunningSign)
+    .value("KeepRightPercentage", ctm::VehicleParameter::KeepRightPercentage)
+    .value("RandomLeftLaneChangePercentage", ctm::VehicleParameter::RandomLeftLaneChangePercentage)
+    .value("RandomRightLaneChangePercentage", ctm::VehicleParameter::RandomRightLaneChangePercentage)
+  ;
+
   class_<ctm::TrafficManager>("TrafficManager", no_init)
     .def("get_port", &ctm::TrafficManager::Port)
     .def("vehicle_percentage_speed_difference", &ctm::TrafficManager::SetPercentageSpeedDifference)
     .def("global_percentage_speed_difference", &ctm::TrafficManager::SetGlobalPercentageSpeedDifference)
     .def("update_vehicle_lights", &ctm::TrafficManager::SetUpdateVehicleLights)
+    .def("apply_parameter_updates", &InterApplyParameterUpdates)
     .def("collision_detection", &ctm::TrafficManager::SetCollisionDetection)
     .def("force_lane_change", &ctm::TrafficManager::SetForceLaneChange)
     .def("auto_lane_change", &ctm::TrafficManager::SetAutoLaneChange)
@@ -112,5 +148,6 @@ void export_trafficmanager() {
     .def("set_boundaries_respawn_dormant_vehicles", &carla::traffic_manager::TrafficManager::SetBoundariesRespawnDormantVehicles)
     .def("get_next_action", &InterGetNextAction)
     .def("get_all_actions", &InterGetActionBuffer)
+    .def("get_plan_cache_stats", &ctm::TrafficManager::GetPlanCacheStats)
     .def("shut_down", &ctm::TrafficManager::ShutDown);
 }
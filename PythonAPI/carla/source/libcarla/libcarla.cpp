@@ -232,6 +232,8 @@ static auto MakeCallback(boost::python::object callback) {
 #include "TrafficManager.cpp"
 #include "LightManager.cpp"
 #include "OSM2ODR.cpp"
+#include "Tracer.cpp"
+#include "Logging.cpp"
 
 #ifdef LIBCARLA_RSS_ENABLED
 #include "AdRss.cpp"
@@ -262,4 +264,6 @@ BOOST_PYTHON_MODULE(libcarla) {
   export_ad_rss();
   #endif
   export_osm2odr();
+  export_tracer();
+  export_logging();
 }
@@ -27,6 +27,8 @@
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
 
+#include <fstream>
+
 static FString UCarlaEpisode_GetTrafficSignId(ETrafficSignState State)
 {
   using TSS = ETrafficSignState;
@@ -145,20 +147,31 @@ bool UCarlaEpisode::LoadNewOpendriveEpisode(
     return false;
   }
 
-  // Generate the OBJ (as string)
+  // Generate the mesh
   const auto RoadMesh = CarlaMap->GenerateMesh(Params.vertex_distance);
   const auto CrosswalksMesh = CarlaMap->GetAllCrosswalkMesh();
-  const auto RecastOBJ = (RoadMesh + CrosswalksMesh).GenerateOBJForRecast();
 
   const FString AbsoluteOBJPath = FPaths::ConvertRelativePathToFull(
       FPaths::ProjectContentDir() + "Carla/Maps/Nav/OpenDriveMap.obj");
 
-  // Store the OBJ string to a file in order to that RecastBuilder can load it
-  FFileHelper::SaveStringToFile(
-      carla::rpc::ToLongFString(RecastOBJ),
-      *AbsoluteOBJPath,
-      FFileHelper::EEncodingOptions::ForceUTF8,
-      &IFileManager::Get());
+  // Stream the OBJ straight to a file in order to that RecastBuilder can load
+  // it, without building the whole text in memory first
+  {
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(AbsoluteOBJPath), true);
+    std::ofstream OBJFile(TCHAR_TO_UTF8(*AbsoluteOBJPath), std::ios::binary);
+    if (!OBJFile.is_open())
+    {
+      UE_LOG(LogCarla, Error, TEXT("ERROR: could not open %s"), *AbsoluteOBJPath);
+      return false;
+    }
+    (RoadMesh + CrosswalksMesh).WriteOBJForRecast(OBJFile);
+    OBJFile.close();
+    if (OBJFile.fail())
+    {
+      UE_LOG(LogCarla, Error, TEXT("ERROR: could not write %s"), *AbsoluteOBJPath);
+      return false;
+    }
+  }
 
   const FString AbsoluteXODRPath = FPaths::ConvertRelativePathToFull(
       FPaths::ProjectContentDir() + "Carla/Maps/OpenDrive/OpenDriveMap.xodr");
@@ -49,11 +49,13 @@ void ACollisionSensor::OnCollisionEvent(
     const auto &Episode = GetEpisode();
     constexpr float TO_METERS = 1e-2;
     NormalImpulse *= TO_METERS;
-    GetDataStream(*this).Send(
+    auto Stream = GetDataStream(*this);
+    Stream.Send(
         *this,
         Episode.SerializeActor(Actor),
         Episode.SerializeActor(OtherActor),
-        carla::geom::Vector3D{NormalImpulse.X, NormalImpulse.Y, NormalImpulse.Z});
+        carla::geom::Vector3D{NormalImpulse.X, NormalImpulse.Y, NormalImpulse.Z},
+        Stream.PopBufferFromPool());
     // record the collision event
     if (Episode.GetRecorder()->IsEnabled())
       Episode.GetRecorder()->AddCollision(Actor, OtherActor);
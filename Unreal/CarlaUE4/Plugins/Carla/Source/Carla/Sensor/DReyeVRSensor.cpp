@@ -145,7 +145,8 @@ void ADReyeVRSensor::PostPhysTick(UWorld *W, ELevelTick TickType, float DeltaSec
                     Data->GetUserInputs().Brake,          // Vehicle input brake
                     Data->GetUserInputs().ToggledReverse, // Vehicle input gear (reverse, fwd)
                     Data->GetUserInputs().HoldHandbrake   // Vehicle input handbrake
-                });
+                },
+                Stream.PopBufferFromPool());
 }
 
 void ADReyeVRSensor::UpdateData(const DReyeVR::AggregateData &RecorderData, const double Per)
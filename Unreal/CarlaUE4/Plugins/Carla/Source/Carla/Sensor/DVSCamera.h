@@ -7,24 +7,16 @@
 #pragma once
 
 #include "Carla/Sensor/SceneCaptureSensor.h"
+
+#include <compiler/disable-ue4-macros.h>
+#include <carla/sensor/DVSSimulator.h>
 #include <carla/sensor/data/DVSEvent.h>
+#include <compiler/enable-ue4-macros.h>
 
 #include "DVSCamera.generated.h"
 
 namespace dvs
 {
-  /// DVS Configuration structure
-  struct Config
-  {
-    float Cp;
-    float Cm;
-    float sigma_Cp;
-    float sigma_Cm;
-    std::uint64_t refractory_period_ns;
-    bool use_log;
-    float log_eps;
-  };
-
   inline constexpr std::int64_t secToNanosec(double seconds)
   {
     return static_cast<std::int64_t>(seconds * 1e9);
@@ -51,23 +43,9 @@ public:
 
 protected:
   virtual void PostPhysTick(UWorld *World, ELevelTick TickType, float DeltaTime) override;
-  void ImageToGray(const TArray<FColor> &image);
-  void ImageToLogGray(const TArray<FColor> &image);
-  ADVSCamera::DVSEventArray Simulation (float DeltaTime);
+  ADVSCamera::DVSEventArray Simulation(const TArray<FColor> &image);
 
 private:
-  /// Images containing last (current) and previous image
-  TArray<float> last_image, prev_image;
-
-  /// Image containing the last reference value to trigger event
-  TArray<float> ref_values;
-
-  /// Image containing time of last event in seconds
-  TArray<double> last_event_timestamp;
-
-  /// Current time in nanoseconds
-  std::int64_t current_time;
-
-  /// DVS simulation configuration
-  dvs::Config config;
+  /// Event generation model, keeps the state between frames.
+  ::carla::sensor::DVSSimulator simulator;
 };
@@ -58,7 +58,10 @@ void AGnssSensor::PostPhysTick(UWorld *World, ELevelTick TickType, float DeltaSe
   {
     TRACE_CPUPROFILER_EVENT_SCOPE_STR("AGnssSensor Stream Send");
     auto Stream = GetDataStream(*this);
-    Stream.Send(*this, carla::geom::GeoLocation{Latitude, Longitude, Altitude});
+    Stream.Send(
+        *this,
+        carla::geom::GeoLocation{Latitude, Longitude, Altitude},
+        Stream.PopBufferFromPool());
   }
 }
 
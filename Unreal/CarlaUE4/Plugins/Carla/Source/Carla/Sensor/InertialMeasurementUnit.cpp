@@ -189,7 +189,8 @@ void AInertialMeasurementUnit::PostPhysTick(UWorld *World, ELevelTick TickType,
       *this,
       ComputeAccelerometer(DeltaTime),
       ComputeGyroscope(),
-      ComputeCompass());
+      ComputeCompass(),
+      Stream.PopBufferFromPool());
 }
 
 void AInertialMeasurementUnit::SetAccelerationStandardDeviation(const FVector &Vec)
@@ -135,9 +135,11 @@ void AObstacleDetectionSensor::OnObstacleDetectionEvent(
   if ((Actor != nullptr) && (OtherActor != nullptr))
   {
     const auto &Episode = GetEpisode();
-    GetDataStream(*this).Send(*this,
+    auto Stream = GetDataStream(*this);
+    Stream.Send(*this,
         Episode.SerializeActor(Actor),
         Episode.SerializeActor(OtherActor),
-        HitDistance/100.0f);
+        HitDistance/100.0f,
+        Stream.PopBufferFromPool());
   }
 }
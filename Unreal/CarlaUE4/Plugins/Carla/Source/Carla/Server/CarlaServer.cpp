@@ -27,6 +27,7 @@
 #include "Misc/FileHelper.h"
 
 #include <compiler/disable-ue4-macros.h>
+#include <carla/AsyncLogging.h>
 #include <carla/Functional.h>
 #include <carla/Version.h>
 #include <carla/rpc/Actor.h>
@@ -51,6 +52,7 @@
 #include <carla/rpc/Vector3D.h>
 #include <carla/rpc/VehicleDoor.h>
 #include <carla/rpc/VehicleControl.h>
+#include <carla/rpc/VehicleControlBatch.h>
 #include <carla/rpc/VehiclePhysicsControl.h>
 #include <carla/rpc/VehicleLightState.h>
 #include <carla/rpc/VehicleLightStateList.h>
@@ -2071,21 +2073,139 @@ void FCarlaServer::FPimpl::BindActions()
 
 #undef MAKE_RESULT
 
+  // Commands that only update the state of an existing actor. Consecutive
+  // update commands are applied in a single pass once all their actors have
+  // been resolved.
+  auto get_updated_actor = carla::Functional::MakeOverload(
+      [](const C::ApplyVehicleControl &c) -> boost::optional<ActorId> { return c.actor; },
+      [](const C::ApplyWalkerControl &c) -> boost::optional<ActorId> { return c.actor; },
+      [](const C::ApplyTargetVelocity &c) -> boost::optional<ActorId> { return c.actor; },
+      [](const C::ApplyTargetAngularVelocity &c) -> boost::optional<ActorId> { return c.actor; },
+      [](const C::SetVehicleLightState &c) -> boost::optional<ActorId> { return c.actor; },
+      [](const auto &) -> boost::optional<ActorId> { return boost::none; });
+
+  auto apply_update = [](FCarlaActor &CarlaActor, const C::CommandType &command)
+  {
+    auto visitor = carla::Functional::MakeOverload(
+        [&](const C::ApplyVehicleControl &c) {
+          return CarlaActor.ApplyControlToVehicle(c.control, EVehicleInputPriority::Client);
+        },
+        [&](const C::ApplyWalkerControl &c) {
+          return CarlaActor.ApplyControlToWalker(c.control);
+        },
+        [&](const C::ApplyTargetVelocity &c) {
+          return CarlaActor.SetActorTargetVelocity(c.velocity.ToCentimeters().ToFVector());
+        },
+        [&](const C::ApplyTargetAngularVelocity &c) {
+          return CarlaActor.SetActorTargetAngularVelocity(c.angular_velocity.ToFVector());
+        },
+        [&](const C::SetVehicleLightState &c) {
+          return CarlaActor.SetVehicleLightState(FVehicleLightState(cr::VehicleLightState(c.light_state)));
+        },
+        [](const auto &) {
+          return ECarlaServerResponse::FunctionNotSupported;
+        });
+    return boost::apply_visitor(visitor, command);
+  };
+
+  // Applies the commands in order, the results are only generated if
+  // Results is not null.
+  auto execute_batch = [=](
+      const std::vector<cr::Command> &commands,
+      std::vector<CR> *Results)
+  {
+    std::vector<ActorId> Ids;
+    std::vector<FCarlaActor *> Actors;
+    size_t Index = 0u;
+    while (Index < commands.size())
+    {
+      Ids.clear();
+      for (auto i = Index; (Episode != nullptr) && (i < commands.size()); ++i)
+      {
+        auto Id = boost::apply_visitor(get_updated_actor, commands[i].command);
+        if (!Id.has_value())
+        {
+          break;
+        }
+        Ids.emplace_back(*Id);
+      }
+      if (Ids.empty())
+      {
+        auto Result = boost::apply_visitor(command_visitor, commands[Index].command);
+        if (Results != nullptr)
+        {
+          Results->emplace_back(std::move(Result));
+        }
+        ++Index;
+        continue;
+      }
+      Actors.clear();
+      for (auto Id : Ids)
+      {
+        Actors.emplace_back(Episode->FindCarlaActor(Id));
+      }
+      for (auto i = 0u; i < Ids.size(); ++i)
+      {
+        ECarlaServerResponse Response = Actors[i] != nullptr ?
+            apply_update(*Actors[i], commands[Index + i].command) :
+            ECarlaServerResponse::ActorNotFound;
+        if (Results != nullptr)
+        {
+          Results->emplace_back(Response == ECarlaServerResponse::Success ?
+              CR{Ids[i]} :
+              CR{RespondError("apply_batch", Response, " Actor Id: " + FString::FromInt(Ids[i]))});
+        }
+      }
+      Index += Ids.size();
+    }
+  };
+
   BIND_SYNC(apply_batch) << [=](
       const std::vector<cr::Command> &commands,
       bool do_tick_cue)
   {
     std::vector<CR> result;
     result.reserve(commands.size());
-    for (const auto &command : commands)
+    execute_batch(commands, &result);
+    if (do_tick_cue)
     {
-      result.emplace_back(boost::apply_visitor(command_visitor, command.command));
+      tick_cue();
     }
+    return result;
+  };
+
+  // Same as apply_batch, for clients that are not interested in the result
+  // of each command.
+  BIND_SYNC(apply_batch_no_response) << [=](
+      const std::vector<cr::Command> &commands,
+      bool do_tick_cue) -> R<void>
+  {
+    execute_batch(commands, nullptr);
     if (do_tick_cue)
     {
       tick_cue();
     }
-    return result;
+    return R<void>::Success();
+  };
+
+  // Vehicle controls sent as packed arrays, followed by any other command of
+  // the same batch.
+  BIND_SYNC(apply_vehicle_control_batch) << [=](
+      const cr::VehicleControlBatch &controls,
+      const std::vector<cr::Command> &commands) -> R<void>
+  {
+    REQUIRE_CARLA_EPISODE();
+    for (auto i = 0u; i < controls.size(); ++i)
+    {
+      FCarlaActor *CarlaActor = Episode->FindCarlaActor(controls.GetActor(i));
+      if (CarlaActor != nullptr)
+      {
+        CarlaActor->ApplyControlToVehicle(
+            controls.GetControl(i), EVehicleInputPriority::Client);
+      }
+    }
+    execute_batch(commands, nullptr);
+    return R<void>::Success();
   };
 
   // ~~ Light Subsystem ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -2221,9 +2341,45 @@ void FCarlaServer::AsyncRun(uint32 NumberOfWorkerThreads)
   UE_LOG(LogCarla, Log, TEXT("FCarlaServer AsyncRun %d, RPCThreads %d, StreamingThreads %d"),
         NumberOfWorkerThreads, RPCThreads, StreamingThreads);
 
+  // LibCarla logging: minimum level of the messages written, and writing them
+  // from a background thread, optionally to a binary file too.
+  int32 LogLevel = 0;
+  if (FParse::Value(FCommandLine::Get(), TEXT("-carla-log-level="), LogLevel))
+  {
+    carla::logging::SetLogLevel(LogLevel);
+  }
+  FString AsyncLogFile;
+  const bool bAsyncLogFile = FParse::Value(FCommandLine::Get(), TEXT("-carla-async-log-file="), AsyncLogFile);
+  if (bAsyncLogFile || FParse::Param(FCommandLine::Get(), TEXT("carla-async-log")))
+  {
+    carla::logging::AsyncLoggingOptions Options;
+    Options.binary_file = carla::rpc::FromFString(AsyncLogFile);
+    carla::logging::StartAsyncLogging(Options);
+    UE_LOG(LogCarlaServer, Log, TEXT("Asynchronous LibCarla logging enabled"));
+  }
+
   Pimpl->Server.AsyncRun(RPCThreads);
   Pimpl->StreamingServer.AsyncRun(StreamingThreads);
 
+  // Serve the streaming metrics in the Prometheus format on localhost.
+  uint32 MetricsPort = 0u;
+  if (FParse::Value(FCommandLine::Get(), TEXT("-carla-metrics-port="), MetricsPort))
+  {
+    // A port already in use must not take down the simulator, keep running
+    // without metrics.
+    boost::system::error_code ErrorCode;
+    const uint16_t Port = Pimpl->StreamingServer.ServeMetrics(static_cast<uint16_t>(MetricsPort), ErrorCode);
+    if (ErrorCode)
+    {
+      UE_LOG(LogCarlaServer, Error, TEXT("Cannot serve streaming metrics on port %d: %s"),
+          MetricsPort, *carla::rpc::ToFString(ErrorCode.message()));
+    }
+    else
+    {
+      UE_LOG(LogCarlaServer, Log, TEXT("Serving streaming metrics on port %d"), Port);
+    }
+  }
+
 }
 
 void FCarlaServer::RunSome(uint32 Milliseconds)
@@ -2246,6 +2402,8 @@ void FCarlaServer::Stop()
 {
   check(Pimpl != nullptr);
   Pimpl->Server.Stop();
+  // Write the pending log messages, if the logging was asynchronous.
+  carla::logging::StopAsyncLogging();
 }
 
 FDataStream FCarlaServer::OpenStream() const